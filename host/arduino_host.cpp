@@ -0,0 +1,396 @@
+// ============================================================
+//            ARDUINO / FREERTOS SHIM (host builds)
+// ============================================================
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_timer.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+// ============================================================
+//                    TIME / GPIO / MISC
+// ============================================================
+
+static const std::chrono::steady_clock::time_point _startTime = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _startTime).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+unsigned long micros() {
+    return (unsigned long)esp_timer_get_time();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void digitalWrite(uint8_t pin, uint8_t value) {}
+
+int digitalRead(uint8_t pin) {
+    return HIGH;
+}
+
+uint32_t esp_random() {
+    static std::mutex lock;
+    static std::mt19937 rng(std::random_device{}());
+    std::lock_guard<std::mutex> guard(lock);
+    return rng();
+}
+
+uint32_t getCpuFrequencyMhz() {
+    return 1;
+}
+
+esp_reset_reason_t esp_reset_reason() {
+    return ESP_RST_POWERON;
+}
+
+EspClass ESP;
+
+// ============================================================
+//                    STRING
+// ============================================================
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    _s = buffer;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (_s.size() != other._s.size()) return false;
+    for (size_t i = 0; i < _s.size(); i++) {
+        if (tolower((unsigned char)_s[i]) != tolower((unsigned char)other._s[i])) return false;
+    }
+    return true;
+}
+
+int String::indexOf(char c) const {
+    size_t pos = _s.find(c);
+    return (pos == std::string::npos) ? -1 : (int)pos;
+}
+
+void String::trim() {
+    size_t first = _s.find_first_not_of(" \t\r\n");
+    size_t last = _s.find_last_not_of(" \t\r\n");
+    _s = (first == std::string::npos) ? std::string() : _s.substr(first, last - first + 1);
+}
+
+void String::toUpperCase() {
+    for (char& c : _s) c = (char)toupper((unsigned char)c);
+}
+
+// ============================================================
+//                    PRINT
+// ============================================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::print(long value, int base) {
+    char buffer[24];
+    if (base == HEX) {
+        snprintf(buffer, sizeof(buffer), "%lX", (unsigned long)value);
+    } else {
+        snprintf(buffer, sizeof(buffer), "%ld", value);
+    }
+    return write(buffer);
+}
+
+size_t Print::print(unsigned long value, int base) {
+    char buffer[24];
+    snprintf(buffer, sizeof(buffer), (base == HEX) ? "%lX" : "%lu", value);
+    return write(buffer);
+}
+
+size_t Print::print(double value, int decimals) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, value);
+    return write(buffer);
+}
+
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, len);
+    }
+
+    std::vector<char> heapBuffer(len + 1);
+    va_start(args, format);
+    vsnprintf(heapBuffer.data(), heapBuffer.size(), format, args);
+    va_end(args);
+    return write((const uint8_t*)heapBuffer.data(), len);
+}
+
+// ============================================================
+//                    SERIAL
+// ============================================================
+
+HardwareSerial Serial;
+
+static std::mutex _serialInLock;
+static std::deque<uint8_t> _serialIn;
+static std::mutex _serialOutLock;
+static bool _serialRaw = false;
+
+static void serialReaderThread() {
+    int c;
+    while ((c = fgetc(stdin)) != EOF) {
+        std::lock_guard<std::mutex> guard(_serialInLock);
+        _serialIn.push_back((uint8_t)c);
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud) {
+    static bool started = false;
+    if (started) return;
+    started = true;
+
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    std::thread(serialReaderThread).detach();
+}
+
+void hostSerialSetRaw(bool raw) {
+    _serialRaw = raw;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    // Drop the CR of CRLF line endings so logs diff cleanly on Linux
+    std::lock_guard<std::mutex> guard(_serialOutLock);
+    size_t start = 0;
+    for (size_t i = 0; i < size && !_serialRaw; i++) {
+        if (buffer[i] == '\r') {
+            fwrite(buffer + start, 1, i - start, stdout);
+            start = i + 1;
+        }
+    }
+    fwrite(buffer + start, 1, size - start, stdout);
+    return size;
+}
+
+void HardwareSerial::flush() {
+    std::lock_guard<std::mutex> guard(_serialOutLock);
+    fflush(stdout);
+}
+
+int HardwareSerial::available() {
+    std::lock_guard<std::mutex> guard(_serialInLock);
+    return (int)_serialIn.size();
+}
+
+int HardwareSerial::read() {
+    std::lock_guard<std::mutex> guard(_serialInLock);
+    if (_serialIn.empty()) return -1;
+    uint8_t c = _serialIn.front();
+    _serialIn.pop_front();
+    return c;
+}
+
+int HardwareSerial::peek() {
+    std::lock_guard<std::mutex> guard(_serialInLock);
+    return _serialIn.empty() ? -1 : _serialIn.front();
+}
+
+// ============================================================
+//                    FREERTOS TASKS
+// ============================================================
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifyCount = 0;
+};
+
+static thread_local HostTask* _currentTask = nullptr;
+static thread_local BaseType_t _currentCore = 1;  // Arduino loop runs on Core 1
+
+BaseType_t xPortGetCoreID() {
+    return _currentCore;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name,
+                                   uint32_t stackDepth, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t coreId) {
+    HostTask* task = new HostTask();
+    if (handle != nullptr) *handle = task;
+
+    std::thread([function, param, task, coreId]() {
+        _currentTask = task;
+        _currentCore = (coreId == 0) ? 0 : 1;
+        function(param);
+    }).detach();
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Tasks here only end by returning; nothing to tear down early
+}
+
+void taskYIELD() {
+    std::this_thread::yield();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (_currentTask == nullptr) _currentTask = new HostTask();
+    return _currentTask;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+    return 0;
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifyCount++;
+    }
+    task->wake.notify_one();
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+    xTaskNotifyGive(task);
+    if (higherPriorityTaskWoken != nullptr) *higherPriorityTaskWoken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+    HostTask* task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+
+    if (ticksToWait == portMAX_DELAY) {
+        task->wake.wait(guard, [task] { return task->notifyCount > 0; });
+    } else {
+        task->wake.wait_for(guard, std::chrono::milliseconds(ticksToWait),
+                            [task] { return task->notifyCount > 0; });
+    }
+
+    uint32_t count = task->notifyCount;
+    if (count > 0) {
+        task->notifyCount = clearOnExit ? 0 : count - 1;
+    }
+    return count;
+}
+
+// ============================================================
+//                    PREFERENCES (in-memory NVS)
+// ============================================================
+
+static std::mutex _nvsLock;
+static std::map<std::string, std::vector<uint8_t>> _nvs;  // "namespace/key" -> value
+
+static std::string nvsKey(const std::string& ns, const char* key) {
+    return ns + "/" + key;
+}
+
+bool Preferences::begin(const char* name, bool readOnly) {
+    _namespace = name;
+    _readOnly = readOnly;
+    _open = true;
+    return true;
+}
+
+void Preferences::end() {
+    _open = false;
+}
+
+bool Preferences::clear() {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    std::string prefix = _namespace + "/";
+    for (auto it = _nvs.begin(); it != _nvs.end();) {
+        it = (it->first.compare(0, prefix.size(), prefix) == 0) ? _nvs.erase(it) : std::next(it);
+    }
+    return true;
+}
+
+bool Preferences::remove(const char* key) {
+    if (!_open || _readOnly) return false;
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    return _nvs.erase(nvsKey(_namespace, key)) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    return _open && _nvs.count(nvsKey(_namespace, key)) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+    if (!_open || _readOnly) return 0;
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    const uint8_t* bytes = (const uint8_t*)value;
+    _nvs[nvsKey(_namespace, key)].assign(bytes, bytes + len);
+    return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+    if (!_open) return 0;
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    auto it = _nvs.find(nvsKey(_namespace, key));
+    if (it == _nvs.end() || it->second.size() > maxLen) return 0;
+    memcpy(buffer, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+    if (!_open) return 0;
+    std::lock_guard<std::mutex> guard(_nvsLock);
+    auto it = _nvs.find(nvsKey(_namespace, key));
+    return (it == _nvs.end()) ? 0 : it->second.size();
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    uint32_t value;
+    return (getBytes(key, &value, sizeof(value)) == sizeof(value)) ? value : defaultValue;
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+    return putBytes(key, value, strlen(value) + 1);
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+    size_t len = getBytesLength(key);
+    if (len == 0) return defaultValue;
+    std::vector<char> buffer(len);
+    getBytes(key, buffer.data(), len);
+    return String(buffer.data());
+}
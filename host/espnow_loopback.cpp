@@ -0,0 +1,726 @@
+// ============================================================
+//            ESP-NOW LOOPBACK (host builds)
+// ============================================================
+
+#include "espnow_loopback.h"
+#include "Trace.h"
+#include <esp_timer.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <vector>
+
+// Task configuration - mirrors the device module
+#define ESPNOW_TASK_STACK 4096
+#define ESPNOW_TASK_PRIORITY 5
+#define ESPNOW_MAX_PEERS 20
+
+#define LOOPBACK_UDP_MAGIC "ENLB"
+#define LOOPBACK_UDP_HEADER (4 + 6 + 6)  // magic, source MAC, destination MAC
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// One simulated device: identity, callbacks, peers and receive ring
+struct LoopbackNode {
+    bool used;
+    bool initialized;
+    bool isHost;
+    uint8_t mac[6];
+    uint8_t channel;  // Frames only reach nodes on the sender's channel
+    EspNowReceiveCallback receiveCallback;
+    SubscriberRegistry subscribers;
+    EspNowSendCallback sendCallback;
+    EspNowDropCallback dropCallback;
+    uint8_t peers[ESPNOW_MAX_PEERS][6];
+    int peerCount;
+    TaskHandle_t taskHandle;
+
+    // Ring: router / UDP thread / injectors (producers, serialised by
+    // producerLock) -> node ESP-NOW task (consumer)
+    std::mutex producerLock;
+    EspNowFrame rxRing[ESPNOW_RX_RING_SIZE];
+    uint32_t rxHead;
+    uint32_t rxTail;
+    uint32_t rxReceived;
+    uint32_t rxBadLength;
+    uint32_t rxDropped;
+    uint32_t rxLate;
+    uint32_t rxDelivered;
+    uint32_t rxUnclaimed;
+    uint32_t rxHighWater;
+    uint32_t rxPeakLatencyUs;
+    int8_t deliveryRssi;
+    RateLimiter rateLimiter;  // Routed frames only, under producerLock
+    MacSet allowlist;         // Routed frames only, under producerLock
+    uint32_t rxNotAllowed;
+};
+
+// A frame in flight to one destination, or a pending send report
+struct LoopbackDelivery {
+    int64_t dueUs;
+    uint64_t order;       // FIFO tie-break for equal due times
+    int node;             // Destination node, -1 = report only
+    bool lost;
+    int reportNode;       // Node whose send callback fires, -1 = none
+    bool reportSuccess;
+    uint8_t srcMac[6];
+    uint8_t dstMac[6];
+    std::vector<uint8_t> data;
+};
+
+struct LoopbackDeliveryLater {
+    bool operator()(const LoopbackDelivery& a, const LoopbackDelivery& b) const {
+        if (a.dueUs != b.dueUs) return a.dueUs > b.dueUs;
+        return a.order > b.order;
+    }
+};
+
+static const uint8_t _broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+static std::mutex _nodesLock;
+static LoopbackNode _nodes[LOOPBACK_MAX_NODES];
+static int _nodeCount = 0;
+static thread_local int _boundNode = 0;
+
+// Router ("WiFi task") - link model and delivery queue
+static std::mutex _routerLock;
+static std::condition_variable _routerWake;
+static std::priority_queue<LoopbackDelivery, std::vector<LoopbackDelivery>,
+                           LoopbackDeliveryLater> _pending;
+static uint64_t _pendingOrder = 0;
+static bool _routerStarted = false;
+static std::mt19937 _linkRng(0x5EED);  // Reseeded by loopbackSeedLink()
+static LoopbackLinkProfile _profile = {0, 1000, 1000, 0, 0, -50};
+
+// UDP transport
+static int _udpSocket = -1;
+static uint16_t _udpBasePort = 0;
+static int _udpPortIndex = 0;
+
+static LoopbackStats _stats = {};
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static bool macEqual(const uint8_t* a, const uint8_t* b) {
+    return memcmp(a, b, 6) == 0;
+}
+
+static void formatMac(const uint8_t* mac, char* buffer, size_t bufferSize) {
+    snprintf(buffer, bufferSize, "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+// Node bound to the calling thread (node 0 is created on demand)
+static LoopbackNode* currentNode() {
+    std::lock_guard<std::mutex> guard(_nodesLock);
+    if (_nodeCount == 0) {
+        static const uint8_t defaultMac[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+        _nodes[0].used = true;
+        memcpy(_nodes[0].mac, defaultMac, 6);
+        _nodeCount = 1;
+    }
+    return &_nodes[_boundNode];
+}
+
+static bool hasPeer(const LoopbackNode* node, const uint8_t* mac) {
+    for (int i = 0; i < node->peerCount; i++) {
+        if (macEqual(node->peers[i], mac)) return true;
+    }
+    return false;
+}
+
+// Copy one frame into a node's receive ring and wake its task.
+// Runs on the router or UDP thread, the host stand-in for the WiFi task.
+// Routed frames pass the per-MAC rate limit; injected frames skip it.
+static bool enqueueFrame(LoopbackNode* node, const uint8_t* mac, const uint8_t* data, int len,
+                         bool fromRadio) {
+    TRACE_EVENT(TRACE_RX_CALLBACK_BEGIN, len);
+    std::unique_lock<std::mutex> guard(node->producerLock);
+    node->rxReceived++;
+
+    if (fromRadio && macSetCount(&node->allowlist) > 0 && !macSetContains(&node->allowlist, mac)) {
+        node->rxNotAllowed++;
+        guard.unlock();
+        TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+        return false;
+    }
+
+    if (len <= 0 || len > LOOPBACK_MAX_DATA_LEN) {
+        node->rxBadLength++;
+        guard.unlock();
+        TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+        return false;
+    }
+
+    if (fromRadio && !rateLimiterAllow(&node->rateLimiter, mac, micros())) {
+        if (node->dropCallback != nullptr) {
+            node->dropCallback(mac, data, len);
+        }
+        guard.unlock();
+        TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+        return false;
+    }
+
+    uint32_t head = node->rxHead;
+    uint32_t depth = head - __atomic_load_n(&node->rxTail, __ATOMIC_ACQUIRE);
+    if (depth >= ESPNOW_RX_RING_SIZE) {
+        node->rxDropped++;
+        __atomic_fetch_add(&_stats.ringDrops, 1, __ATOMIC_RELAXED);
+        if (node->dropCallback != nullptr) {
+            node->dropCallback(mac, data, len);
+        }
+        guard.unlock();
+        TRACE_EVENT(TRACE_RX_DROP, depth);
+        TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+        return false;
+    }
+
+    EspNowFrame* slot = &node->rxRing[head % ESPNOW_RX_RING_SIZE];
+    memcpy(slot->mac, mac, 6);
+    memcpy(slot->data, data, len);
+    slot->len = len;
+    slot->rssi = fromRadio ? _profile.rssi : 0;  // Injected: RSSI unknown
+    slot->enqueuedUs = micros();
+
+    __atomic_store_n(&node->rxHead, head + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&_stats.delivered, 1, __ATOMIC_RELAXED);
+
+    if (depth + 1 > node->rxHighWater) {
+        node->rxHighWater = depth + 1;
+    }
+    guard.unlock();
+    TRACE_EVENT(TRACE_RX_ENQUEUE, depth + 1);
+
+    if (node->taskHandle != nullptr) {
+        xTaskNotifyGive(node->taskHandle);
+    }
+    TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+    return true;
+}
+
+static int64_t linkDelayUsLocked() {
+    int64_t delayUs = _profile.latencyMinUs;
+    if (_profile.latencyMaxUs > _profile.latencyMinUs) {
+        delayUs += _linkRng() % (_profile.latencyMaxUs - _profile.latencyMinUs + 1);
+    }
+    return delayUs;
+}
+
+// Apply the link model and queue a delivery to one node.
+// reportNode (or -1) gets a send callback with the link-layer ACK.
+// Caller holds _routerLock.
+static void scheduleLocked(int node, int reportNode, const uint8_t* srcMac, const uint8_t* dstMac,
+                           const uint8_t* data, int len) {
+    LoopbackDelivery d;
+    d.node = node;
+    d.reportNode = reportNode;
+    d.lost = (_linkRng() % 100) < _profile.lossPercent;
+    d.reportSuccess = !d.lost;
+    memcpy(d.srcMac, srcMac, 6);
+    memcpy(d.dstMac, dstMac, 6);
+    d.data.assign(data, data + len);
+
+    int64_t delayUs = linkDelayUsLocked();
+    if (d.lost) {
+        _stats.lost++;
+    } else if ((_linkRng() % 100) < _profile.reorderPercent) {
+        delayUs += _profile.reorderDelayUs;
+    }
+    _stats.scheduled++;
+
+    d.dueUs = esp_timer_get_time() + delayUs;
+    d.order = _pendingOrder++;
+    _pending.push(std::move(d));
+}
+
+// Queue a send callback with no frame attached. Caller holds _routerLock.
+static void scheduleReportLocked(int reportNode, const uint8_t* dstMac, bool success) {
+    LoopbackDelivery d;
+    d.node = -1;
+    d.lost = false;
+    d.reportNode = reportNode;
+    d.reportSuccess = success;
+    memset(d.srcMac, 0, 6);
+    memcpy(d.dstMac, dstMac, 6);
+    d.dueUs = esp_timer_get_time() + linkDelayUsLocked();
+    d.order = _pendingOrder++;
+    _pending.push(std::move(d));
+}
+
+// Router task - releases deliveries when due (Core 0, like the WiFi task)
+static void routerTask(void* param) {
+    while (true) {
+        LoopbackDelivery d;
+        {
+            std::unique_lock<std::mutex> guard(_routerLock);
+            while (true) {
+                if (_pending.empty()) {
+                    _routerWake.wait(guard);
+                    continue;
+                }
+                int64_t waitUs = _pending.top().dueUs - esp_timer_get_time();
+                if (waitUs <= 0) break;
+                _routerWake.wait_for(guard, std::chrono::microseconds(waitUs));
+            }
+            d = _pending.top();
+            _pending.pop();
+        }
+
+        if (d.node >= 0 && !d.lost) {
+            enqueueFrame(&_nodes[d.node], d.srcMac, d.data.data(), (int)d.data.size(), true);
+        }
+        if (d.reportNode >= 0) {
+            EspNowSendCallback callback = _nodes[d.reportNode].sendCallback;
+            if (callback != nullptr) {
+                callback(d.dstMac, d.reportSuccess);
+            }
+        }
+    }
+}
+
+// Offer a frame to every matching local node except the sender
+static void routeToLocalNodes(int srcNode, const uint8_t* srcMac, const uint8_t* dstMac,
+                              const uint8_t* data, int len) {
+    bool broadcast = macEqual(dstMac, _broadcastAddress);
+    bool matched = false;
+
+    std::lock_guard<std::mutex> guard(_routerLock);
+    for (int i = 0; i < _nodeCount; i++) {
+        LoopbackNode* node = &_nodes[i];
+        if (i == srcNode || !node->initialized || macEqual(node->mac, srcMac)) continue;
+        if (!broadcast && !macEqual(node->mac, dstMac)) continue;
+        if (srcNode >= 0 && node->channel != _nodes[srcNode].channel) continue;
+
+        // Unicast reports the link-layer ACK; broadcast always succeeds
+        bool reportAck = !broadcast && srcNode >= 0;
+        scheduleLocked(i, reportAck ? srcNode : -1, srcMac, dstMac, data, len);
+        matched = true;
+    }
+
+    if (srcNode >= 0 && (broadcast || !matched)) {
+        // Broadcast always reports success. Unicast to a node outside
+        // this process can only have been carried (and ACKed) over UDP.
+        scheduleReportLocked(srcNode, dstMac, broadcast || _udpSocket >= 0);
+    }
+    _routerWake.notify_one();
+}
+
+// Send a frame to every other port in the UDP span
+static void udpTransmit(const uint8_t* srcMac, const uint8_t* dstMac, const uint8_t* data, int len) {
+    uint8_t datagram[LOOPBACK_UDP_HEADER + LOOPBACK_MAX_DATA_LEN];
+    memcpy(datagram, LOOPBACK_UDP_MAGIC, 4);
+    memcpy(datagram + 4, srcMac, 6);
+    memcpy(datagram + 10, dstMac, 6);
+    memcpy(datagram + LOOPBACK_UDP_HEADER, data, len);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    for (int i = 0; i < LOOPBACK_UDP_PORTS; i++) {
+        if (i == _udpPortIndex) continue;
+        addr.sin_port = htons(_udpBasePort + i);
+        sendto(_udpSocket, datagram, LOOPBACK_UDP_HEADER + len, 0, (sockaddr*)&addr, sizeof(addr));
+        __atomic_fetch_add(&_stats.udpTx, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// UDP receive task - frames from other processes enter the link model here
+static void udpReceiveTask(void* param) {
+    uint8_t datagram[LOOPBACK_UDP_HEADER + LOOPBACK_MAX_DATA_LEN];
+
+    while (true) {
+        ssize_t n = recv(_udpSocket, datagram, sizeof(datagram), 0);
+        if (n < LOOPBACK_UDP_HEADER || memcmp(datagram, LOOPBACK_UDP_MAGIC, 4) != 0) continue;
+
+        __atomic_fetch_add(&_stats.udpRx, 1, __ATOMIC_RELAXED);
+        routeToLocalNodes(-1, datagram + 4, datagram + 10, datagram + LOOPBACK_UDP_HEADER,
+                          (int)(n - LOOPBACK_UDP_HEADER));
+    }
+}
+
+// Per-node ESP-NOW task - drains the ring into the receive callback
+static void espnowTask(void* param) {
+    int index = (int)(intptr_t)param;
+    loopbackBindThread(index);
+    LoopbackNode* node = &_nodes[index];
+
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+
+        uint32_t tail = node->rxTail;
+        while (tail != __atomic_load_n(&node->rxHead, __ATOMIC_ACQUIRE)) {
+            const EspNowFrame* msg = &node->rxRing[tail % ESPNOW_RX_RING_SIZE];
+            TRACE_EVENT(TRACE_RX_DEQUEUE, node->rxHead - tail);
+
+            if (micros() - msg->enqueuedUs > ESPNOW_RX_LATE_US) {
+                node->rxLate++;
+            }
+
+            TRACE_EVENT(TRACE_RX_DISPATCH_BEGIN, msg->len);
+            node->deliveryRssi = msg->rssi;
+            int matched = subscriberRegistryDispatch(&node->subscribers, msg);
+            if (node->receiveCallback != nullptr) {
+                node->receiveCallback(msg->mac, msg->data, msg->len);
+                matched++;
+            }
+            TRACE_EVENT(TRACE_RX_DISPATCH_END, 0);
+
+            node->rxDelivered++;
+            if (matched == 0) {
+                node->rxUnclaimed++;
+            }
+
+            uint32_t latencyUs = micros() - msg->enqueuedUs;
+            if (latencyUs > node->rxPeakLatencyUs) {
+                node->rxPeakLatencyUs = latencyUs;
+            }
+
+            tail++;
+            __atomic_store_n(&node->rxTail, tail, __ATOMIC_RELEASE);
+        }
+
+        traceSyncTick();
+    }
+}
+
+// ============================================================
+//                    LOOPBACK CONTROL
+// ============================================================
+
+int loopbackAddNode(const uint8_t* mac) {
+    std::lock_guard<std::mutex> guard(_nodesLock);
+    if (_nodeCount >= LOOPBACK_MAX_NODES) return -1;
+
+    LoopbackNode* node = &_nodes[_nodeCount];
+    node->used = true;
+    memcpy(node->mac, mac, 6);
+    return _nodeCount++;
+}
+
+void loopbackBindThread(int node) {
+    _boundNode = node;
+}
+
+void loopbackSetLinkProfile(const LoopbackLinkProfile* profile) {
+    std::lock_guard<std::mutex> guard(_routerLock);
+    _profile = *profile;
+    if (_profile.latencyMaxUs < _profile.latencyMinUs) {
+        _profile.latencyMaxUs = _profile.latencyMinUs;
+    }
+}
+
+void loopbackSeedLink(uint32_t seed) {
+    std::lock_guard<std::mutex> guard(_routerLock);
+    _linkRng.seed(seed);
+}
+
+bool loopbackEnableUdp(uint16_t basePort, int portIndex) {
+    if (portIndex < 0 || portIndex >= LOOPBACK_UDP_PORTS) return false;
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(basePort + portIndex);
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) != 0) {
+        Serial.printf("[Loopback] Cannot bind UDP port %u\n", basePort + portIndex);
+        close(sock);
+        return false;
+    }
+
+    _udpSocket = sock;
+    _udpBasePort = basePort;
+    _udpPortIndex = portIndex;
+    xTaskCreatePinnedToCore(udpReceiveTask, "LoopbackUdp", ESPNOW_TASK_STACK, NULL,
+                            ESPNOW_TASK_PRIORITY, NULL, 0);
+    Serial.printf("[Loopback] UDP on 127.0.0.1:%u (span %u-%u)\n", basePort + portIndex,
+                  basePort, basePort + LOOPBACK_UDP_PORTS - 1);
+    return true;
+}
+
+void loopbackGetStats(LoopbackStats* stats) {
+    std::lock_guard<std::mutex> guard(_routerLock);
+    *stats = _stats;
+}
+
+void loopbackPrintStats() {
+    LoopbackStats stats;
+    loopbackGetStats(&stats);
+
+    Serial.println();
+    Serial.printf("[Loopback] sent=%lu scheduled=%lu lost=%lu delivered=%lu ring_drops=%lu",
+                  (unsigned long)stats.sent, (unsigned long)stats.scheduled,
+                  (unsigned long)stats.lost, (unsigned long)stats.delivered,
+                  (unsigned long)stats.ringDrops);
+    if (_udpSocket >= 0) {
+        Serial.printf(" udp_tx=%lu udp_rx=%lu", (unsigned long)stats.udpTx, (unsigned long)stats.udpRx);
+    }
+    Serial.println();
+
+    for (int i = 0; i < _nodeCount; i++) {
+        const LoopbackNode* node = &_nodes[i];
+        if (!node->initialized) continue;
+        char macStr[ESPNOW_MAC_STR_LEN];
+        formatMac(node->mac, macStr, sizeof(macStr));
+        Serial.printf("[Loopback] node %d %s rx=%lu dropped=%lu high_water=%lu\n",
+                      i, macStr, (unsigned long)node->rxReceived,
+                      (unsigned long)node->rxDropped, (unsigned long)node->rxHighWater);
+    }
+}
+
+// ============================================================
+//                    ESPNOW_MODULE.H API
+// ============================================================
+
+bool espnowInit(bool isHost, const uint8_t* hostMac) {
+    LoopbackNode* node = currentNode();
+    int index = _boundNode;
+    if (node->initialized) return true;
+
+    node->isHost = isHost;
+    node->peerCount = 0;
+    node->channel = LOOPBACK_CHANNEL;
+    rateLimiterInit(&node->rateLimiter, ESPNOW_RATE_LIMIT_PPS, ESPNOW_RATE_LIMIT_BURST);
+    macSetInit(&node->allowlist);
+
+    if (isHost) {
+        memcpy(node->peers[node->peerCount++], _broadcastAddress, 6);
+        Serial.println("[ESP-NOW] Initialized as HOST (broadcast mode, loopback)");
+    } else if (hostMac != nullptr) {
+        memcpy(node->peers[node->peerCount++], hostMac, 6);
+        char hostMacStr[ESPNOW_MAC_STR_LEN];
+        formatMac(hostMac, hostMacStr, sizeof(hostMacStr));
+        Serial.print("[ESP-NOW] Initialized as CLIENT (loopback). Host MAC: ");
+        Serial.println(hostMacStr);
+    } else {
+        Serial.println("[ESP-NOW] Initialized as CLIENT (loopback, no host MAC set)");
+    }
+
+    char macStr[ESPNOW_MAC_STR_LEN];
+    formatMac(node->mac, macStr, sizeof(macStr));
+    Serial.print("[ESP-NOW] This device MAC: ");
+    Serial.println(macStr);
+
+    {
+        std::lock_guard<std::mutex> guard(_routerLock);
+        if (!_routerStarted) {
+            xTaskCreatePinnedToCore(routerTask, "LoopbackRouter", ESPNOW_TASK_STACK, NULL,
+                                    ESPNOW_TASK_PRIORITY, NULL, 0);
+            _routerStarted = true;
+        }
+    }
+
+    xTaskCreatePinnedToCore(espnowTask, "ESPNowTask", ESPNOW_TASK_STACK, (void*)(intptr_t)index,
+                            ESPNOW_TASK_PRIORITY, &node->taskHandle, 0);
+    Serial.println("[ESP-NOW] Task started on Core 0");
+
+    node->initialized = true;
+    return true;
+}
+
+void espnowSetReceiveCallback(EspNowReceiveCallback callback) {
+    currentNode()->receiveCallback = callback;
+}
+
+int espnowSubscribe(const EspNowFilter* filter, EspNowFrameHandler handler, void* context) {
+    return subscriberRegistryAdd(&currentNode()->subscribers, filter, handler, context);
+}
+
+void espnowUnsubscribe(int id) {
+    subscriberRegistryRemove(&currentNode()->subscribers, id);
+}
+
+void espnowSetDropCallback(EspNowDropCallback callback) {
+    currentNode()->dropCallback = callback;
+}
+
+void espnowSetSendCallback(EspNowSendCallback callback) {
+    currentNode()->sendCallback = callback;
+}
+
+bool espnowSend(const uint8_t* mac, const uint8_t* data, size_t len) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized || len > LOOPBACK_MAX_DATA_LEN) return false;
+
+    // ESP-NOW only sends to registered peers
+    const uint8_t* targetMac = (mac != nullptr) ? mac : _broadcastAddress;
+    if (!hasPeer(node, targetMac)) return false;
+
+    __atomic_fetch_add(&_stats.sent, 1, __ATOMIC_RELAXED);
+    routeToLocalNodes(_boundNode, node->mac, targetMac, data, (int)len);
+    if (_udpSocket >= 0) {
+        udpTransmit(node->mac, targetMac, data, (int)len);
+    }
+    return true;
+}
+
+bool espnowSendString(const uint8_t* mac, const char* message) {
+    return espnowSend(mac, (const uint8_t*)message, strlen(message));
+}
+
+bool espnowSendString(const uint8_t* mac, const String& message) {
+    return espnowSendString(mac, message.c_str());
+}
+
+bool espnowBroadcast(const uint8_t* data, size_t len) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized || !node->isHost) return false;
+    return espnowSend(_broadcastAddress, data, len);
+}
+
+bool espnowAddPeer(const uint8_t* mac) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized) return false;
+    if (hasPeer(node, mac)) return true;
+    if (node->peerCount >= ESPNOW_MAX_PEERS) return false;
+
+    memcpy(node->peers[node->peerCount++], mac, 6);
+    return true;
+}
+
+bool espnowRemovePeer(const uint8_t* mac) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized) return false;
+
+    for (int i = 0; i < node->peerCount; i++) {
+        if (macEqual(node->peers[i], mac)) {
+            memmove(node->peers[i], node->peers[i + 1], (node->peerCount - i - 1) * 6);
+            node->peerCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void espnowGetMACString(char* buffer, size_t bufferSize) {
+    formatMac(currentNode()->mac, buffer, bufferSize);
+}
+
+String espnowGetMAC() {
+    char buffer[ESPNOW_MAC_STR_LEN];
+    espnowGetMACString(buffer, sizeof(buffer));
+    return String(buffer);
+}
+
+bool espnowIsInitialized() {
+    return currentNode()->initialized;
+}
+
+bool espnowIsHost() {
+    return currentNode()->isHost;
+}
+
+bool espnowEnableRssiTracking() {
+    if (!currentNode()->initialized) return false;
+    Serial.println("[ESP-NOW] RSSI tracking enabled (loopback link profile)");
+    return true;
+}
+
+int8_t espnowGetLastRssi() {
+    return currentNode()->deliveryRssi;
+}
+
+bool espnowAllowlistAdd(const uint8_t* mac) {
+    LoopbackNode* node = currentNode();
+    std::lock_guard<std::mutex> guard(node->producerLock);
+    return macSetAdd(&node->allowlist, mac);
+}
+
+bool espnowAllowlistRemove(const uint8_t* mac) {
+    LoopbackNode* node = currentNode();
+    std::lock_guard<std::mutex> guard(node->producerLock);
+    return macSetRemove(&node->allowlist, mac);
+}
+
+void espnowAllowlistClear() {
+    LoopbackNode* node = currentNode();
+    std::lock_guard<std::mutex> guard(node->producerLock);
+    macSetInit(&node->allowlist);
+}
+
+int espnowAllowlistCount() {
+    return macSetCount(&currentNode()->allowlist);
+}
+
+bool espnowInjectFrame(const uint8_t* mac, const uint8_t* data, int len) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized) return false;
+    return enqueueFrame(node, mac, data, len, false);
+}
+
+void espnowGetRxStats(EspNowRxStats* stats) {
+    LoopbackNode* node = currentNode();
+    stats->received = node->rxReceived;
+    stats->notAllowed = node->rxNotAllowed;
+    stats->badLength = node->rxBadLength;
+    stats->rateLimited = node->rateLimiter.throttled;
+    stats->rateEvictions = node->rateLimiter.evictions;
+    stats->dropped = node->rxDropped;
+    stats->late = node->rxLate;
+    stats->delivered = node->rxDelivered;
+    stats->unclaimed = node->rxUnclaimed;
+    stats->highWater = node->rxHighWater;
+    stats->depth = node->rxHead - node->rxTail;
+}
+
+int espnowGetRateLimitSources(RateLimitEntry* out, int maxEntries) {
+    LoopbackNode* node = currentNode();
+    RateLimiter snapshot;
+    {
+        std::lock_guard<std::mutex> guard(node->producerLock);
+        snapshot = node->rateLimiter;
+    }
+    return rateLimiterGetSources(&snapshot, out, maxEntries);
+}
+
+uint32_t espnowTakeRxPeakLatency() {
+    return __atomic_exchange_n(&currentNode()->rxPeakLatencyUs, 0, __ATOMIC_RELAXED);
+}
+
+void espnowResetRxStats() {
+    LoopbackNode* node = currentNode();
+    node->rxReceived = 0;
+    node->rxNotAllowed = 0;
+    node->rxBadLength = 0;
+    {
+        std::lock_guard<std::mutex> guard(node->producerLock);
+        rateLimiterResetCounters(&node->rateLimiter);
+    }
+    node->rxDropped = 0;
+    node->rxLate = 0;
+    node->rxDelivered = 0;
+    node->rxUnclaimed = 0;
+    node->rxHighWater = 0;
+}
+
+void espnowSyncChannel() {
+    // No WiFi on the host - nothing to follow
+}
+
+bool espnowSetChannel(uint8_t channel) {
+    LoopbackNode* node = currentNode();
+    if (!node->initialized || channel < 1 || channel > 13) return false;
+
+    std::lock_guard<std::mutex> guard(_routerLock);
+    node->channel = channel;
+    return true;
+}
+
+uint8_t espnowGetChannel() {
+    LoopbackNode* node = currentNode();
+    return node->initialized ? node->channel : 0;
+}
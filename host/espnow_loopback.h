@@ -0,0 +1,92 @@
+// ============================================================
+//            ESP-NOW LOOPBACK (host builds)
+// ============================================================
+//
+// Host implementation of the espnow_module.h API. Frames are
+// routed between simulated nodes instead of a radio:
+// - In-process: several nodes share one router thread
+// - Localhost UDP: one or more nodes per process, every frame is
+//   sent to each port in [basePort, basePort + LOOPBACK_UDP_PORTS)
+//   and filtered by destination MAC on arrival, like the air
+//
+// Each (frame, destination) pair passes through a link model with
+// iid loss, uniform latency jitter and explicit reordering. Over
+// UDP the model is applied by the receiving process. The
+// receive side keeps the firmware's structure: the router plays
+// the WiFi task and fills a per-node ESPNOW_RX_RING_SIZE ring, and
+// a per-node ESPNowTask drains it into the receive callback, so
+// ring drops and high-water marks behave as on the device.
+//
+// espnow_module.h calls act on the node bound to the calling
+// thread. The main thread is bound to node 0; ESP-NOW tasks are
+// bound to their own node.
+//
+// ============================================================
+
+#ifndef ESPNOW_LOOPBACK_H
+#define ESPNOW_LOOPBACK_H
+
+#include <Arduino.h>
+#include "modules/espnow_module.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define LOOPBACK_MAX_NODES    8    // Simulated nodes per process
+#define LOOPBACK_MAX_DATA_LEN ESPNOW_FRAME_MAX_LEN
+#define LOOPBACK_UDP_PORTS    8    // Port span scanned in UDP mode
+#define LOOPBACK_CHANNEL      1    // Radio channel nodes start on
+
+// ============================================================
+//                    LINK MODEL
+// ============================================================
+
+struct LoopbackLinkProfile {
+    uint8_t lossPercent;      // iid loss per frame and destination (0-100)
+    uint32_t latencyMinUs;    // Delivery delay, uniform in [min, max]
+    uint32_t latencyMaxUs;    // Jitter wider than the send interval reorders naturally
+    uint8_t reorderPercent;   // Frames additionally held back by reorderDelayUs
+    uint32_t reorderDelayUs;
+    int8_t rssi;              // Reported by espnowGetLastRssi() (dBm)
+};
+
+// Loopback counters (whole process)
+struct LoopbackStats {
+    uint32_t sent;       // espnowSend() calls accepted
+    uint32_t scheduled;  // (frame, destination) pairs offered to the link model
+    uint32_t lost;       // Dropped by the link model
+    uint32_t delivered;  // Handed to a node's receive ring
+    uint32_t ringDrops;  // Dropped because a node's ring was full
+    uint32_t udpTx;      // Datagrams written (UDP mode)
+    uint32_t udpRx;      // Datagrams accepted (UDP mode)
+};
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Create a node with the given MAC. Returns its index, or -1.
+// Call before the node's espnowInit().
+int loopbackAddNode(const uint8_t* mac);
+
+// Bind the calling thread to a node (espnow_module.h calls act on it)
+void loopbackBindThread(int node);
+
+// Set the link model applied to every delivery
+void loopbackSetLinkProfile(const LoopbackLinkProfile* profile);
+
+// Seed the link model's random loss, latency and reordering. Same
+// seed and traffic -> same losses; receivers in separate processes
+// need different seeds to see independent links.
+void loopbackSeedLink(uint32_t seed);
+
+// Route frames over localhost UDP. This process listens on
+// basePort + portIndex; call before any espnowInit().
+bool loopbackEnableUdp(uint16_t basePort, int portIndex);
+
+// Get / print counters
+void loopbackGetStats(LoopbackStats* stats);
+void loopbackPrintStats();
+
+#endif
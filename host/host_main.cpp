@@ -0,0 +1,291 @@
+// ============================================================
+//            HOST ENTRY POINT (loopback simulation)
+// ============================================================
+//
+// Runs the receiver firmware (setup()/loop() from src/) on Linux
+// against the ESP-NOW loopback, together with simulated
+// transmitters that send PingMessage frames like
+// OER.Diagnostic.ESPNowTransmitter.
+//
+// Build:  pio run -e native        (binary: .pio/build/native/program)
+//
+// Options:
+//   --role both|rx|tx     Firmware and transmitters in one process (default),
+//                         receiver firmware only, or transmitters only
+//   --tx N                Simulated transmitters (default 1)
+//   --interval-us US      Ping interval per transmitter (default 100000)
+//   --count N             Pings per transmitter, 0 = endless (default 10000)
+//   --flood-hz HZ         Add a neighbour broadcasting pings at HZ (rate limit test)
+//   --loss PCT            iid frame loss (default 0)
+//   --latency-us MIN[:MAX]  Delivery delay / jitter (default 1000)
+//   --reorder PCT[:US]    Hold back PCT% of frames by US (default 0:5000)
+//   --rssi DBM            Reported RSSI (default -50)
+//   --seed N              Link model seed (default 0x5EED); the UDP index
+//                         is mixed in, so separate receivers lose
+//                         different frames
+//   --fec K:M             Send M parity frames after every K pings
+//                         (FEC_PARITY_MAGIC, see src/FecDecoder.h)
+//   --udp PORT:INDEX      Route over localhost UDP, listening on PORT+INDEX
+//   --duration S          Print stats and exit after S seconds
+//   --serial-raw 1        Keep Serial output byte-exact (binary ping log
+//                         capture: program ... --serial-raw 1 > run.bin)
+//   --quantile-bench N    Check P² quantiles against exact ones with N
+//                         pings per transmitter, then exit (no firmware)
+//
+// Example - receiver and transmitter as separate processes
+// (the link model is applied by the receiving process):
+//   program --role rx --udp 47000:0 --loss 1
+//   program --role tx --udp 47000:1 --interval-us 2000
+// More receivers take further indexes (47000:2, ...) and see
+// independent losses, e.g. for tools/diversity.cpp.
+//
+// Serial commands (S, R, T, ...) are read from stdin.
+//
+// ============================================================
+
+#include <Arduino.h>
+#include "espnow_loopback.h"
+#include "DiagnosticReceiver.h"
+#include "MessageTypes.h"
+#include "quantile_bench.h"
+#include "modules/fec_codec.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Arduino sketch entry points (src/main.cpp)
+void setup();
+void loop();
+
+// First transmitter uses the host MAC the receiver is configured for
+static const uint8_t TX_MAC_BASE[] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF};
+static const uint8_t RX_MAC[] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+static const uint8_t FLOOD_MAC[] = {0x02, 0x46, 0x4C, 0x00, 0x00, 0x01};
+
+struct HostOptions {
+    bool runReceiver = true;
+    int transmitters = 1;
+    uint32_t intervalUs = 100000;
+    uint32_t count = TEST_PACKET_COUNT;
+    uint32_t floodHz = 0;
+    LoopbackLinkProfile link = {0, 1000, 1000, 0, 5000, -50};
+    uint32_t seed = 0x5EED;
+    uint32_t fecK = 0;  // 0 = no parity frames
+    uint32_t fecM = 1;
+    int udpPort = 0;
+    int udpIndex = 0;
+    uint32_t durationS = 0;
+    bool serialRaw = false;
+    uint32_t quantileBench = 0;
+};
+
+static std::atomic<uint32_t> _txSent(0);
+
+static void usage(const char* name) {
+    fprintf(stderr, "usage: %s [--role both|rx|tx] [--tx N] [--interval-us US] [--count N]\n"
+                    "          [--flood-hz HZ] [--loss PCT] [--latency-us MIN[:MAX]] [--reorder PCT[:US]]\n"
+                    "          [--rssi DBM] [--seed N] [--fec K:M] [--udp PORT:INDEX] [--duration S]\n"
+                    "          [--serial-raw 1] [--quantile-bench N]\n", name);
+    exit(2);
+}
+
+// Parse "A" or "A:B" into two unsigned values (b keeps its value if absent)
+static void parsePair(const char* text, uint32_t* a, uint32_t* b) {
+    char* end;
+    *a = strtoul(text, &end, 10);
+    if (*end == ':') *b = strtoul(end + 1, nullptr, 10);
+}
+
+static HostOptions parseOptions(int argc, char** argv) {
+    HostOptions opt;
+    bool transmittersOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (i + 1 >= argc) usage(argv[0]);
+        const char* value = argv[++i];
+
+        if (strcmp(arg, "--role") == 0) {
+            opt.runReceiver = (strcmp(value, "tx") != 0);
+            transmittersOnly = (strcmp(value, "tx") == 0);
+            if (strcmp(value, "rx") == 0) opt.transmitters = 0;
+        } else if (strcmp(arg, "--tx") == 0) {
+            opt.transmitters = atoi(value);
+        } else if (strcmp(arg, "--interval-us") == 0) {
+            opt.intervalUs = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--count") == 0) {
+            opt.count = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--flood-hz") == 0) {
+            opt.floodHz = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--loss") == 0) {
+            opt.link.lossPercent = (uint8_t)atoi(value);
+        } else if (strcmp(arg, "--latency-us") == 0) {
+            uint32_t maxUs = 0;
+            parsePair(value, &opt.link.latencyMinUs, &maxUs);
+            opt.link.latencyMaxUs = (maxUs > 0) ? maxUs : opt.link.latencyMinUs;
+        } else if (strcmp(arg, "--reorder") == 0) {
+            uint32_t percent;
+            parsePair(value, &percent, &opt.link.reorderDelayUs);
+            opt.link.reorderPercent = (uint8_t)percent;
+        } else if (strcmp(arg, "--rssi") == 0) {
+            opt.link.rssi = (int8_t)atoi(value);
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt.seed = strtoul(value, nullptr, 0);
+        } else if (strcmp(arg, "--fec") == 0) {
+            parsePair(value, &opt.fecK, &opt.fecM);
+            if (opt.fecK > FEC_MAX_DATA || opt.fecM < 1 || opt.fecM > FEC_MAX_PARITY) usage(argv[0]);
+        } else if (strcmp(arg, "--udp") == 0) {
+            uint32_t port, index = 0;
+            parsePair(value, &port, &index);
+            opt.udpPort = (int)port;
+            opt.udpIndex = (int)index;
+        } else if (strcmp(arg, "--duration") == 0) {
+            opt.durationS = strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--serial-raw") == 0) {
+            opt.serialRaw = atoi(value) != 0;
+        } else if (strcmp(arg, "--quantile-bench") == 0) {
+            opt.quantileBench = strtoul(value, nullptr, 10);
+        } else {
+            usage(argv[0]);
+        }
+    }
+
+    if (transmittersOnly && opt.transmitters < 1) opt.transmitters = 1;
+    int nodes = opt.transmitters + (opt.floodHz > 0 ? 1 : 0);
+    if (opt.transmitters < 0 || nodes >= LOOPBACK_MAX_NODES) usage(argv[0]);
+    return opt;
+}
+
+// Simulated transmitter - one thread per node, broadcasting pings
+// on absolute deadlines so the rate does not drift. Announces itself
+// first and reports its counters every TX_STATS_EVERY pings. With
+// fecK > 0, fecM parity frames follow every fecK-th ping.
+#define TX_STATS_EVERY 100
+
+static void sendParity(const PingMessage* group, uint32_t firstSequence, uint32_t k, uint32_t m) {
+    const uint8_t* frames[FEC_MAX_DATA];
+    for (uint32_t i = 0; i < k; i++) frames[i] = (const uint8_t*)&group[i];
+
+    FecParityMessage parity = {};
+    parity.magic = FEC_PARITY_MAGIC;
+    parity.firstSequence = firstSequence;
+    parity.k = (uint8_t)k;
+    parity.m = (uint8_t)m;
+    for (uint32_t row = 0; row < m; row++) {
+        parity.row = (uint8_t)row;
+        fecEncode(frames, (int)k, (int)row, sizeof(parity.parity), parity.parity);
+        espnowBroadcast((const uint8_t*)&parity, sizeof(parity));
+    }
+}
+
+static void transmitterThread(int node, uint32_t intervalUs, uint32_t count, uint32_t startDelayMs,
+                              uint32_t fecK, uint32_t fecM) {
+    loopbackBindThread(node);
+    espnowInit(true, nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(startDelayMs));
+
+    AnnounceMessage announce = {};
+    announce.magic = ANNOUNCE_MAGIC;
+    announce.version = 1;
+    announce.intervalMs = (uint16_t)(intervalUs / 1000);
+    snprintf(announce.name, sizeof(announce.name), "host-tx-%d", node);
+    espnowBroadcast((const uint8_t*)&announce, sizeof(announce));
+
+    PingMessage ping;
+    ping.magic = PING_MAGIC;
+    ping.sequenceNumber = 0;
+
+    StatsMessage stats = {};
+    stats.magic = STATS_MAGIC;
+
+    PingMessage group[FEC_MAX_DATA];
+
+    auto next = std::chrono::steady_clock::now();
+    while (count == 0 || ping.sequenceNumber < count) {
+        ping.uptimeMs = millis();
+        if (espnowBroadcast((const uint8_t*)&ping, sizeof(ping))) {
+            _txSent++;
+            stats.sent++;
+        } else {
+            stats.sendFailures++;
+        }
+        if (fecK > 0) {
+            group[ping.sequenceNumber % fecK] = ping;
+            if (ping.sequenceNumber % fecK == fecK - 1) {
+                sendParity(group, ping.sequenceNumber + 1 - fecK, fecK, fecM);
+            }
+        }
+        ping.sequenceNumber++;
+
+        if (ping.sequenceNumber % TX_STATS_EVERY == 0) {
+            stats.uptimeMs = millis();
+            espnowBroadcast((const uint8_t*)&stats, sizeof(stats));
+        }
+
+        next += std::chrono::microseconds(intervalUs);
+        std::this_thread::sleep_until(next);
+    }
+}
+
+int main(int argc, char** argv) {
+    HostOptions opt = parseOptions(argc, argv);
+    if (opt.quantileBench > 0) {
+        return quantileBenchRun(opt.quantileBench);
+    }
+
+    Serial.begin(115200);
+    hostSerialSetRaw(opt.serialRaw);
+    loopbackSetLinkProfile(&opt.link);
+    loopbackSeedLink(opt.seed + (uint32_t)opt.udpIndex * 0x9E3779B9u);
+
+    // Node 0 is the receiver firmware (bound to the main thread)
+    loopbackAddNode(RX_MAC);
+    if (opt.udpPort > 0 && !loopbackEnableUdp((uint16_t)opt.udpPort, opt.udpIndex)) {
+        return 1;
+    }
+
+    if (opt.runReceiver) {
+        setup();
+    }
+
+    std::vector<std::thread> transmitters;
+    for (int i = 0; i < opt.transmitters; i++) {
+        uint8_t mac[6];
+        memcpy(mac, TX_MAC_BASE, 6);
+        mac[5] = (uint8_t)(TX_MAC_BASE[5] - i);
+        int node = loopbackAddNode(mac);
+        transmitters.emplace_back(transmitterThread, node, opt.intervalUs, opt.count, 0, opt.fecK, opt.fecM);
+    }
+    if (opt.floodHz > 0) {
+        // Starts late so the receiver locks onto the monitored transmitter
+        int node = loopbackAddNode(FLOOD_MAC);
+        transmitters.emplace_back(transmitterThread, node, 1000000 / opt.floodHz, 0, 1000, 0, 1);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(opt.durationS);
+
+    while (opt.durationS == 0 || std::chrono::steady_clock::now() < deadline) {
+        if (opt.runReceiver) {
+            loop();
+        }
+        // The device loop spins freely; on a shared host keep it cheap
+        std::this_thread::sleep_for(std::chrono::microseconds(opt.runReceiver ? 200 : 100000));
+    }
+
+    double elapsedS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (opt.runReceiver) {
+        diagnosticReceiverPrintStats();
+    }
+    loopbackPrintStats();
+    Serial.printf("[Loopback] %lu pings sent in %.1f s (%.0f/s)\n",
+                  (unsigned long)_txSent.load(), elapsedS, _txSent.load() / elapsedS);
+    Serial.flush();
+
+    // Firmware tasks never return - leave without joining them
+    _exit(0);
+}
@@ -0,0 +1,23 @@
+#ifndef HOST_ADAFRUIT_NEOPIXEL_H
+#define HOST_ADAFRUIT_NEOPIXEL_H
+
+#include <stdint.h>
+
+#define NEO_GRB    0x52
+#define NEO_KHZ800 0x0000
+
+// No LED on the host - colour changes are discarded
+class Adafruit_NeoPixel {
+public:
+    Adafruit_NeoPixel(uint16_t count, int16_t pin, uint16_t type) {}
+    void begin() {}
+    void show() {}
+    void clear() {}
+    void setBrightness(uint8_t brightness) {}
+    void setPixelColor(uint16_t index, uint32_t color) {}
+    static uint32_t Color(uint8_t r, uint8_t g, uint8_t b) {
+        return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b;
+    }
+};
+
+#endif
@@ -0,0 +1,194 @@
+// ============================================================
+//            ARDUINO CORE SHIM (host builds)
+// ============================================================
+//
+// Just enough of the Arduino-ESP32 core for the firmware sources
+// to build and run on Linux: String, Print/Serial (stdin/stdout),
+// millis()/micros(), GPIO no-ops, and the FreeRTOS subset below.
+//
+// ============================================================
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// IRAM code gets a section of its own on the host too, so
+// `size -A program | grep iram` shows what the receive path would put
+// in IRAM (x86-64 code - a proxy for the Xtensa size). DRAM placement
+// is meaningless here.
+#define IRAM_ATTR __attribute__((section(".iram1")))
+#define DRAM_ATTR
+
+#define LOW          0
+#define HIGH         1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+
+typedef bool boolean;
+
+// ============================================================
+//                    TIME / GPIO / MISC
+// ============================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);  // Always HIGH (inputs idle pulled up)
+
+uint32_t esp_random();
+uint32_t getCpuFrequencyMhz();  // 1 - host cycle counter is micros()
+
+static inline void* ps_malloc(size_t size) { return malloc(size); }
+
+enum esp_reset_reason_t {
+    ESP_RST_UNKNOWN,
+    ESP_RST_POWERON,
+    ESP_RST_EXT,
+    ESP_RST_SW,
+    ESP_RST_PANIC,
+    ESP_RST_INT_WDT,
+    ESP_RST_TASK_WDT,
+    ESP_RST_WDT,
+    ESP_RST_DEEPSLEEP,
+    ESP_RST_BROWNOUT,
+    ESP_RST_SDIO
+};
+
+esp_reset_reason_t esp_reset_reason();
+
+class EspClass {
+public:
+    uint32_t getFreeHeap() { return 256 * 1024; }
+    uint32_t getFreePsram() { return 2 * 1024 * 1024; }
+    uint32_t getCycleCount() { return (uint32_t)micros(); }
+    void restart() { exit(0); }
+};
+
+extern EspClass ESP;
+
+// ============================================================
+//                    STRING
+// ============================================================
+
+class String {
+public:
+    String() {}
+    String(const char* s) : _s(s ? s : "") {}
+    String(const std::string& s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int value) : _s(std::to_string(value)) {}
+    String(unsigned int value) : _s(std::to_string(value)) {}
+    String(long value) : _s(std::to_string(value)) {}
+    String(unsigned long value) : _s(std::to_string(value)) {}
+    String(float value, unsigned int decimals = 2);
+    String(double value, unsigned int decimals = 2);
+
+    const char* c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.length(); }
+    bool isEmpty() const { return _s.empty(); }
+
+    bool equals(const String& other) const { return _s == other._s; }
+    bool equalsIgnoreCase(const String& other) const;
+    bool startsWith(const String& prefix) const { return _s.compare(0, prefix._s.size(), prefix._s) == 0; }
+    int indexOf(char c) const;
+    String substring(unsigned int from) const { return String(_s.substr(from)); }
+    String substring(unsigned int from, unsigned int to) const { return String(_s.substr(from, to - from)); }
+    void trim();
+    void toUpperCase();
+    long toInt() const { return atol(_s.c_str()); }
+    char charAt(unsigned int index) const { return index < _s.size() ? _s[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String& operator+=(const String& other) { _s += other._s; return *this; }
+    String& operator+=(const char* other) { _s += other; return *this; }
+    String& operator+=(char c) { _s += c; return *this; }
+
+    bool operator==(const String& other) const { return _s == other._s; }
+    bool operator==(const char* other) const { return _s == other; }
+    bool operator!=(const String& other) const { return _s != other._s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._s + b._s); }
+    friend String operator+(const String& a, const char* b) { return String(a._s + b); }
+    friend String operator+(const char* a, const String& b) { return String(a + b._s); }
+
+private:
+    std::string _s;
+};
+
+// ============================================================
+//                    PRINT / STREAM / SERIAL
+// ============================================================
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    virtual void flush() {}
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write(s.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int decimals = 2);
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+// Serial on stdout, input read from stdin by a background thread
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud);
+    void end() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// Host only: pass Serial output through unchanged (CRs kept), for
+// capturing binary output such as the B command's ping log
+void hostSerialSetRaw(bool raw);
+
+#endif
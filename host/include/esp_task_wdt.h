@@ -0,0 +1,13 @@
+#ifndef HOST_ESP_TASK_WDT_H
+#define HOST_ESP_TASK_WDT_H
+
+#include <stdint.h>
+
+// Watchdog is not emulated on the host
+typedef int esp_err_t;
+
+static inline esp_err_t esp_task_wdt_init(uint32_t timeoutSeconds, bool panic) { return 0; }
+static inline esp_err_t esp_task_wdt_add(void* task) { return 0; }
+static inline esp_err_t esp_task_wdt_reset() { return 0; }
+
+#endif
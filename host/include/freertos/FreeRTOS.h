@@ -0,0 +1,43 @@
+// ============================================================
+//            FREERTOS SHIM (host builds)
+// ============================================================
+//
+// Tasks are std::threads, critical sections are recursive
+// mutexes, and one tick is one millisecond. "Core" is a
+// per-thread tag: tasks get the core they were pinned to, every
+// other thread (including the Arduino loop) reports core 1.
+//
+// ============================================================
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <mutex>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE  1
+#define pdFALSE 0
+#define pdPASS  pdTRUE
+
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY      0xFFFFFFFFu
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+
+struct portMUX_TYPE {
+    std::recursive_mutex lock;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {}
+
+#define portENTER_CRITICAL(mux)     (mux)->lock.lock()
+#define portEXIT_CRITICAL(mux)      (mux)->lock.unlock()
+#define portENTER_CRITICAL_ISR(mux) (mux)->lock.lock()
+#define portEXIT_CRITICAL_ISR(mux)  (mux)->lock.unlock()
+
+BaseType_t xPortGetCoreID();
+
+#endif
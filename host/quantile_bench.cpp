@@ -0,0 +1,174 @@
+// ============================================================
+//            QUANTILE ACCURACY BENCHMARK (host builds)
+// ============================================================
+
+#include "quantile_bench.h"
+#include "TrafficGenerator.h"
+#include "modules/transmitter_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#define BENCH_GENERATORS (TRANSMITTER_TABLE_SIZE / TRAFFIC_MAX_MACS)
+#define BENCH_INTERVAL_MS 100
+
+// Exact samples per transmitter, derived exactly as the table does
+struct ExactSamples {
+    std::vector<int> interArrival;
+    std::vector<int> pdv;
+    std::vector<int> rssi;
+    uint32_t lastArrivalMs = 0;
+    int32_t lastTransitMs = 0;
+    bool timed = false;
+};
+
+struct QuantileError {
+    double valueSum = 0;
+    double valueMax = 0;
+    double rankSum = 0;
+    double rankMax = 0;
+    int streams = 0;
+};
+
+static uint32_t _rng = 0x9E3779B9;
+
+static uint32_t benchRandom() {
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _rng;
+}
+
+// One-way delay in ms: mostly small, with a queueing tail that grows
+// with the transmitter's index so the streams differ
+static uint32_t benchDelayMs(int transmitter) {
+    uint32_t scale = 1 + transmitter % 4;
+    uint32_t roll = benchRandom() % 1000;
+    if (roll < 900) return 2 + benchRandom() % (3 * scale);
+    if (roll < 990) return 5 + benchRandom() % (15 * scale);
+    return 20 + benchRandom() % (60 * scale);
+}
+
+// RSSI in dBm: per-transmitter level, triangular noise, 2% deep fades
+static int8_t benchRssi(int transmitter) {
+    int level = -40 - transmitter % 32;
+    int noise = (int)(benchRandom() % 7) + (int)(benchRandom() % 7) + (int)(benchRandom() % 7) - 9;
+    int fade = (benchRandom() % 100 < 2) ? -15 : 0;
+    return (int8_t)(level + noise + fade);
+}
+
+static const double QUANTILE_FRACTION[3] = {0.50, 0.95, 0.99};
+static const char* QUANTILE_NAME[3] = {"p50", "p95", "p99"};
+
+static void accumulate(std::vector<int>& samples, const P2Quantiles* est, QuantileError* errors) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    double n = (double)samples.size();
+
+    for (int q = 0; q < 3; q++) {
+        double p = QUANTILE_FRACTION[q];
+        size_t rank = (size_t)ceil(p * n);
+        int exact = samples[(rank > 0) ? rank - 1 : 0];
+        int estimate = p2Get(est, (P2Quantile)q);
+
+        double below = std::lower_bound(samples.begin(), samples.end(), estimate) - samples.begin();
+        double atOrBelow = std::upper_bound(samples.begin(), samples.end(), estimate) - samples.begin();
+        double rankError = 0;
+        if (p < below / n) rankError = below / n - p;
+        if (p > atOrBelow / n) rankError = p - atOrBelow / n;
+
+        double valueError = fabs((double)estimate - exact);
+        QuantileError* e = &errors[q];
+        e->valueSum += valueError;
+        e->valueMax = std::max(e->valueMax, valueError);
+        e->rankSum += rankError;
+        e->rankMax = std::max(e->rankMax, rankError);
+        e->streams++;
+    }
+}
+
+static void printErrors(const char* metric, const char* unit, const QuantileError* errors) {
+    for (int q = 0; q < 3; q++) {
+        const QuantileError* e = &errors[q];
+        if (e->streams == 0) continue;
+        printf("  %-13s %s   %6.2f %-3s %6.0f %-3s   %6.3f%%  %6.3f%%\n", metric, QUANTILE_NAME[q],
+               e->valueSum / e->streams, unit, e->valueMax, unit,
+               100.0 * e->rankSum / e->streams, 100.0 * e->rankMax);
+    }
+}
+
+int quantileBenchRun(uint32_t packetsPerMac) {
+    static TransmitterTable table;
+    const LinkAlarmConfig alarm = {LINK_ALARM_LOSS_PPM, LINK_CLEAR_LOSS_PPM, LINK_ALARM_MIN_SLOTS};
+    transmitterTableInit(&table, &alarm);
+    std::vector<ExactSamples> exact(TRANSMITTER_TABLE_SIZE);
+
+    TrafficGenerator generators[BENCH_GENERATORS];
+    uint32_t lastArrivalMs[TRANSMITTER_TABLE_SIZE] = {0};
+    for (int g = 0; g < BENCH_GENERATORS; g++) {
+        TrafficConfig config;
+        trafficGeneratorDefaultConfig(&config);
+        config.macCount = TRAFFIC_MAX_MACS;
+        config.packetsPerMac = packetsPerMac;
+        config.intervalMs = BENCH_INTERVAL_MS;
+        config.seed = g + 1;
+        trafficGeneratorInit(&generators[g], &config);
+    }
+
+    // Round-robin over the generators until all streams are finished
+    uint32_t frames = 0;
+    bool active = true;
+    while (active) {
+        active = false;
+        for (int g = 0; g < BENCH_GENERATORS; g++) {
+            TrafficFrame frame;
+            if (!trafficGeneratorNext(&generators[g], &frame)) continue;
+            active = true;
+
+            int transmitter = g * TRAFFIC_MAX_MACS + (frame.mac[5] - 1);
+            frame.mac[4] = (uint8_t)g;
+
+            // Receiver clock: sender uptime plus delay, never going back
+            uint32_t arrivalMs = frame.ping.uptimeMs + benchDelayMs(transmitter);
+            if ((int32_t)(arrivalMs - lastArrivalMs[transmitter]) < 0) arrivalMs = lastArrivalMs[transmitter];
+            lastArrivalMs[transmitter] = arrivalMs;
+            int8_t rssi = benchRssi(transmitter);
+
+            transmitterTableRecord(&table, frame.mac, frame.ping.sequenceNumber, arrivalMs, frame.ping.uptimeMs, rssi);
+            frames++;
+
+            ExactSamples* samples = &exact[transmitter];
+            int32_t transitMs = (int32_t)(arrivalMs - frame.ping.uptimeMs);
+            if (samples->timed) {
+                samples->interArrival.push_back((int)(arrivalMs - samples->lastArrivalMs));
+                int32_t ipdv = abs(transitMs - samples->lastTransitMs);
+                if (ipdv <= TRANSMITTER_PDV_MAX_MS) samples->pdv.push_back(ipdv);
+            }
+            samples->timed = true;
+            samples->lastArrivalMs = arrivalMs;
+            samples->lastTransitMs = transitMs;
+            samples->rssi.push_back(rssi);
+        }
+    }
+
+    QuantileError interArrival[3], pdv[3], rssi[3];
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        const TransmitterEntry* entry = &table.entries[i];
+        if (!entry->used) continue;
+        int transmitter = entry->mac[4] * TRAFFIC_MAX_MACS + (entry->mac[5] - 1);
+        accumulate(exact[transmitter].interArrival, &entry->interArrival, interArrival);
+        accumulate(exact[transmitter].pdv, &entry->pdv, pdv);
+        accumulate(exact[transmitter].rssi, &entry->rssi, rssi);
+    }
+
+    printf("P2 quantile benchmark: %d transmitters, %lu frames, %lu evicted\n",
+           transmitterTableCount(&table), (unsigned long)frames, (unsigned long)table.evictions);
+    printf("Table: %u bytes (%u per transmitter)\n",
+           (unsigned)sizeof(TransmitterTable), (unsigned)sizeof(TransmitterEntry));
+    printf("  Metric        Q     mean err   max err    mean rank  max rank\n");
+    printErrors("Inter-arrival", "ms", interArrival);
+    printErrors("PDV", "ms", pdv);
+    printErrors("RSSI", "dB", rssi);
+    return 0;
+}
@@ -0,0 +1,26 @@
+// ============================================================
+//            QUANTILE ACCURACY BENCHMARK (host builds)
+// ============================================================
+//
+// Feeds TRANSMITTER_TABLE_SIZE synthetic transmitters through the
+// firmware's TransmitterTable and compares its P² p50/p95/p99 with
+// exact quantiles of the same samples. Streams come from the
+// traffic generator (loss, bursts, duplicates, reordering) with
+// modelled delay jitter and RSSI fades added on top.
+//
+// Errors are reported per metric and quantile, in sample units and
+// in rank: how far the requested fraction lies outside the exact
+// rank range of the estimated value (0 = the estimate is a correct
+// quantile of the data).
+//
+// ============================================================
+
+#ifndef QUANTILE_BENCH_H
+#define QUANTILE_BENCH_H
+
+#include <Arduino.h>
+
+// Run with packetsPerMac pings per transmitter; returns 0
+int quantileBenchRun(uint32_t packetsPerMac);
+
+#endif
@@ -0,0 +1,206 @@
+// ============================================================
+//            BINARY PING LOG
+// ============================================================
+
+#include "BinaryLog.h"
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// One block as it is filled. The MAC table is sized for the worst
+// case; the records are moved down behind the used entries when the
+// block is written, so the output is contiguous.
+#pragma pack(push, 1)
+struct BinlogBuffer {
+    BinlogHeader header;
+    BinlogMacEntry macs[BINLOG_BLOCK_MACS];
+    BinlogRecord records[BINLOG_BLOCK_RECORDS];
+};
+#pragma pack(pop)
+
+static DRAM_ATTR BinlogBuffer _buffers[2];
+static volatile bool _sealed[2] = {false, false};  // Owned by the loop until written
+static uint8_t _active = 0;                         // Buffer the receive path fills
+static portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+static volatile bool _running = false;
+static uint32_t _nextBlockIndex = 0;
+static bool _dropping = false;       // Inside a run of dropped records
+
+// Counters since binaryLogStart()
+static uint32_t _blocksWritten = 0;
+static uint32_t _recordsWritten = 0;
+static uint32_t _recordsDropped = 0;
+static uint64_t _bytesWritten = 0;
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+// Hand the active buffer to the loop and switch to the other one.
+// Caller holds _mux.
+static void IRAM_ATTR sealActive() {
+    _sealed[_active] = true;
+    _active ^= 1;
+}
+
+// MAC table slot for mac whose sequence fits this block, or -1
+static int IRAM_ATTR findSlot(BinlogBuffer* buf, const uint8_t* mac, uint32_t sequence) {
+    for (int i = 0; i < buf->header.macCount; i++) {
+        BinlogMacEntry* entry = &buf->macs[i];
+        if (memcmp(entry->mac, mac, 6) != 0) continue;
+        return (sequence - entry->baseSequence <= 0xFFFF) ? i : -1;
+    }
+    if (buf->header.macCount >= BINLOG_BLOCK_MACS) return -1;
+
+    BinlogMacEntry* entry = &buf->macs[buf->header.macCount];
+    memcpy(entry->mac, mac, 6);
+    entry->baseSequence = (sequence > BINLOG_LATE_SLACK) ? sequence - BINLOG_LATE_SLACK : 0;
+    return buf->header.macCount++;
+}
+
+// Append to the active buffer, starting a block if it is empty.
+// Returns false if the record does not fit this block. Caller holds _mux.
+static bool IRAM_ATTR append(const uint8_t* mac, uint32_t sequence, uint32_t arrivalMs, int8_t rssi) {
+    BinlogBuffer* buf = &_buffers[_active];
+    if (buf->header.records == 0) {
+        buf->header.magic = BINLOG_MAGIC;
+        buf->header.version = BINLOG_VERSION;
+        buf->header.macCount = 0;
+        buf->header.blockIndex = _nextBlockIndex++;
+        buf->header.baseMs = arrivalMs;
+        _dropping = false;
+    }
+
+    if (arrivalMs - buf->header.baseMs > 0xFFFF) return false;
+    int slot = findSlot(buf, mac, sequence);
+    if (slot < 0) return false;
+
+    BinlogRecord* record = &buf->records[buf->header.records++];
+    record->macIndex = (uint8_t)slot;
+    record->rssi = rssi;
+    record->offsetMs = (uint16_t)(arrivalMs - buf->header.baseMs);
+    record->sequenceOffset = (uint16_t)(sequence - buf->macs[slot].baseSequence);
+
+    if (buf->header.records >= BINLOG_BLOCK_RECORDS) sealActive();
+    return true;
+}
+
+// Checksum and write one sealed block, then hand it back
+static void writeBlock(int index) {
+    BinlogBuffer* buf = &_buffers[index];
+    uint8_t* body = (uint8_t*)buf->macs;
+    size_t macBytes = (size_t)buf->header.macCount * sizeof(BinlogMacEntry);
+    size_t recordBytes = (size_t)buf->header.records * sizeof(BinlogRecord);
+    if (buf->header.macCount < BINLOG_BLOCK_MACS) {
+        memmove(body + macBytes, buf->records, recordBytes);
+    }
+
+    buf->header.crc = binlogCrc32(0, body, macBytes + recordBytes);
+    size_t total = sizeof(BinlogHeader) + macBytes + recordBytes;
+    Serial.write((const uint8_t*)&buf->header, total);
+
+    _blocksWritten++;
+    _recordsWritten += buf->header.records;
+    _bytesWritten += total;
+
+    portENTER_CRITICAL(&_mux);
+    buf->header.records = 0;
+    _sealed[index] = false;
+    portEXIT_CRITICAL(&_mux);
+}
+
+// Write sealed blocks, oldest first
+static void writeSealed() {
+    for (int pass = 0; pass < 2; pass++) {
+        int index = -1;
+        for (int i = 0; i < 2; i++) {
+            if (!_sealed[i]) continue;
+            if (index < 0 || (int32_t)(_buffers[i].header.blockIndex - _buffers[index].header.blockIndex) < 0) {
+                index = i;
+            }
+        }
+        if (index < 0) return;
+        writeBlock(index);
+    }
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void binaryLogStart() {
+    if (_running) return;
+
+    portENTER_CRITICAL(&_mux);
+    _buffers[0].header.records = 0;
+    _buffers[1].header.records = 0;
+    _sealed[0] = false;
+    _sealed[1] = false;
+    _active = 0;
+    _dropping = false;
+    portEXIT_CRITICAL(&_mux);
+
+    _blocksWritten = 0;
+    _recordsWritten = 0;
+    _recordsDropped = 0;
+    _bytesWritten = 0;
+
+    Serial.printf("[BINLOG] Streaming %d-ping blocks - capture raw bytes, B stops\n", BINLOG_BLOCK_RECORDS);
+    _running = true;
+}
+
+void binaryLogStop() {
+    if (!_running) return;
+    _running = false;
+
+    portENTER_CRITICAL(&_mux);
+    if (_buffers[_active].header.records > 0 && !_sealed[_active]) sealActive();
+    portEXIT_CRITICAL(&_mux);
+    writeSealed();
+
+    Serial.println();
+    Serial.printf("[BINLOG] Stopped: %lu blocks, %lu pings, %lu dropped, %lu KB\n",
+                  (unsigned long)_blocksWritten, (unsigned long)_recordsWritten,
+                  (unsigned long)_recordsDropped, (unsigned long)(_bytesWritten / 1024));
+}
+
+bool binaryLogIsRunning() {
+    return _running;
+}
+
+void IRAM_ATTR binaryLogRecord(const uint8_t* mac, uint32_t sequence, uint32_t arrivalMs, int8_t rssi) {
+    if (!_running) return;
+
+    portENTER_CRITICAL(&_mux);
+    bool stored = false;
+    if (!_sealed[_active]) {
+        stored = append(mac, sequence, arrivalMs, rssi);
+        if (!stored) {
+            // Does not fit this block: close it and start the next
+            sealActive();
+            stored = !_sealed[_active] && append(mac, sequence, arrivalMs, rssi);
+        }
+    }
+    if (!stored) {
+        _recordsDropped++;
+        if (!_dropping) {
+            _dropping = true;
+            _nextBlockIndex++;  // The block these records would have filled
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+void binaryLogUpdate() {
+    if (_running) {
+        portENTER_CRITICAL(&_mux);
+        BinlogBuffer* buf = &_buffers[_active];
+        if (!_sealed[_active] && buf->header.records > 0 && millis() - buf->header.baseMs >= BINLOG_FLUSH_MS) {
+            sealActive();
+        }
+        portEXIT_CRITICAL(&_mux);
+    }
+    writeSealed();
+}
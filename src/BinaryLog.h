@@ -0,0 +1,66 @@
+// ============================================================
+//            BINARY PING LOG
+// ============================================================
+//
+// Streams every received ping (all transmitters, before the
+// transmitter lock) to Serial as compact binary blocks - 6 bytes
+// per ping instead of a ~60 byte text line - for long captures
+// that are analysed on the host:
+//
+//   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > run1.bin
+//   (press B on the receiver to start, B again to stop)
+//   binlog_analyse run1.bin run2.bin ...
+//
+// Logs captured at the same time by receivers in different spots
+// can be merged with tools/diversity.cpp to see what a second
+// receiver would recover, and replayed through candidate FEC
+// schemes with tools/fec_whatif.cpp.
+//
+// Block layout is in BinaryLogFormat.h. Text output keeps flowing
+// between blocks; the analyser finds blocks by their keyframe
+// header and CRC and skips everything else.
+//
+// The receive path appends records to one of two block buffers;
+// the loop seals, checksums and writes full (or BINLOG_FLUSH_MS
+// old) blocks from the other. If the loop falls a whole block
+// behind, records are dropped and the block index skips, so the
+// analyser can tell lost log blocks from lost pings.
+//
+// ============================================================
+
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <Arduino.h>
+#include "BinaryLogFormat.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define BINLOG_BLOCK_RECORDS 256   // Pings per block (6 bytes each)
+#define BINLOG_BLOCK_MACS    16    // Transmitters per block (10 bytes each)
+#define BINLOG_FLUSH_MS      1000  // A partial block is written once this old
+#define BINLOG_LATE_SLACK    256   // Sequences a late ping may lag the first one
+                                   // of its block without starting a new block
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Start streaming blocks (B command)
+void binaryLogStart();
+
+// Write the partial block and stop; prints block/record counts
+void binaryLogStop();
+
+// True while streaming
+bool binaryLogIsRunning();
+
+// Append one ping. IRAM-resident, callable from the receive path.
+void binaryLogRecord(const uint8_t* mac, uint32_t sequence, uint32_t arrivalMs, int8_t rssi);
+
+// Call from loop - writes sealed blocks to Serial
+void binaryLogUpdate();
+
+#endif
@@ -0,0 +1,85 @@
+// ============================================================
+//            BINARY PING LOG - BLOCK FORMAT
+// ============================================================
+//
+// Shared by the firmware (BinaryLog.cpp, writer) and the host
+// analyser (tools/binlog_analyse.cpp, reader). Plain C++ with no
+// Arduino dependency so both sides compile the same definitions.
+//
+// A log is a sequence of self-contained blocks. Each block starts
+// with a keyframe header carrying a magic word and a CRC, so a
+// reader can start at any byte offset, scan forward to the next
+// valid keyframe and decode from there. That is what lets the
+// analyser split one file across threads, and skip the text lines
+// a serial capture interleaves between blocks.
+//
+//   BinlogHeader                        20 bytes
+//   BinlogMacEntry  x header.macCount   10 bytes each
+//   BinlogRecord    x header.records     6 bytes each
+//
+// Records only refer to their own block's MAC table and base
+// time, so every block decodes on its own. All fields are little
+// endian (ESP32 and x86/ARM hosts alike).
+//
+// ============================================================
+
+#ifndef BINARYLOGFORMAT_H
+#define BINARYLOGFORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BINLOG_MAGIC   0x4C52454FUL  // "OERL" in file byte order
+#define BINLOG_VERSION 1
+
+#pragma pack(push, 1)
+struct BinlogHeader {
+    uint32_t magic;        // BINLOG_MAGIC
+    uint8_t version;       // BINLOG_VERSION
+    uint8_t macCount;      // MAC table entries after the header
+    uint16_t records;      // Records after the MAC table
+    uint32_t blockIndex;   // Counts up from 0 per boot; a jump means lost blocks
+    uint32_t baseMs;       // Receiver millis() that record offsets count from
+    uint32_t crc;          // binlogCrc32() of everything after the header
+};
+
+struct BinlogMacEntry {
+    uint8_t mac[6];
+    uint32_t baseSequence; // Record sequence = baseSequence + sequenceOffset
+};
+
+struct BinlogRecord {
+    uint8_t macIndex;        // Into this block's MAC table
+    int8_t rssi;             // dBm, 0 = unknown
+    uint16_t offsetMs;       // Arrival = header.baseMs + offsetMs
+    uint16_t sequenceOffset; // Sequence = macs[macIndex].baseSequence + sequenceOffset
+};
+#pragma pack(pop)
+
+static_assert(sizeof(BinlogHeader) == 20, "BinlogHeader layout");
+static_assert(sizeof(BinlogMacEntry) == 10, "BinlogMacEntry layout");
+static_assert(sizeof(BinlogRecord) == 6, "BinlogRecord layout");
+
+// Bytes after the header of a block with the given table and record counts
+static inline size_t binlogBodySize(uint8_t macCount, uint16_t records) {
+    return (size_t)macCount * sizeof(BinlogMacEntry) + (size_t)records * sizeof(BinlogRecord);
+}
+
+// CRC-32 (IEEE 802.3, reflected), nibble table: small enough for the
+// device, fast enough for the host. Start with crc = 0.
+static inline uint32_t binlogCrc32(uint32_t crc, const void* data, size_t len) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* bytes = (const uint8_t*)data;
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+        crc = (crc >> 4) ^ table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+#endif
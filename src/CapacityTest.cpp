@@ -0,0 +1,231 @@
+// ============================================================
+//            RECEIVER CAPACITY TEST
+// ============================================================
+
+#include "CapacityTest.h"
+#include "DiagnosticReceiver.h"
+#include "TrafficGenerator.h"
+#include "config.h"
+
+#if USE_ESPNOW
+  #include "modules/espnow_module.h"
+#endif
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+enum CapacityPhase {
+    CAPACITY_IDLE,
+    CAPACITY_INJECT,   // Offering pings at the stage rate
+    CAPACITY_SETTLE    // Letting the ring drain before judging
+};
+
+enum CapacityLimit {
+    LIMIT_NONE,
+    LIMIT_RING,        // Receive ring overflowed
+    LIMIT_DEADLINE,    // A ping waited longer than CAPACITY_DEADLINE_US
+    LIMIT_INJECTOR,    // Could not offer the stage rate
+    LIMIT_MAX_RATE     // Reached CAPACITY_MAX_PPS without failing
+};
+
+static CapacityPhase _phase = CAPACITY_IDLE;
+static uint32_t _stage = 0;
+static uint32_t _ratePps = 0;
+static uint32_t _kneePps = 0;
+static bool _soakWasOn = false;
+
+// Current stage
+static unsigned long _stageStartUs = 0;
+static unsigned long _stageStartMs = 0;
+static unsigned long _settleStartMs = 0;
+static uint32_t _stageTarget = 0;     // Pings to offer this stage
+static uint32_t _injected = 0;        // Pings offered so far this stage
+static uint32_t _droppedBefore = 0;
+static uint32_t _deliveredBefore = 0;
+
+static_assert(CAPACITY_MACS >= 1 && CAPACITY_MACS <= 254, "MACs are numbered in one byte");
+
+static uint32_t _pingIndex = 0;  // Pings injected since the start; picks MAC and sequence
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static void printBoxLine(const char* text) {
+    Serial.printf("║  %-54s║\n", text);
+}
+
+static const char* limitName(CapacityLimit limit) {
+    switch (limit) {
+        case LIMIT_RING:     return "receive ring overflow";
+        case LIMIT_DEADLINE: return "per-ping deadline";
+        case LIMIT_INJECTOR: return "injector (knee is a lower bound)";
+        case LIMIT_MAX_RATE: return "CAPACITY_MAX_PPS reached";
+        default:             return "none";
+    }
+}
+
+#if USE_ESPNOW
+static void beginStage() {
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    _droppedBefore = rx.dropped;
+    _deliveredBefore = rx.delivered;
+    espnowTakeRxPeakLatency();
+
+    _stage++;
+    _stageTarget = (uint32_t)(((uint64_t)_ratePps * CAPACITY_STAGE_MS) / 1000);
+    _injected = 0;
+    _stageStartUs = micros();
+    _stageStartMs = millis();
+    _phase = CAPACITY_INJECT;
+}
+
+static void finish(CapacityLimit limit) {
+    char line[64];
+    _phase = CAPACITY_IDLE;
+
+    // Hand the receiver back waiting for a real transmitter
+    diagnosticReceiverRestartTest();
+    diagnosticReceiverSetSoakMode(_soakWasOn);
+
+    Serial.println();
+    Serial.println("╔════════════════════════════════════════════════════════╗");
+    Serial.println("║              RECEIVER CAPACITY                         ║");
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    if (_kneePps > 0) {
+        snprintf(line, sizeof(line), "Max sustainable:    %lu pings/s", (unsigned long)_kneePps);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "Equivalent:         ~%lu transmitters at %d Hz",
+                 (unsigned long)(_kneePps / CAPACITY_TX_RATE_HZ), CAPACITY_TX_RATE_HZ);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "Measured with:      %d sender MACs", CAPACITY_MACS);
+        printBoxLine(line);
+    } else {
+        printBoxLine("Max sustainable:    below the first stage");
+    }
+    snprintf(line, sizeof(line), "Limited by:         %s", limitName(limit));
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Ring / deadline:    %d slots / %d us",
+             ESPNOW_RX_RING_SIZE, CAPACITY_DEADLINE_US);
+    printBoxLine(line);
+    Serial.println("╚════════════════════════════════════════════════════════╝");
+    Serial.println();
+}
+
+// Judge the stage that just drained; start the next one or finish
+static void judgeStage() {
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    uint32_t drops = rx.dropped - _droppedBefore;
+    uint32_t processed = rx.delivered - _deliveredBefore;  // All MACs, not just the locked one
+    uint32_t peakUs = espnowTakeRxPeakLatency();
+    uint32_t offeredPps = (uint32_t)(((uint64_t)_injected * 1000) / CAPACITY_STAGE_MS);
+
+    CapacityLimit limit = LIMIT_NONE;
+    if (drops > 0) {
+        limit = LIMIT_RING;
+    } else if (peakUs > CAPACITY_DEADLINE_US) {
+        limit = LIMIT_DEADLINE;
+    } else if (_injected < _stageTarget - _stageTarget / 20) {
+        limit = LIMIT_INJECTOR;
+    }
+
+    Serial.printf("[CAPACITY] stage=%lu target_pps=%lu offered_pps=%lu processed=%lu "
+                  "drops=%lu peak_latency_us=%lu high_water=%lu %s\n",
+                  (unsigned long)_stage, (unsigned long)_ratePps, (unsigned long)offeredPps,
+                  (unsigned long)processed, (unsigned long)drops, (unsigned long)peakUs,
+                  (unsigned long)rx.highWater, (limit == LIMIT_NONE) ? "PASS" : "FAIL");
+
+    if (limit != LIMIT_NONE) {
+        finish(limit);
+        return;
+    }
+
+    _kneePps = _ratePps;
+    if (_ratePps >= CAPACITY_MAX_PPS) {
+        finish(LIMIT_MAX_RATE);
+        return;
+    }
+
+    _ratePps += _ratePps * CAPACITY_STEP_PERCENT / 100;
+    if (_ratePps > CAPACITY_MAX_PPS) _ratePps = CAPACITY_MAX_PPS;
+    beginStage();
+}
+#endif
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void capacityTestStart() {
+#if USE_ESPNOW
+    if (_phase != CAPACITY_IDLE) return;
+
+    // Soak mode keeps the receiver processing past TEST_PACKET_COUNT
+    _soakWasOn = diagnosticReceiverIsSoakMode();
+    diagnosticReceiverRestartTest();
+    diagnosticReceiverSetSoakMode(true);
+
+    _pingIndex = 0;
+
+    _stage = 0;
+    _kneePps = 0;
+    _ratePps = CAPACITY_START_PPS;
+
+    Serial.printf("[CAPACITY] Ramping from %d pings/s, +%d%% per %d ms stage "
+                  "(ring %d, deadline %d us, %d MACs)\n",
+                  CAPACITY_START_PPS, CAPACITY_STEP_PERCENT, CAPACITY_STAGE_MS,
+                  ESPNOW_RX_RING_SIZE, CAPACITY_DEADLINE_US, CAPACITY_MACS);
+    beginStage();
+#else
+    Serial.println("[CAPACITY] ESP-NOW disabled");
+#endif
+}
+
+void capacityTestStop() {
+#if USE_ESPNOW
+    if (_phase == CAPACITY_IDLE) return;
+    _phase = CAPACITY_IDLE;
+    diagnosticReceiverRestartTest();
+    diagnosticReceiverSetSoakMode(_soakWasOn);
+    Serial.println("[CAPACITY] Aborted");
+#endif
+}
+
+bool capacityTestIsRunning() {
+    return _phase != CAPACITY_IDLE;
+}
+
+void capacityTestUpdate() {
+#if USE_ESPNOW
+    if (_phase == CAPACITY_INJECT) {
+        // Pings due so far at the stage rate (no drift from rounding)
+        uint64_t elapsedUs = micros() - _stageStartUs;
+        uint64_t due = (elapsedUs * _ratePps) / 1000000;
+        if (due > _stageTarget) due = _stageTarget;
+
+        for (int i = 0; i < CAPACITY_BURST_MAX && _injected < due; i++) {
+            uint8_t mac[6];
+            trafficGeneratorGetMac((uint8_t)(_pingIndex % CAPACITY_MACS), mac);
+            PingMessage ping;
+            ping.magic = PING_MAGIC;
+            ping.sequenceNumber = _pingIndex / CAPACITY_MACS + 1;
+            ping.uptimeMs = millis();
+            espnowInjectFrame(mac, (const uint8_t*)&ping, sizeof(ping));
+            _pingIndex++;
+            _injected++;
+        }
+
+        if (millis() - _stageStartMs >= CAPACITY_STAGE_MS) {
+            _phase = CAPACITY_SETTLE;
+            _settleStartMs = millis();
+        }
+    } else if (_phase == CAPACITY_SETTLE) {
+        if (millis() - _settleStartMs >= CAPACITY_SETTLE_MS) {
+            judgeStage();
+        }
+    }
+#endif
+}
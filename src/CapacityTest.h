@@ -0,0 +1,63 @@
+// ============================================================
+//            RECEIVER CAPACITY TEST
+// ============================================================
+//
+// Finds the highest ping rate the receive pipeline sustains.
+// Synthetic pings are injected into the receive ring (bypassing
+// the radio) at a rate that steps up each stage. A stage fails if
+// - the receive ring drops a frame, or
+// - a ping waits longer than CAPACITY_DEADLINE_US from entering
+//   the ring to its receive callback returning, or
+// - the injector cannot offer the requested rate (reported
+//   separately: the knee is then a lower bound)
+//
+// The knee is the last passing rate, also expressed as a number
+// of transmitters at CAPACITY_TX_RATE_HZ. Pings are spread round-
+// robin over CAPACITY_MACS sender MACs, each with its own sequence,
+// so per-transmitter lookups miss their last-hit cache as they
+// would with that many real transmitters. The receiver runs in
+// soak mode for the test so every analysis feature stays in the
+// measured path; re-run after adding one to see what it costs.
+//
+// Started with the X serial command; stepped from the loop.
+//
+// ============================================================
+
+#ifndef CAPACITYTEST_H
+#define CAPACITYTEST_H
+
+#include <Arduino.h>
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define CAPACITY_START_PPS    250     // First stage rate (pings/s)
+#define CAPACITY_STEP_PERCENT 50      // Rate increase per stage
+#define CAPACITY_MAX_PPS      200000  // Stop ramping here
+#define CAPACITY_STAGE_MS     1000    // Injection time per stage
+#define CAPACITY_SETTLE_MS    100     // Drain time before a stage is judged
+#define CAPACITY_DEADLINE_US  10000   // Max ring-to-callback-return time per ping
+#define CAPACITY_BURST_MAX    8       // Max frames injected per loop pass (keeps a
+                                      // loop stall from dumping a ring's worth at once)
+#define CAPACITY_TX_RATE_HZ   10      // Transmitter ping rate used to express the knee
+#define CAPACITY_MACS         64      // Sender MACs the pings rotate over (1..254; the
+                                      // transmitter table holds 64 without evicting)
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Start the ramp (switches the receiver to soak mode until done)
+void capacityTestStart();
+
+// Abort a running test
+void capacityTestStop();
+
+// True while stages are running
+bool capacityTestIsRunning();
+
+// Call from loop - injects due pings and judges finished stages
+void capacityTestUpdate();
+
+#endif
@@ -3,30 +3,166 @@
 // ============================================================
 
 #include "DiagnosticReceiver.h"
+#include "MessageTypes.h"
+#include "SequenceTracker.h"
+#include "SoakMonitor.h"
+#include "EventCapture.h"
+#include "PacketReservoir.h"
+#include "TrafficGenerator.h"
+#include "CapacityTest.h"
+#include "TestPlan.h"
+#include "Trace.h"
+#include "BinaryLog.h"
+#include "FecDecoder.h"
+#include "ReportWriter.h"
 #include "config.h"
+#include "setup.h"
+#include "modules/alloc_counter.h"
+#include "modules/fixed_stats.h"
+#include "modules/transmitter_table.h"
+#include "esp_task_wdt.h"
+#include <Preferences.h>
+
+#if USE_ESPNOW
+  #include "modules/espnow_module.h"
+#endif
 
 // ============================================================
 //                    STATE
 // ============================================================
 
-static uint32_t _totalReceived = 0;
-static uint32_t _totalMissed = 0;
 static uint32_t _signalLossEvents = 0;
 
-static uint32_t _lastSequenceNumber = 0;
-static unsigned long _lastPingTime = 0;
+// Running link statistics, updated per ping (integer math - identical
+// on device and host). Read by the loop under the lock.
+static WelfordStats _interArrival;  // ms between accepted pings
+static WelfordStats _rssiStats;     // dBm, pings with a known RSSI only
+static EwmaRate _lossRate;          // Recent RF loss, per ping slot
+static TransmitterTable _transmitters;  // Quantiles and loss for every transmitter heard, locked or not
+static portMUX_TYPE _linkStatsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const LinkAlarmConfig LINK_ALARM = {LINK_ALARM_LOSS_PPM, LINK_CLEAR_LOSS_PPM, LINK_ALARM_MIN_SLOTS};
+
+// Loss alarm transitions, queued by the receive path under
+// _linkStatsMux and printed by the loop
+struct LinkEvent {
+    uint8_t mac[6];
+    bool degraded;
+    uint32_t timeMs;
+    LossWindowCounts packets;
+    LossWindowCounts seconds;
+};
+static LinkEvent _linkEvents[LINK_EVENT_QUEUE_SIZE];
+static uint8_t _linkEventHead = 0;
+static uint8_t _linkEventCount = 0;
+static uint32_t _linkEventsDropped = 0;
+static uint32_t _linkDegradedEvents = 0;
+
+// Ping records for event capture and the reservoir. Both buffers may
+// be in PSRAM, which IRAM code must not touch (it is behind the same
+// cache as flash): the receive path queues records here in DRAM and
+// the loop writes them out.
+struct QueuedRecord {
+    PacketRecord record;
+    uint32_t missed;
+};
+static DRAM_ATTR QueuedRecord _records[RECORD_QUEUE_SIZE];
+static uint16_t _recordHead = 0;
+static uint16_t _recordCount = 0;
+static uint32_t _recordsDropped = 0;  // Queue full - missing from capture and reservoir
+static portMUX_TYPE _recordMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t takeInternalDrops(uint32_t last, uint32_t current, uint32_t gap, uint64_t* mask);
+
+struct PingTraits {
+    typedef PingMessage Message;
+    typedef uint32_t Sequence;
+    static TRACKER_INLINE Sequence sequence(const PingMessage* ping) { return ping->sequenceNumber; }
+    static TRACKER_INLINE uint32_t timestampMs(const PingMessage* ping) { return ping->uptimeMs; }
+    static TRACKER_INLINE bool intact(const PingMessage* ping) { return true; }  // Pings carry no checksum
+};
+
+// Gap pings found in the drop log are internal, not over-the-air loss
+struct LoggedDrops {
+    static TRACKER_INLINE uint32_t take(uint32_t last, uint32_t current, uint32_t gap, uint64_t* mask) {
+        return takeInternalDrops(last, current, gap, mask);
+    }
+};
+
+// Received, missed (RF) and internal counts, last sequence and arrival
+typedef SequenceTracker<PingTraits, MillisClock, LoggedDrops> PingTracker;
+static PingTracker _pings;
+
+// Receive pipeline stages after the ring (see diagnosticReceiverPrintStats).
+// Unknown types and bad sizes are counted by the message table.
+static uint32_t _rejectedMac = 0;       // Not the locked transmitter
+static uint32_t _ignoredComplete = 0;   // Arrived after the test ended
+
+// Runs of our transmitter's sequence numbers that the receive path
+// dropped (ring full or rate limited). Filled by the producer, consumed
+// when the gap they leave is seen. When the log is full the last run is
+// widened instead, so under sustained overflow drops err towards
+// internal, never towards RF loss.
+struct DropRun {
+    uint32_t first;
+    uint32_t last;
+};
+static DropRun _dropLog[DROP_LOG_SIZE];
+static uint32_t _dropLogCount = 0;
+static portMUX_TYPE _dropLogMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Non-ping messages - stored by the receive path, acted on by the loop.
+// An announce or echo arriving while the previous one is still pending
+// is dropped (announce) or counted as busy (echo).
+static AnnounceMessage _announce;
+static uint8_t _announceMac[6];
+static volatile bool _announcePending = false;
+
+static EchoMessage _echoRequest;
+static uint8_t _echoMac[6];
+static volatile bool _echoPending = false;
+static uint32_t _echoReplies = 0;
+static uint32_t _echoBusy = 0;
+
+static StatsMessage _txStats;          // Latest report from the locked transmitter
+static bool _txStatsKnown = false;
+static portMUX_TYPE _txStatsMux = portMUX_INITIALIZER_UNLOCKED;
+
 static unsigned long _lastHeartbeatTime = 0;
 static unsigned long _testStartTime = 0;
 
 static bool _signalLost = false;
-static bool _firstPingReceived = false;
 static bool _testComplete = false;
 static bool _summaryPrinted = false;
+static bool _soakMode = SOAK_MODE_DEFAULT;
 
 // Store transmitter MAC for display
 static uint8_t _transmitterMac[6] = {0};
 static bool _transmitterKnown = false;
 
+// Receive-path notices printed later by the loop, so the IRAM hot
+// path never calls into Serial or snprintf (both live in flash)
+static volatile bool _firstPingPending = false;
+static volatile bool _restorePending = false;
+static unsigned long _restoreTime = 0;
+static unsigned long _restoreSilenceMs = 0;
+static uint32_t _restoreMissed = 0;
+
+// Allocation check (M command)
+static bool _allocChecking = false;
+static uint32_t _allocCheckStart = 0;
+static uint32_t _allocCheckPings = 0;
+static unsigned long _allocCheckStartMs = 0;
+static unsigned long _allocCheckLogMs = 0;
+
+// Injection self-test (G command) - generator paced from the loop
+static TrafficGenerator _injectGen;
+static bool _injecting = false;
+static bool _injectReportPending = false;
+static unsigned long _injectNextUs = 0;
+static unsigned long _injectDoneTime = 0;
+static uint32_t _injectDroppedBefore = 0;
+
 // ============================================================
 //                    HELPER FUNCTIONS
 // ============================================================
@@ -51,21 +187,464 @@ static void printHelp() {
     Serial.println("╠════════════════════════════════════════════════════════╣");
     Serial.println("║  S - Print statistics summary                          ║");
     Serial.println("║  R - Reset all counters                                ║");
+    Serial.println("║  K - Toggle soak mode (never ends, hourly summaries)   ║");
+    Serial.println("║  C - Print captured signal-loss events                 ║");
+    Serial.println("║  D - Dump reservoir-sampled packet trace               ║");
+    Serial.println("║  F - Flash-write stress self-test                      ║");
+    Serial.println("║  T - Start trace / stop and dump trace                 ║");
+    Serial.println("║  B - Binary ping log: start / stop streaming blocks    ║");
+    Serial.println("║  G - Injection self-test (stop transmitter first)      ║");
+    Serial.println("║  X - Capacity test: max sustainable ping rate          ║");
+    Serial.println("║  P - Test plan: edit/run scripted steps (abort if run) ║");
+    Serial.println("║  M - Allocation check: receive/log paths use no heap   ║");
+    Serial.println("║  J - Structured report as JSON                         ║");
+    Serial.println("║  V - Structured report as CSV (path,value rows)        ║");
     Serial.println("║  H - Print this help message                           ║");
     Serial.println("╚════════════════════════════════════════════════════════╝");
     Serial.println();
 }
 
+// Exercise the receive path while NVS writes disable the flash cache.
+// Pings keep arriving on Core 0 while Core 1 writes flash; any frame the
+// receive ring could not absorb shows up as a ring drop.
+static void runFlashStressTest() {
+#if USE_ESPNOW
+    Preferences prefs;
+    uint8_t blob[256];
+    EspNowRxStats before;
+    EspNowRxStats after;
+
+    if (!prefs.begin("diagstress", false)) {
+        Serial.println("[FlashTest] Failed to open NVS namespace");
+        return;
+    }
+
+    Serial.printf("[FlashTest] Writing %d NVS blobs while receiving...\n", FLASH_STRESS_WRITES);
+
+    espnowGetRxStats(&before);
+    uint32_t pingsBefore = _pings.received();
+    unsigned long start = millis();
+
+    for (int i = 0; i < FLASH_STRESS_WRITES; i++) {
+        // Vary the content so NVS can't skip the write
+        memset(blob, i, sizeof(blob));
+        prefs.putBytes("blob", blob, sizeof(blob));
+        esp_task_wdt_reset();
+    }
+
+    unsigned long elapsed = millis() - start;
+    prefs.remove("blob");
+    prefs.end();
+
+    // Let the ESP-NOW task finish draining what arrived during the writes
+    delay(50);
+    espnowGetRxStats(&after);
+
+    uint32_t frames = after.received - before.received;
+    uint32_t drops = after.dropped - before.dropped;
+    uint32_t pings = _pings.received() - pingsBefore;
+
+    Serial.printf("[FlashTest] %d writes in %lu ms | Frames in: %lu | Pings processed: %lu\n",
+                  FLASH_STRESS_WRITES, elapsed, frames, pings);
+    Serial.printf("[FlashTest] Ring drops: %lu | Ring high-water: %lu/%d\n",
+                  drops, after.highWater, ESPNOW_RX_RING_SIZE);
+    Serial.printf("[FlashTest] Records not captured (loop busy): %lu\n", (unsigned long)_recordsDropped);
+    if (frames == 0) {
+        Serial.println("[FlashTest] INCONCLUSIVE - no frames arrived (is the transmitter running?)");
+    } else if (drops == 0) {
+        Serial.println("[FlashTest] PASS - no frames lost during flash writes");
+    } else {
+        Serial.println("[FlashTest] FAIL - receive ring overflowed during flash writes");
+    }
+#else
+    Serial.println("[FlashTest] ESP-NOW disabled");
+#endif
+}
+
+static void printBoxLine(const char* text) {
+    Serial.printf("║  %-54s║\n", text);
+}
+
+// Serial.printf() mallocs for lines over 63 bytes; lines printed while
+// the test runs go through a stack buffer instead
+static void printLine(const char* format, ...) __attribute__((format(printf, 1, 2)));
+static void printLine(const char* format, ...) {
+    char line[192];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+    Serial.write((const uint8_t*)line, len);
+}
+
+// Received share of (received + RF missed) as "99.87%", 0% before any ping
+static void formatSuccessRate(char* buffer, size_t bufferSize) {
+    uint64_t total = (uint64_t)_pings.received() + _pings.missed();
+    statsFormatPercent((total > 0) ? statsRatioPpm(_pings.received(), total) : 0, buffer, bufferSize);
+}
+
+// RF-missed pings that FEC did not rebuild
+static uint32_t postFecMissed(const FecDecoderStats* fec) {
+    return (_pings.missed() > fec->recovered) ? _pings.missed() - fec->recovered : 0;
+}
+
+// Missed share of (received + RF missed) in ppm
+static uint32_t lossPpm(uint32_t missed) {
+    uint64_t total = (uint64_t)_pings.received() + _pings.missed();
+    return (total > 0) ? statsRatioPpm(missed, total) : 0;
+}
+
+static void resetLinkStats() {
+    portENTER_CRITICAL(&_linkStatsMux);
+    welfordInit(&_interArrival);
+    welfordInit(&_rssiStats);
+    ewmaInit(&_lossRate, LOSS_EWMA_HALF_LIFE);
+    transmitterTableInit(&_transmitters, &LINK_ALARM);
+    _linkEventHead = 0;
+    _linkEventCount = 0;
+    _linkEventsDropped = 0;
+    _linkDegradedEvents = 0;
+    portEXIT_CRITICAL(&_linkStatsMux);
+}
+
+// Queue an alarm transition for the loop. Caller holds _linkStatsMux.
+static void IRAM_ATTR queueLinkEvent(const uint8_t* mac, TransmitterEvent event, uint32_t nowMs) {
+    if (event == TRANSMITTER_EVENT_DEGRADED) _linkDegradedEvents++;
+    if (_linkEventCount >= LINK_EVENT_QUEUE_SIZE) {
+        _linkEventsDropped++;
+        return;
+    }
+
+    LinkEvent* entry = &_linkEvents[(_linkEventHead + _linkEventCount) % LINK_EVENT_QUEUE_SIZE];
+    memcpy(entry->mac, mac, 6);
+    entry->degraded = (event == TRANSMITTER_EVENT_DEGRADED);
+    entry->timeMs = nowMs;
+    transmitterLossPpm(&_transmitters, transmitterTableFind(&_transmitters, mac), nowMs,
+                       &entry->packets, &entry->seconds);
+    _linkEventCount++;
+}
+
+// Queue a ping record for capture and the reservoir (see _records)
+static void IRAM_ATTR queueRecord(const PacketRecord* record, uint32_t missed) {
+    portENTER_CRITICAL(&_recordMux);
+    if (_recordCount < RECORD_QUEUE_SIZE) {
+        QueuedRecord* entry = &_records[(_recordHead + _recordCount) % RECORD_QUEUE_SIZE];
+        entry->record = *record;
+        entry->missed = missed;
+        _recordCount++;
+    } else {
+        _recordsDropped++;
+    }
+    portEXIT_CRITICAL(&_recordMux);
+}
+
+// Hand queued records to capture and the reservoir, oldest first
+static void drainRecords() {
+    QueuedRecord entry;
+    while (true) {
+        portENTER_CRITICAL(&_recordMux);
+        bool pending = (_recordCount > 0);
+        if (pending) {
+            entry = _records[_recordHead];
+            _recordHead = (_recordHead + 1) % RECORD_QUEUE_SIZE;
+            _recordCount--;
+        }
+        portEXIT_CRITICAL(&_recordMux);
+        if (!pending) return;
+
+        eventCaptureRecordPing(&entry.record, entry.missed);
+        #if RESERVOIR_ENABLED
+            packetReservoirRecord(&entry.record);
+        #endif
+    }
+}
+
+static void clearRecords() {
+    portENTER_CRITICAL(&_recordMux);
+    _recordHead = 0;
+    _recordCount = 0;
+    _recordsDropped = 0;
+    portEXIT_CRITICAL(&_recordMux);
+}
+
+// Count logged internal drops with sequence in (last, current), forget the
+// runs that lie before current and return how many of the gap's pings
+// they account for. Bit i of *mask is set if current - i was dropped,
+// in the gap or behind it (see NoInternalDrops).
+static uint32_t IRAM_ATTR takeInternalDrops(uint32_t last, uint32_t current, uint32_t gap, uint64_t* mask) {
+    uint32_t internal = 0;
+    uint32_t kept = 0;
+
+    if (_dropLogCount == 0) return 0;  // Racy peek - a drop logged meanwhile waits for the next ping
+
+    portENTER_CRITICAL(&_dropLogMux);
+    for (uint32_t i = 0; i < _dropLogCount; i++) {
+        DropRun run = _dropLog[i];
+        uint32_t lo = (run.first > last + 1) ? run.first : last + 1;
+        uint32_t hi = (run.last < current - 1) ? run.last : current - 1;
+        if (lo <= hi) internal += hi - lo + 1;
+        if (run.first < current) {
+            uint32_t newest = (run.last < current - 1) ? run.last : current - 1;
+            for (uint32_t offset = current - newest; offset <= current - run.first && offset < 64; offset++) {
+                *mask |= (uint64_t)1 << offset;
+            }
+        }
+
+        // Part of the run beyond this ping belongs to a later gap
+        if (run.last > current) {
+            if (run.first <= current) run.first = current + 1;
+            _dropLog[kept++] = run;
+        }
+    }
+    _dropLogCount = kept;
+    portEXIT_CRITICAL(&_dropLogMux);
+
+    return (internal > gap) ? gap : internal;
+}
+
+static void clearDropLog() {
+    portENTER_CRITICAL(&_dropLogMux);
+    _dropLogCount = 0;
+    portEXIT_CRITICAL(&_dropLogMux);
+}
+
+// Feed a generated stream through the real receive ring and compare the
+// resulting statistics against the generator's ground truth
+static void startInjectionTest() {
+#if USE_ESPNOW
+    TrafficConfig config;
+    trafficGeneratorDefaultConfig(&config);
+    config.seed = esp_random() | 1;
+
+    diagnosticReceiverRestartTest();
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    _injectDroppedBefore = rx.dropped;
+
+    trafficGeneratorInit(&_injectGen, &config);
+    _injectNextUs = micros();
+    _injecting = true;
+
+    Serial.printf("[Inject] %lu synthetic pings, %d us apart (seed %lu)\n",
+                  (unsigned long)config.packetsPerMac * config.macCount,
+                  INJECT_INTERVAL_US, (unsigned long)config.seed);
+#else
+    Serial.println("[Inject] ESP-NOW disabled");
+#endif
+}
+
+static void printInjectionReport() {
+#if USE_ESPNOW
+    const TrafficTruth* truth = trafficGeneratorGetTruth(&_injectGen);
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    uint32_t ringDrops = rx.dropped - _injectDroppedBefore;
+    char line[64];
+
+    // Frames dropped by the ring never reach the receiver, so they are
+    // accounted separately from what the receiver should have counted
+    bool receivedOk = (_pings.received() + ringDrops == truth->delivered);
+    bool missedOk = (_pings.missed() == truth->lost);
+
+    Serial.println();
+    Serial.println("╔════════════════════════════════════════════════════════╗");
+    Serial.println("║            INJECTION SELF-TEST                         ║");
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Seed %lu, %lu pings sent", (unsigned long)_injectGen.config.seed,
+             (unsigned long)truth->sent);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "%-20s%-12s%-12s", "", "Truth", "Receiver");
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "%-20s%-12lu%-12lu", "Pings received:",
+             (unsigned long)truth->delivered, (unsigned long)_pings.received());
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "%-20s%-12lu%-12lu", "Pings missed:",
+             (unsigned long)truth->lost, (unsigned long)_pings.missed());
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "%-20s%-12s%-12lu", "Ring drops:", "-", (unsigned long)ringDrops);
+    printBoxLine(line);
+    // Informational: a held-back frame is not late to the receiver if
+    // every frame sent after it was lost, so these two may differ
+    snprintf(line, sizeof(line), "%-20s%-12lu%-12lu", "Reordered / late:",
+             (unsigned long)truth->reordered, (unsigned long)_pings.late());
+    printBoxLine(line);
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Duplicates:         %lu", (unsigned long)truth->duplicates);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Loss runs:          %lu (longest %lu, %lu in bursts)",
+             (unsigned long)truth->lossRuns, (unsigned long)truth->longestLossRun,
+             (unsigned long)truth->lostInBurst);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Restarts:           %lu", (unsigned long)truth->restarts);
+    printBoxLine(line);
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Received: %s    Missed: %s",
+             receivedOk ? "MATCH" : "MISMATCH", missedOk ? "MATCH" : "MISMATCH");
+    printBoxLine(line);
+    Serial.println("╚════════════════════════════════════════════════════════╝");
+    Serial.println();
+#endif
+}
+
+// Inject the frames that are due, then report once the ring has drained
+static void updateInjectionTest() {
+#if USE_ESPNOW
+    if (_injecting) {
+        unsigned long nowUs = micros();
+        for (int i = 0; i < INJECT_BURST_MAX && (long)(nowUs - _injectNextUs) >= 0; i++) {
+            TrafficFrame frame;
+            if (!trafficGeneratorNext(&_injectGen, &frame)) {
+                _injecting = false;
+                _injectReportPending = true;
+                _injectDoneTime = millis();
+                break;
+            }
+            espnowInjectFrame(frame.mac, (const uint8_t*)&frame.ping, sizeof(frame.ping));
+            _injectNextUs += INJECT_INTERVAL_US;
+        }
+    }
+
+    if (_injectReportPending && millis() - _injectDoneTime >= 100) {
+        _injectReportPending = false;
+        printInjectionReport();
+    }
+#endif
+}
+
+// Count heap allocations while pings keep arriving, logging once a second
+// through propLogf() so the log path is exercised too
+static void startAllocationCheck() {
+    if (!allocCounterAvailable()) {
+        Serial.println("[Alloc] Counter not linked in (see platformio.ini)");
+        return;
+    }
+
+    Serial.printf("[Alloc] Counting heap allocations for %d s\n", ALLOC_CHECK_MS / 1000);
+    _allocCheckPings = _pings.received();
+    _allocCheckStartMs = millis();
+    _allocCheckLogMs = _allocCheckStartMs;
+    _allocCheckStart = allocCounterGet();
+    _allocChecking = true;
+}
+
+static void updateAllocationCheck() {
+    if (!_allocChecking) return;
+
+    unsigned long now = millis();
+    uint32_t allocations = allocCounterGet() - _allocCheckStart;
+    uint32_t pings = _pings.received() - _allocCheckPings;
+
+    if (now - _allocCheckStartMs >= ALLOC_CHECK_MS) {
+        _allocChecking = false;
+        // Without pings the receive path was never exercised
+        const char* verdict = (allocations > 0) ? "FAIL"
+                            : (pings < ALLOC_CHECK_MIN_PINGS) ? "INCONCLUSIVE" : "PASS";
+        propLogf("[Alloc] %s: %lu allocations during %lu pings", verdict,
+                 (unsigned long)allocations, (unsigned long)pings);
+        if (allocations == 0 && pings < ALLOC_CHECK_MIN_PINGS) {
+            propLogf("[Alloc] Needs %d pings - start a transmitter and run M again", ALLOC_CHECK_MIN_PINGS);
+        }
+    } else if (now - _allocCheckLogMs >= 1000) {
+        _allocCheckLogMs = now;
+        propLogf("[Alloc] %lu allocations so far, %lu pings", (unsigned long)allocations,
+                 (unsigned long)pings);
+    }
+}
+
+// Lost share of a loss window as "12.50%", 0% while it is empty
+static void formatWindowLoss(const LossWindowCounts* counts, char* buffer, size_t bufferSize) {
+    statsFormatPercent((counts->slots > 0) ? statsRatioPpm(counts->lost, counts->slots) : 0, buffer, bufferSize);
+}
+
+// One queued loss alarm transition, oldest first. Returns false if none.
+static bool printLinkEvent() {
+    LinkEvent event;
+    portENTER_CRITICAL(&_linkStatsMux);
+    bool pending = (_linkEventCount > 0);
+    if (pending) {
+        event = _linkEvents[_linkEventHead];
+        _linkEventHead = (_linkEventHead + 1) % LINK_EVENT_QUEUE_SIZE;
+        _linkEventCount--;
+    }
+    portEXIT_CRITICAL(&_linkStatsMux);
+    if (!pending) return false;
+
+    char uptimeStr[16];
+    char macStr[18];
+    char packetLoss[16];
+    char secondLoss[16];
+    formatUptime(event.timeMs - _testStartTime, uptimeStr, sizeof(uptimeStr));
+    formatMac(event.mac, macStr, sizeof(macStr));
+    formatWindowLoss(&event.packets, packetLoss, sizeof(packetLoss));
+    formatWindowLoss(&event.seconds, secondLoss, sizeof(secondLoss));
+    printLine("[%s] *** %s *** %s loss %s of last %lu pings, %s of last %d s\n",
+              uptimeStr, event.degraded ? "LINK DEGRADED" : "LINK OK", macStr,
+              packetLoss, (unsigned long)event.packets.slots, secondLoss, LOSS_WINDOW_SECONDS);
+    return true;
+}
+
+// Print notices queued by the receive path
+static void printPendingNotices() {
+    char uptimeStr[16];
+
+    while (printLinkEvent()) {
+    }
+
+    if (_firstPingPending) {
+        char macStr[18];
+        formatMac(_transmitterMac, macStr, sizeof(macStr));
+        printLine("[00:00:00] First ping received from %s (seq=%lu)\n",
+                  macStr, (unsigned long)_pings.firstSequence());
+        _firstPingPending = false;
+    }
+
+    if (_restorePending) {
+        formatUptime(_restoreTime - _testStartTime, uptimeStr, sizeof(uptimeStr));
+        Serial.printf("[%s] *** SIGNAL RESTORED *** after %lu ms",
+                      uptimeStr, _restoreSilenceMs);
+        if (_restoreMissed > 0) {
+            Serial.printf(" (missed %lu packets)", _restoreMissed);
+        }
+        Serial.println();
+        _restorePending = false;
+    }
+
+    if (_announcePending) {
+        char macStr[18];
+        char name[ANNOUNCE_NAME_LEN + 1];
+        formatMac(_announceMac, macStr, sizeof(macStr));
+        memcpy(name, _announce.name, ANNOUNCE_NAME_LEN);
+        name[ANNOUNCE_NAME_LEN] = '\0';
+        printLine("[Announce] %s \"%s\" v%u, ping every %u ms\n",
+                  macStr, name, _announce.version, _announce.intervalMs);
+        _announcePending = false;
+    }
+}
+
+// Answer an echo request queued by diagnosticReceiverOnEcho().
+// Sent from the loop: esp_now_send() is not callable from the receive path.
+static void sendPendingEchoReply() {
+#if USE_ESPNOW
+    if (!_echoPending) return;
+
+    EchoMessage reply = _echoRequest;
+    reply.magic = ECHO_REPLY_MAGIC;
+    espnowAddPeer(_echoMac);  // Fails harmlessly if already a peer
+    if (espnowSend(_echoMac, (const uint8_t*)&reply, sizeof(reply))) {
+        _echoReplies++;
+    }
+    _echoPending = false;
+#endif
+}
+
 static void printFinalSummary() {
     unsigned long duration = millis() - _testStartTime;
     char durationStr[16];
     formatUptime(duration, durationStr, sizeof(durationStr));
 
-    float successRate = 0;
-    uint32_t total = _totalReceived + _totalMissed;
-    if (total > 0) {
-        successRate = (_totalReceived * 100.0f) / total;
-    }
+    char rateStr[16];
+    formatSuccessRate(rateStr, sizeof(rateStr));
 
     char macStr[18];
     formatMac(_transmitterMac, macStr, sizeof(macStr));
@@ -75,43 +654,85 @@ static void printFinalSummary() {
     Serial.println("║            RECEIVER TEST COMPLETE                      ║");
     Serial.println("╠════════════════════════════════════════════════════════╣");
     Serial.printf("║  Test duration:      %s                         ║\n", durationStr);
-    Serial.printf("║  Packets received:   %-10lu                       ║\n", _totalReceived);
-    Serial.printf("║  Packets missed:     %-10lu                       ║\n", _totalMissed);
+    Serial.printf("║  Packets received:   %-10lu                       ║\n", _pings.received());
+    Serial.printf("║  Packets missed:     %-10lu                       ║\n", _pings.missed());
+    Serial.printf("║  Internal drops:     %-10lu (not counted as RF)   ║\n", _pings.internalDrops());
     Serial.printf("║  Signal loss events: %-10lu                       ║\n", _signalLossEvents);
-    Serial.printf("║  Success rate:       %6.2f%%                          ║\n", successRate);
+    Serial.printf("║  Success rate:       %7s                          ║\n", rateStr);
+    FecDecoderStats fec;
+    fecDecoderGetStats(&fec);
+    if (fec.parityFrames > 0) {
+        char lossStr[16];
+        statsFormatPercent(lossPpm(postFecMissed(&fec)), lossStr, sizeof(lossStr));
+        Serial.printf("║  Missed after FEC:   %-10lu (%7s loss)         ║\n",
+                      (unsigned long)postFecMissed(&fec), lossStr);
+    }
     Serial.println("╠════════════════════════════════════════════════════════╣");
     Serial.printf("║  Transmitter MAC:    %s                 ║\n", macStr);
-    Serial.printf("║  Last sequence:      %-10lu                       ║\n", _lastSequenceNumber);
+    Serial.printf("║  Last sequence:      %-10lu                       ║\n", _pings.lastSequence());
     Serial.println("╚════════════════════════════════════════════════════════╝");
     Serial.println();
+
+    #if RESERVOIR_ENABLED
+        packetReservoirDump(_testStartTime);
+    #endif
+
+    #if REPORT_AT_END
+        diagnosticReceiverWriteReport(&Serial, (ReportFormat)REPORT_AT_END);
+    #endif
+
     Serial.println("Test finished. Reset device to run again.");
 }
 
+#if USE_ESPNOW
+// Subscription handler - frame is the receive ring slot itself
+static void IRAM_ATTR onDiagnosticFrame(const EspNowFrame* frame, void* context) {
+    diagnosticReceiverOnFrame(frame->mac, frame->data, frame->len);
+}
+#endif
+
 // ============================================================
 //                    PUBLIC FUNCTIONS
 // ============================================================
 
 void diagnosticReceiverInit() {
-    _totalReceived = 0;
-    _totalMissed = 0;
+    _pings.reset();
     _signalLossEvents = 0;
-    _lastSequenceNumber = 0;
-    _lastPingTime = 0;
     _lastHeartbeatTime = millis();
     _testStartTime = 0;
     _signalLost = false;
-    _firstPingReceived = false;
     _testComplete = false;
     _summaryPrinted = false;
     _transmitterKnown = false;
 
+    resetLinkStats();
+    eventCaptureInit();
+    #if RESERVOIR_ENABLED
+        packetReservoirInit();
+    #endif
+
+    #if USE_ESPNOW
+        // Every frame goes through the message table, which drops types
+        // it does not know; the prop's own receive callback and
+        // subscriptions still see all traffic
+        EspNowFilter filter;
+        espnowFilterAll(&filter);
+        if (espnowSubscribe(&filter, onDiagnosticFrame) < 0) {
+            Serial.println("[Receiver] No free ESP-NOW subscriber slot");
+        }
+    #endif
+
     Serial.println();
     Serial.println("╔════════════════════════════════════════════════════════╗");
     Serial.println("║         ESP-NOW DIAGNOSTIC RECEIVER                    ║");
     Serial.println("╠════════════════════════════════════════════════════════╣");
-    Serial.printf("║  Expecting: %d packets from transmitter            ║\n", TEST_PACKET_COUNT);
-    Serial.println("║  Test ends: On packet #10000 or 10s timeout            ║");
-    Serial.println("║  Commands: S=stats, R=reset, H=help                    ║");
+    if (_soakMode) {
+        Serial.println("║  SOAK MODE: Test never ends, hourly [SOAK] records     ║");
+    } else {
+        Serial.printf("║  Expecting: %d packets from transmitter            ║\n", TEST_PACKET_COUNT);
+        Serial.println("║  Test ends: On packet #10000 or 10s timeout            ║");
+    }
+    Serial.println("║  Commands: S=stats, R=reset, K=soak, H=help            ║");
     Serial.println("╠════════════════════════════════════════════════════════╣");
     Serial.println("║  TIP: Capture serial output to file for logging        ║");
     Serial.println("║       pio device monitor | tee log.txt                 ║");
@@ -119,9 +740,24 @@ void diagnosticReceiverInit() {
     Serial.println();
     Serial.println("Waiting for first ping from transmitter...");
     Serial.println();
+
+    // Saved test plan (may arm autorun)
+    testPlanInit();
 }
 
 void diagnosticReceiverLoop() {
+    // Notices from the receive path (first ping, signal restored, announce)
+    printPendingNotices();
+    drainRecords();
+    sendPendingEchoReply();
+    binaryLogUpdate();
+
+    // Synthetic traffic for the G self-test, X capacity test and P plan
+    updateInjectionTest();
+    capacityTestUpdate();
+    testPlanUpdate();
+    updateAllocationCheck();
+
     // If test complete, just print summary once
     if (_testComplete) {
         if (!_summaryPrinted) {
@@ -135,47 +771,75 @@ void diagnosticReceiverLoop() {
     char uptimeStr[16];
 
     // Check for test completion via timeout (10s after last packet)
-    if (_firstPingReceived && (now - _lastPingTime >= TEST_END_TIMEOUT_MS)) {
+    if (!_soakMode && _pings.started() && (now - _pings.lastArrivalMs() >= TEST_END_TIMEOUT_MS)) {
         _testComplete = true;
         return;
     }
 
+    // Advance soak windows (emits hourly summary records)
+    soakMonitorUpdate(now);
+
+    // Print any capture that completed since the last pass
+    eventCaptureUpdate();
+
     // Check for signal loss (3s timeout) - only if test still running
-    if (_firstPingReceived && !_signalLost) {
-        if (now - _lastPingTime >= SIGNAL_TIMEOUT_MS) {
+    if (_pings.started() && !_signalLost) {
+        if (now - _pings.lastArrivalMs() >= SIGNAL_TIMEOUT_MS) {
             _signalLost = true;
             _signalLossEvents++;
+            soakMonitorRecordSignalLoss();
 
             formatUptime(now - _testStartTime, uptimeStr, sizeof(uptimeStr));
-            unsigned long silenceMs = now - _lastPingTime;
-            Serial.printf("[%s] *** SIGNAL LOST *** No ping for %lu ms (last seq=%lu)\n",
-                          uptimeStr, silenceMs, _lastSequenceNumber);
+            unsigned long silenceMs = now - _pings.lastArrivalMs();
+            eventCaptureTrigger(CAPTURE_TRIGGER_SIGNAL_LOST, now, silenceMs);
+            printLine("[%s] *** SIGNAL LOST *** No ping for %lu ms (last seq=%lu)\n",
+                      uptimeStr, silenceMs, (unsigned long)_pings.lastSequence());
         }
     }
 
     // 60-second heartbeat status
-    if (_firstPingReceived && (now - _lastHeartbeatTime >= HEARTBEAT_INTERVAL_MS)) {
+    if (_pings.started() && (now - _lastHeartbeatTime >= HEARTBEAT_INTERVAL_MS)) {
         _lastHeartbeatTime = now;
+        TRACE_EVENT(TRACE_HEARTBEAT_BEGIN, 0);
 
         formatUptime(now - _testStartTime, uptimeStr, sizeof(uptimeStr));
 
-        float progress = (_lastSequenceNumber * 100.0f) / TEST_PACKET_COUNT;
-        float successRate = 0;
-        uint32_t total = _totalReceived + _totalMissed;
-        if (total > 0) {
-            successRate = (_totalReceived * 100.0f) / total;
+        if (_soakMode) {
+            SoakWindowStats hour;
+            soakMonitorGetHour(&hour);
+            char hourRate[16];
+            statsFormatPercent(statsRatioPpm(hour.received, (uint64_t)hour.received + hour.missed),
+                               hourRate, sizeof(hourRate));
+
+            Serial.println();
+            printLine("[%s] Soak | Received: %lu | Missed: %lu | Last hour: %s | Loss events: %lu\n",
+                      uptimeStr, (unsigned long)_pings.received(), (unsigned long)_pings.missed(),
+                      hourRate, (unsigned long)_signalLossEvents);
+            Serial.println();
+        } else {
+            char progress[16];
+            char successRate[16];
+            statsFormatPercent(statsRatioPpm(_pings.lastSequence(), TEST_PACKET_COUNT),
+                               progress, sizeof(progress));
+            formatSuccessRate(successRate, sizeof(successRate));
+
+            Serial.println();
+            printLine("[%s] Progress: %lu/%d (%s) | Received: %lu | Missed: %lu | Success: %s\n",
+                      uptimeStr, (unsigned long)_pings.lastSequence(), TEST_PACKET_COUNT, progress,
+                      (unsigned long)_pings.received(), (unsigned long)_pings.missed(), successRate);
+            Serial.println();
         }
 
-        Serial.println();
-        Serial.printf("[%s] Progress: %lu/%d (%.1f%%) | Received: %lu | Missed: %lu | Success: %.1f%%\n",
-                      uptimeStr, _lastSequenceNumber, TEST_PACKET_COUNT, progress,
-                      _totalReceived, _totalMissed, successRate);
-        Serial.println();
+        TRACE_EVENT(TRACE_HEARTBEAT_END, 0);
     }
 
     // Handle serial commands
     if (Serial.available()) {
         char cmd = Serial.read();
+        if (testPlanIsEditing()) {
+            testPlanInput(cmd);
+            return;
+        }
         switch (cmd) {
             case 's':
             case 'S':
@@ -187,6 +851,77 @@ void diagnosticReceiverLoop() {
                 formatUptime(now, uptimeStr, sizeof(uptimeStr));
                 Serial.printf("[%s] Counters reset\n", uptimeStr);
                 break;
+            case 'k':
+            case 'K':
+                diagnosticReceiverSetSoakMode(!_soakMode);
+                formatUptime(now - _testStartTime, uptimeStr, sizeof(uptimeStr));
+                Serial.printf("[%s] Soak mode %s\n", uptimeStr, _soakMode ? "ON" : "OFF");
+                break;
+            case 'c':
+            case 'C':
+                eventCapturePrintAll();
+                break;
+            case 't':
+            case 'T':
+                if (traceIsRunning()) {
+                    traceDump();
+                } else {
+                    traceStart();
+                    Serial.println("[TRACE] Recording - press T again to stop and dump");
+                }
+                break;
+            case 'b':
+            case 'B':
+                if (binaryLogIsRunning()) {
+                    binaryLogStop();
+                } else {
+                    binaryLogStart();
+                }
+                break;
+            case 'f':
+            case 'F':
+                runFlashStressTest();
+                break;
+            case 'g':
+            case 'G':
+                startInjectionTest();
+                break;
+            case 'x':
+            case 'X':
+                if (capacityTestIsRunning()) {
+                    capacityTestStop();
+                } else {
+                    capacityTestStart();
+                }
+                break;
+            case 'p':
+            case 'P':
+                if (testPlanIsRunning()) {
+                    testPlanStop();
+                } else {
+                    testPlanEdit();
+                }
+                break;
+            case 'm':
+            case 'M':
+                startAllocationCheck();
+                break;
+            case 'j':
+            case 'J':
+                diagnosticReceiverWriteReport(&Serial, REPORT_JSON);
+                break;
+            case 'v':
+            case 'V':
+                diagnosticReceiverWriteReport(&Serial, REPORT_CSV);
+                break;
+            case 'd':
+            case 'D':
+                #if RESERVOIR_ENABLED
+                    packetReservoirDump(_testStartTime);
+                #else
+                    Serial.println("[RESERVOIR] Disabled (RESERVOIR_ENABLED 0)");
+                #endif
+                break;
             case 'h':
             case 'H':
             case '?':
@@ -196,126 +931,839 @@ void diagnosticReceiverLoop() {
     }
 }
 
-void diagnosticReceiverOnPing(const uint8_t* mac, const uint8_t* data, int len) {
-    // Ignore packets if test is complete
-    if (_testComplete) return;
-
-    unsigned long now = millis();
-    char uptimeStr[16];
+void IRAM_ATTR diagnosticReceiverOnFrame(const uint8_t* mac, const uint8_t* data, int len) {
+    messageDispatch(mac, data, len);
+}
 
-    // Validate message
-    if (len != sizeof(PingMessage)) {
-        return;  // Silently ignore invalid packets
+// Receive hot path - IRAM-resident, no Serial output (see printPendingNotices)
+void IRAM_ATTR diagnosticReceiverOnPing(const uint8_t* mac, const uint8_t* data, int len) {
+    // Ignore packets if test is complete
+    if (_testComplete) {
+        _ignoredComplete++;
+        return;
     }
 
     const PingMessage* ping = (const PingMessage*)data;
 
-    if (ping->magic != PING_MAGIC) {
-        return;  // Silently ignore non-ping packets
-    }
+    // Per-transmitter quantiles and loss alarms cover every sender,
+    // before the lock check
+    #if USE_ESPNOW
+        int8_t rssi = espnowGetLastRssi();
+    #else
+        int8_t rssi = 0;
+    #endif
+    uint32_t arrivalMs = millis();
+    portENTER_CRITICAL(&_linkStatsMux);
+    TransmitterEvent linkEvent = transmitterTableRecord(&_transmitters, mac, ping->sequenceNumber,
+                                                        arrivalMs, ping->uptimeMs, rssi);
+    if (linkEvent != TRANSMITTER_EVENT_NONE) queueLinkEvent(mac, linkEvent, arrivalMs);
+    portEXIT_CRITICAL(&_linkStatsMux);
+    binaryLogRecord(mac, ping->sequenceNumber, arrivalMs, rssi);
 
     // Store transmitter MAC on first ping
     if (!_transmitterKnown) {
         memcpy(_transmitterMac, mac, 6);
         _transmitterKnown = true;
+    } else if (LOCK_TRANSMITTER && memcmp(mac, _transmitterMac, 6) != 0) {
+        _rejectedMac++;
+        return;  // Another transmitter's sequence would corrupt gap counting
     }
 
-    // Handle signal restoration
-    if (_signalLost) {
-        formatUptime(now - _testStartTime, uptimeStr, sizeof(uptimeStr));
-        unsigned long silenceMs = now - _lastPingTime;
-        uint32_t expectedSeq = _lastSequenceNumber + 1;
-        uint32_t actualMissed = (ping->sequenceNumber > expectedSeq) ?
-                                 (ping->sequenceNumber - expectedSeq) : 0;
+    // Count sequence gaps - not logged individually
+    PingTracker::Arrival arrival;
+    if (!_pings.record(ping, &arrival)) return;
 
-        Serial.printf("[%s] *** SIGNAL RESTORED *** after %lu ms",
-                      uptimeStr, silenceMs);
-        if (actualMissed > 0) {
-            Serial.printf(" (missed %lu packets)", actualMissed);
-        }
-        Serial.println();
+    // The FEC history is keyed by sequence alone: with the lock off,
+    // other senders' pings would overwrite the monitored one's
+    if (memcmp(mac, _transmitterMac, 6) == 0) fecDecoderOnPing(ping);
 
-        _signalLost = false;
+    unsigned long now = arrival.nowMs;
+    uint32_t missed = arrival.missed;
+    unsigned long gapMs = arrival.sinceLastMs;
+    if (missed + arrival.internal > 0) {
+        TRACE_EVENT(TRACE_GAP, missed);
     }
 
-    // Check for missed packets (sequence gaps) - count but don't log individually
-    if (_firstPingReceived && ping->sequenceNumber > _lastSequenceNumber + 1) {
-        uint32_t missed = ping->sequenceNumber - _lastSequenceNumber - 1;
-        _totalMissed += missed;
+    // Handle signal restoration - reported by the loop
+    if (_signalLost) {
+        _restoreTime = now;
+        _restoreSilenceMs = gapMs;
+        _restoreMissed = missed;
+        _restorePending = true;
+
+        _signalLost = false;
     }
 
-    // Record this ping
-    _lastSequenceNumber = ping->sequenceNumber;
-    _lastPingTime = now;
-    _totalReceived++;
+    TRACE_EVENT(TRACE_PING, ping->sequenceNumber);
 
-    if (!_firstPingReceived) {
-        _firstPingReceived = true;
+    if (arrival.first) {
         _testStartTime = now;
         _lastHeartbeatTime = now;
-        char macStr[18];
-        formatMac(mac, macStr, sizeof(macStr));
-        Serial.printf("[00:00:00] First ping received from %s (seq=%lu)\n",
-                      macStr, ping->sequenceNumber);
+        _firstPingPending = true;
+
+        if (_soakMode) {
+            soakMonitorStart(now);
+        }
     }
 
-    // Check if we've received the final packet
-    if (ping->sequenceNumber >= TEST_PACKET_COUNT) {
+    soakMonitorRecordPing(missed, gapMs);
+
+    PacketRecord record;
+    record.arrivalMs = now;
+    record.sequenceNumber = ping->sequenceNumber;
+    record.rssi = rssi;
+    record.interArrivalMs = (gapMs > 0xFFFF) ? 0xFFFF : (uint16_t)gapMs;
+    queueRecord(&record, missed);
+
+    portENTER_CRITICAL(&_linkStatsMux);
+    if (!arrival.first) welfordAdd(&_interArrival, (int32_t)gapMs);
+    if (record.rssi != 0) welfordAdd(&_rssiStats, record.rssi);
+    if (!arrival.late) {
+        ewmaAddRun(&_lossRate, true, missed);
+        ewmaAddRun(&_lossRate, false, 1);
+    } else if (arrival.recovered) {
+        // Its slot was a loss trial when the gap was seen - a late
+        // ping only flips it, like the tracker's missed count
+        ewmaUndoEvent(&_lossRate, arrival.lateBy);
+    }
+    for (uint64_t bits = arrival.nowInternal; bits != 0; bits &= bits - 1) {
+        ewmaUndoEvent(&_lossRate, __builtin_ctzll(bits));  // Dropped here after all, not lost
+    }
+    portEXIT_CRITICAL(&_linkStatsMux);
+
+    // Check if we've received the final packet (soak mode never completes)
+    if (!_soakMode && ping->sequenceNumber >= TEST_PACKET_COUNT) {
         _testComplete = true;
     }
 }
 
+void IRAM_ATTR diagnosticReceiverOnAnnounce(const uint8_t* mac, const uint8_t* data, int len) {
+    if (_announcePending) return;  // Previous one not printed yet
+
+    // The name is optional and may be cut short
+    memset(&_announce, 0, sizeof(_announce));
+    memcpy(&_announce, data, len);
+    memcpy(_announceMac, mac, 6);
+    _announcePending = true;
+}
+
+void IRAM_ATTR diagnosticReceiverOnEcho(const uint8_t* mac, const uint8_t* data, int len) {
+    if (_echoPending) {
+        _echoBusy++;
+        return;
+    }
+
+    memcpy(&_echoRequest, data, sizeof(_echoRequest));
+    memcpy(_echoMac, mac, 6);
+    _echoPending = true;
+}
+
+void IRAM_ATTR diagnosticReceiverOnStats(const uint8_t* mac, const uint8_t* data, int len) {
+    // Only the monitored transmitter's counters compare with ours
+    if (!_transmitterKnown || memcmp(mac, _transmitterMac, 6) != 0) return;
+
+    portENTER_CRITICAL(&_txStatsMux);
+    memcpy(&_txStats, data, sizeof(_txStats));
+    _txStatsKnown = true;
+    portEXIT_CRITICAL(&_txStatsMux);
+}
+
+void IRAM_ATTR diagnosticReceiverOnFecParity(const uint8_t* mac, const uint8_t* data, int len) {
+    // Parity only decodes against the monitored transmitter's pings
+    if (_testComplete) return;
+    if (!_transmitterKnown || memcmp(mac, _transmitterMac, 6) != 0) return;
+
+    fecDecoderOnParity((const FecParityMessage*)data);
+}
+
+void IRAM_ATTR diagnosticReceiverOnRingDrop(const uint8_t* mac, const uint8_t* data, int len) {
+    if (len != sizeof(PingMessage)) return;
+
+    const PingMessage* ping = (const PingMessage*)data;
+    if (ping->magic != PING_MAGIC) return;
+
+    // Every sender's table entry, so its loss window skips the gap
+    portENTER_CRITICAL(&_linkStatsMux);
+    transmitterTableRecordDrop(&_transmitters, mac, ping->sequenceNumber, millis());
+    portEXIT_CRITICAL(&_linkStatsMux);
+
+    if (_transmitterKnown && memcmp(mac, _transmitterMac, 6) != 0) return;
+
+    uint32_t seq = ping->sequenceNumber;
+
+    portENTER_CRITICAL(&_dropLogMux);
+    DropRun* tail = (_dropLogCount > 0) ? &_dropLog[_dropLogCount - 1] : nullptr;
+    if (tail != nullptr && seq == tail->last + 1) {
+        tail->last = seq;  // Usual case: consecutive pings while the ring is full
+    } else if (_dropLogCount < DROP_LOG_SIZE) {
+        _dropLog[_dropLogCount].first = seq;
+        _dropLog[_dropLogCount].last = seq;
+        _dropLogCount++;
+    } else {
+        // Log full - widen the last run to cover this ping
+        if (seq < tail->first) tail->first = seq;
+        if (seq > tail->last) tail->last = seq;
+    }
+    portEXIT_CRITICAL(&_dropLogMux);
+}
+
+// Running moments and interval estimates for the monitored link
+static void printLinkStats() {
+    WelfordStats interArrival;
+    WelfordStats rssi;
+    EwmaRate lossRate;
+    portENTER_CRITICAL(&_linkStatsMux);
+    interArrival = _interArrival;
+    rssi = _rssiStats;
+    lossRate = _lossRate;
+    portEXIT_CRITICAL(&_linkStatsMux);
+
+    char line[64];
+    char mean[16];
+    char spread[16];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    statsFormatQ8(welfordMeanQ8(&interArrival), mean, sizeof(mean));
+    statsFormatQ8(welfordStdDevQ8(&interArrival), spread, sizeof(spread));
+    snprintf(line, sizeof(line), "Inter-arrival:      %s ms (sd %s)", mean, spread);
+    printBoxLine(line);
+    if (rssi.count > 0) {
+        statsFormatQ8(welfordMeanQ8(&rssi), mean, sizeof(mean));
+        statsFormatQ8(welfordStdDevQ8(&rssi), spread, sizeof(spread));
+        snprintf(line, sizeof(line), "RSSI:               %s dBm (sd %s)", mean, spread);
+        printBoxLine(line);
+    }
+    statsFormatPercent(ewmaRatePpm(&lossRate), mean, sizeof(mean));
+    snprintf(line, sizeof(line), "Recent loss:        %s (half-life %d pings)", mean, LOSS_EWMA_HALF_LIFE);
+    printBoxLine(line);
+
+    WilsonInterval interval;
+    statsWilsonInterval(_pings.received(), _pings.received() + _pings.missed(), &interval);
+    statsFormatPercent(interval.lowPpm, mean, sizeof(mean));
+    statsFormatPercent(interval.highPpm, spread, sizeof(spread));
+    snprintf(line, sizeof(line), "Delivery (95%% CI):  %s .. %s", mean, spread);
+    printBoxLine(line);
+}
+
+// Raw loss against loss after FEC, once parity frames have arrived
+static void printFecStats() {
+    FecDecoderStats fec;
+    fecDecoderGetStats(&fec);
+    if (fec.parityFrames == 0) return;
+
+    char line[64];
+    char raw[16];
+    char post[16];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "FEC parity:         %-10lu (k=%u m=%u, %lu bad)",
+             (unsigned long)fec.parityFrames, fec.lastK, fec.lastM, (unsigned long)fec.badParity);
+    printBoxLine(line);
+    statsFormatPercent(lossPpm(_pings.missed()), raw, sizeof(raw));
+    statsFormatPercent(lossPpm(postFecMissed(&fec)), post, sizeof(post));
+    snprintf(line, sizeof(line), "  Loss raw:         %-10lu (%s)", (unsigned long)_pings.missed(), raw);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Loss after FEC:   %-10lu (%s)", (unsigned long)postFecMissed(&fec), post);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Recovered:        %-10lu (%lu failed check)",
+             (unsigned long)fec.recovered, (unsigned long)fec.verifyFailures);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Groups:           %lu clean, %lu repaired",
+             (unsigned long)fec.groupsClean, (unsigned long)fec.groupsRepaired);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Groups failed:    %-10lu (%lu pings lost)",
+             (unsigned long)fec.groupsFailed, (unsigned long)fec.unrecovered);
+    printBoxLine(line);
+    if (fec.decodes > 0) {
+        snprintf(line, sizeof(line), "  Decode:           %lu us mean, %lu us max",
+                 (unsigned long)(fec.decodeUsTotal / fec.decodes), (unsigned long)fec.decodeUsMax);
+        printBoxLine(line);
+    }
+}
+
+// Loss windows and p50/p95/p99 per transmitter, busiest first
+static void printTransmitterStats() {
+    TransmitterEntry entries[TRANSMITTER_PRINT_MAX];
+    int tracked;
+    uint32_t evictions;
+    uint32_t degradedEvents;
+    uint32_t eventsDropped;
+    uint32_t now = millis();
+    portENTER_CRITICAL(&_linkStatsMux);
+    int count = transmitterTableGetAll(&_transmitters, entries, TRANSMITTER_PRINT_MAX);
+    tracked = transmitterTableCount(&_transmitters);
+    evictions = _transmitters.evictions;
+    degradedEvents = _linkDegradedEvents;
+    eventsDropped = _linkEventsDropped;
+    portEXIT_CRITICAL(&_linkStatsMux);
+    if (count == 0) return;
+
+    char line[64];
+    char macStr[18];
+    char packetLoss[16];
+    char secondLoss[16];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Transmitters: %d of %d (%lu evicted)",
+             tracked, TRANSMITTER_TABLE_SIZE, (unsigned long)evictions);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Loss last %d pings / %d s, ! = degraded",
+             LOSS_WINDOW_PACKETS, LOSS_WINDOW_SECONDS);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Degraded events:  %-10lu (%lu not shown)",
+             (unsigned long)degradedEvents, (unsigned long)eventsDropped);
+    printBoxLine(line);
+    printBoxLine("  IAT, PDV, RSSI as p50/p95/p99");
+    for (int i = 0; i < count; i++) {
+        const TransmitterEntry* entry = &entries[i];
+        LossWindowCounts packets;
+        LossWindowCounts seconds;
+        transmitterLossPpm(&_transmitters, entry, now, &packets, &seconds);
+        formatWindowLoss(&packets, packetLoss, sizeof(packetLoss));
+        formatWindowLoss(&seconds, secondLoss, sizeof(secondLoss));
+        formatMac(entry->mac, macStr, sizeof(macStr));
+        snprintf(line, sizeof(line), "  %s %8lu  loss %7s %7s %s", macStr,
+                 (unsigned long)entry->frames, packetLoss, secondLoss, entry->degraded ? "!" : "");
+        printBoxLine(line);
+        int len = snprintf(line, sizeof(line), "    IAT %d/%d/%d  PDV %d/%d/%d ms",
+                           p2Get(&entry->interArrival, P2_P50), p2Get(&entry->interArrival, P2_P95),
+                           p2Get(&entry->interArrival, P2_P99), p2Get(&entry->pdv, P2_P50),
+                           p2Get(&entry->pdv, P2_P95), p2Get(&entry->pdv, P2_P99));
+        if (p2Count(&entry->rssi) == 0) {
+            snprintf(line + len, sizeof(line) - len, "  RSSI -");  // Injected frames carry none
+        } else {
+            snprintf(line + len, sizeof(line) - len, "  RSSI %d/%d/%d", p2Get(&entry->rssi, P2_P50),
+                     p2Get(&entry->rssi, P2_P95), p2Get(&entry->rssi, P2_P99));
+        }
+        printBoxLine(line);
+        if (entry->internal > 0) {
+            snprintf(line, sizeof(line), "    Dropped here: %lu (not in loss)", (unsigned long)entry->internal);
+            printBoxLine(line);
+        }
+    }
+}
+
+// Where every frame went, stage by stage. Ring stages come from the
+// ESP-NOW module, type and size checks from the message table; the
+// rest are counted by diagnosticReceiverOnPing().
+static void printPipelineStats() {
+    char line[64];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    #if USE_ESPNOW
+        EspNowRxStats rx;
+        espnowGetRxStats(&rx);
+        snprintf(line, sizeof(line), "Frames in:          %lu", (unsigned long)rx.received);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Not allowlisted:  %-10lu (%d on list)",
+                 (unsigned long)rx.notAllowed, espnowAllowlistCount());
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Bad length:       %lu", (unsigned long)rx.badLength);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Rate limited:     %lu", (unsigned long)rx.rateLimited);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Ring full:        %-10lu (high-water %lu/%d)",
+                 (unsigned long)rx.dropped, (unsigned long)rx.highWater, ESPNOW_RX_RING_SIZE);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Queued:           %lu", (unsigned long)rx.depth);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "  Delivered:        %-10lu (%lu late >%d ms)",
+                 (unsigned long)rx.delivered, (unsigned long)rx.late, ESPNOW_RX_LATE_US / 1000);
+        printBoxLine(line);
+    #endif
+    uint32_t badSize = 0;
+    uint32_t otherTypes = 0;
+    for (int i = 0; i < messageGetTypeCount(); i++) {
+        MessageTypeStats type;
+        messageGetTypeStats(i, &type);
+        badSize += type.badSize;
+        if (type.magic != PING_MAGIC) otherTypes += type.received;
+    }
+    snprintf(line, sizeof(line), "  Unknown type:     %lu", (unsigned long)messageGetUnknownCount());
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Bad size:         %lu", (unsigned long)badSize);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Other messages:   %lu", (unsigned long)otherTypes);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Other MAC:        %lu", (unsigned long)_rejectedMac);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  After test end:   %lu", (unsigned long)_ignoredComplete);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Accepted:         %lu", (unsigned long)_pings.received());
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Gap pings:          %lu RF, %lu internal",
+             (unsigned long)_pings.missed(), (unsigned long)_pings.internalDrops());
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Late pings:         %lu (reordered, not missed)", (unsigned long)_pings.late());
+    printBoxLine(line);
+}
+
+// Per-type counts from the message table, plus what the non-ping
+// messages reported
+static void printMessageStats() {
+    char line[64];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    printBoxLine("Message types");
+    for (int i = 0; i < messageGetTypeCount(); i++) {
+        MessageTypeStats type;
+        messageGetTypeStats(i, &type);
+        snprintf(line, sizeof(line), "  0x%02X %-9s %10lu ok %10lu bad size", type.magic,
+                 type.name, (unsigned long)type.received, (unsigned long)type.badSize);
+        printBoxLine(line);
+    }
+    snprintf(line, sizeof(line), "  Echo replies:     %-10lu (%lu busy)",
+             (unsigned long)_echoReplies, (unsigned long)_echoBusy);
+    printBoxLine(line);
+
+    if (_txStatsKnown) {
+        StatsMessage stats;
+        portENTER_CRITICAL(&_txStatsMux);
+        stats = _txStats;
+        portEXIT_CRITICAL(&_txStatsMux);
+
+        snprintf(line, sizeof(line), "  TX reports:       %lu sent, %lu failed",
+                 (unsigned long)stats.sent, (unsigned long)stats.sendFailures);
+        printBoxLine(line);
+    }
+}
+
+// Radio sources seen by the per-MAC rate limiter, busiest first
+static void printSourceStats() {
+#if USE_ESPNOW
+    RateLimitEntry sources[RATE_LIMIT_TABLE_SIZE];
+    int count = espnowGetRateLimitSources(sources, RATE_LIMIT_TABLE_SIZE);
+    if (count == 0) return;
+
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    char line[64];
+    char macStr[18];
+
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Sources (limit %d/s, burst %d, %lu evicted)",
+             ESPNOW_RATE_LIMIT_PPS, ESPNOW_RATE_LIMIT_BURST, (unsigned long)rx.rateEvictions);
+    printBoxLine(line);
+    for (int i = 0; i < count; i++) {
+        formatMac(sources[i].mac, macStr, sizeof(macStr));
+        snprintf(line, sizeof(line), "  %s %10lu ok %10lu limited", macStr,
+                 (unsigned long)sources[i].allowed, (unsigned long)sources[i].throttled);
+        printBoxLine(line);
+    }
+#endif
+}
+
 void diagnosticReceiverPrintStats() {
     char uptimeStr[16];
     formatUptime(millis() - _testStartTime, uptimeStr, sizeof(uptimeStr));
 
-    float successRate = 0;
-    uint32_t total = _totalReceived + _totalMissed;
-    if (total > 0) {
-        successRate = (_totalReceived * 100.0f) / total;
-    }
+    char rateStr[16];
+    formatSuccessRate(rateStr, sizeof(rateStr));
 
     Serial.println();
     Serial.println("╔════════════════════════════════════════════════════════╗");
     Serial.println("║              DIAGNOSTIC STATISTICS                     ║");
     Serial.println("╠════════════════════════════════════════════════════════╣");
     Serial.printf("║  Test duration:      %s                         ║\n", uptimeStr);
-    Serial.printf("║  Pings received:     %-10lu                       ║\n", _totalReceived);
-    Serial.printf("║  Pings missed:       %-10lu                       ║\n", _totalMissed);
+    Serial.printf("║  Pings received:     %-10lu                       ║\n", _pings.received());
+    Serial.printf("║  Pings missed:       %-10lu                       ║\n", _pings.missed());
     Serial.printf("║  Signal loss events: %-10lu                       ║\n", _signalLossEvents);
-    Serial.printf("║  Success rate:       %6.2f%%                          ║\n", successRate);
+    Serial.printf("║  Success rate:       %7s                          ║\n", rateStr);
     Serial.println("╠════════════════════════════════════════════════════════╣");
 
     if (_transmitterKnown) {
         char macStr[18];
         formatMac(_transmitterMac, macStr, sizeof(macStr));
         Serial.printf("║  Transmitter MAC:    %s                 ║\n", macStr);
-        Serial.printf("║  Last sequence:      %-10lu                       ║\n", _lastSequenceNumber);
+        Serial.printf("║  Last sequence:      %-10lu                       ║\n", _pings.lastSequence());
+        Serial.printf("║  TX restarts:        %-10lu                       ║\n", _pings.restarts());
     } else {
         Serial.println("║  Transmitter:        Not yet detected                  ║");
     }
 
     Serial.printf("║  Signal status:      %-10s                       ║\n",
-                  _signalLost ? "LOST" : (_firstPingReceived ? "OK" : "WAITING"));
+                  _signalLost ? "LOST" : (_pings.started() ? "OK" : "WAITING"));
+    Serial.printf("║  Captures:           %-10lu                       ║\n", eventCaptureGetCount());
+    #if RESERVOIR_ENABLED
+        Serial.printf("║  Sampled trace:      %-5lu of %-10lu             ║\n",
+                      packetReservoirGetCount(), packetReservoirGetSeen());
+    #endif
+    if (_recordsDropped > 0) {
+        Serial.printf("║  Not traced:         %-10lu (loop busy)           ║\n", (unsigned long)_recordsDropped);
+    }
+    printLinkStats();
+    printFecStats();
+    printTransmitterStats();
+    printPipelineStats();
+    printMessageStats();
+    printSourceStats();
 
     Serial.println("╚════════════════════════════════════════════════════════╝");
     Serial.println();
+
+    if (soakMonitorIsActive()) {
+        soakMonitorPrintStats();
+    }
+}
+
+// ============================================================
+//                    STRUCTURED REPORT
+// ============================================================
+// Same results as the S output and final summary, as JSON or CSV
+// for fleet tooling (see ReportWriter.h). Field names are stable;
+// rates are integer ppm, fractional values have two decimals.
+
+// moments (optional) adds the mean and standard deviation
+static void writeQuantiles(ReportWriter* writer, const char* key, const P2Quantiles* est,
+                           const WelfordStats* moments = nullptr) {
+    reportObjectBegin(writer, key);
+    reportUint(writer, "samples", p2Count(est));
+    reportInt(writer, "p50", p2Get(est, P2_P50));
+    reportInt(writer, "p95", p2Get(est, P2_P95));
+    reportInt(writer, "p99", p2Get(est, P2_P99));
+    if (moments) reportMoments(writer, moments);
+    reportObjectEnd(writer);
+}
+
+static void writeLossWindow(ReportWriter* writer, const char* key, const LossWindowCounts* counts) {
+    reportObjectBegin(writer, key);
+    reportUint(writer, "slots", counts->slots);
+    reportUint(writer, "lost", counts->lost);
+    reportObjectEnd(writer);
+}
+
+static void writeConfigReport(ReportWriter* writer) {
+    reportObjectBegin(writer, "config");
+    reportUint(writer, "signal_timeout_ms", SIGNAL_TIMEOUT_MS);
+    reportUint(writer, "heartbeat_interval_ms", HEARTBEAT_INTERVAL_MS);
+    reportUint(writer, "test_packet_count", TEST_PACKET_COUNT);
+    reportUint(writer, "test_end_timeout_ms", TEST_END_TIMEOUT_MS);
+    reportBool(writer, "lock_transmitter", LOCK_TRANSMITTER);
+    reportBool(writer, "soak_mode", _soakMode);
+    reportUint(writer, "loss_ewma_half_life", LOSS_EWMA_HALF_LIFE);
+    reportUint(writer, "loss_window_packets", LOSS_WINDOW_PACKETS);
+    reportUint(writer, "loss_window_seconds", LOSS_WINDOW_SECONDS);
+    reportUint(writer, "link_alarm_loss_ppm", LINK_ALARM_LOSS_PPM);
+    reportUint(writer, "link_clear_loss_ppm", LINK_CLEAR_LOSS_PPM);
+    reportUint(writer, "link_alarm_min_slots", LINK_ALARM_MIN_SLOTS);
+    reportUint(writer, "transmitter_table_size", TRANSMITTER_TABLE_SIZE);
+    #if USE_ESPNOW
+        reportUint(writer, "rx_ring_size", ESPNOW_RX_RING_SIZE);
+        reportUint(writer, "rate_limit_pps", ESPNOW_RATE_LIMIT_PPS);
+        reportUint(writer, "rate_limit_burst", ESPNOW_RATE_LIMIT_BURST);
+    #endif
+    reportObjectEnd(writer);
+}
+
+static void writeTestReport(ReportWriter* writer, uint32_t now) {
+    char macStr[18];
+    char text[16];
+
+    reportObjectBegin(writer, "test");
+    reportBool(writer, "started", _pings.started());
+    reportBool(writer, "complete", _testComplete);
+    reportUint(writer, "duration_ms", _pings.started() ? now - _testStartTime : 0);
+    if (_transmitterKnown) {
+        formatMac(_transmitterMac, macStr, sizeof(macStr));
+        reportString(writer, "transmitter_mac", macStr);
+        reportUint(writer, "first_sequence", _pings.firstSequence());
+        reportUint(writer, "last_sequence", _pings.lastSequence());
+    }
+    reportUint(writer, "received", _pings.received());
+    reportUint(writer, "missed", _pings.missed());
+    reportUint(writer, "internal_drops", _pings.internalDrops());
+    reportUint(writer, "late", _pings.late());
+    reportUint(writer, "restarts", _pings.restarts());
+    reportUint(writer, "signal_loss_events", _signalLossEvents);
+    uint64_t total = (uint64_t)_pings.received() + _pings.missed();
+    reportUint(writer, "success_ppm", (total > 0) ? statsRatioPpm(_pings.received(), total) : 0);
+    reportString(writer, "signal", _signalLost ? "lost" : (_pings.started() ? "ok" : "waiting"));
+    reportObjectEnd(writer);
+
+    WelfordStats interArrival;
+    WelfordStats rssi;
+    EwmaRate lossRate;
+    portENTER_CRITICAL(&_linkStatsMux);
+    interArrival = _interArrival;
+    rssi = _rssiStats;
+    lossRate = _lossRate;
+    portEXIT_CRITICAL(&_linkStatsMux);
+
+    reportObjectBegin(writer, "link");
+    reportUint(writer, "inter_arrival_samples", interArrival.count);
+    statsFormatQ8(welfordMeanQ8(&interArrival), text, sizeof(text));
+    reportNumber(writer, "inter_arrival_mean_ms", text);
+    statsFormatQ8(welfordStdDevQ8(&interArrival), text, sizeof(text));
+    reportNumber(writer, "inter_arrival_sd_ms", text);
+    if (rssi.count > 0) {
+        statsFormatQ8(welfordMeanQ8(&rssi), text, sizeof(text));
+        reportNumber(writer, "rssi_mean_dbm", text);
+        statsFormatQ8(welfordStdDevQ8(&rssi), text, sizeof(text));
+        reportNumber(writer, "rssi_sd_db", text);
+    }
+    reportUint(writer, "recent_loss_ppm", ewmaRatePpm(&lossRate));
+    WilsonInterval interval;
+    statsWilsonInterval(_pings.received(), _pings.received() + _pings.missed(), &interval);
+    reportUint(writer, "delivery_ci95_low_ppm", interval.lowPpm);
+    reportUint(writer, "delivery_ci95_high_ppm", interval.highPpm);
+    reportObjectEnd(writer);
+}
+
+// Every tracked transmitter, copied one entry at a time under the lock
+static void writeTransmittersReport(ReportWriter* writer, uint32_t now) {
+    char macStr[18];
+
+    reportArrayBegin(writer, "transmitters");
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        TransmitterEntry entry;
+        LossWindowCounts packets;
+        LossWindowCounts seconds;
+        portENTER_CRITICAL(&_linkStatsMux);
+        entry = _transmitters.entries[i];
+        if (entry.used) transmitterLossPpm(&_transmitters, &entry, now, &packets, &seconds);
+        portEXIT_CRITICAL(&_linkStatsMux);
+        if (!entry.used) continue;
+
+        formatMac(entry.mac, macStr, sizeof(macStr));
+        reportObjectBegin(writer, nullptr);
+        reportString(writer, "mac", macStr);
+        reportUint(writer, "frames", entry.frames);
+        reportUint(writer, "missed", entry.missed);
+        reportUint(writer, "internal_drops", entry.internal);
+        reportUint(writer, "last_seen_ms_ago", now - entry.lastArrivalMs);
+        reportBool(writer, "degraded", entry.degraded);
+        writeLossWindow(writer, "loss_packets", &packets);
+        writeLossWindow(writer, "loss_seconds", &seconds);
+        reportObjectBegin(writer, "loss_runs");
+        reportMoments(writer, &entry.lossRuns);
+        reportObjectEnd(writer);
+        writeQuantiles(writer, "inter_arrival_ms", &entry.interArrival, &entry.interArrivalStats);
+        writeQuantiles(writer, "pdv_ms", &entry.pdv);
+        writeQuantiles(writer, "rssi_dbm", &entry.rssi, &entry.rssiStats);
+        reportObjectEnd(writer);
+    }
+    reportArrayEnd(writer);
+}
+
+static void writePipelineReport(ReportWriter* writer) {
+    reportObjectBegin(writer, "pipeline");
+    #if USE_ESPNOW
+        EspNowRxStats rx;
+        espnowGetRxStats(&rx);
+        reportUint(writer, "frames_in", rx.received);
+        reportUint(writer, "not_allowlisted", rx.notAllowed);
+        reportUint(writer, "bad_length", rx.badLength);
+        reportUint(writer, "rate_limited", rx.rateLimited);
+        reportUint(writer, "ring_full", rx.dropped);
+        reportUint(writer, "ring_high_water", rx.highWater);
+        reportUint(writer, "queued", rx.depth);
+        reportUint(writer, "delivered", rx.delivered);
+        reportUint(writer, "late", rx.late);
+    #endif
+    uint32_t badSize = 0;
+    for (int i = 0; i < messageGetTypeCount(); i++) {
+        MessageTypeStats type;
+        messageGetTypeStats(i, &type);
+        badSize += type.badSize;
+    }
+    reportUint(writer, "unknown_type", messageGetUnknownCount());
+    reportUint(writer, "bad_size", badSize);
+    reportUint(writer, "other_mac", _rejectedMac);
+    reportUint(writer, "after_test_end", _ignoredComplete);
+    reportUint(writer, "accepted", _pings.received());
+    reportObjectEnd(writer);
+
+    reportArrayBegin(writer, "messages");
+    for (int i = 0; i < messageGetTypeCount(); i++) {
+        MessageTypeStats type;
+        messageGetTypeStats(i, &type);
+        reportObjectBegin(writer, nullptr);
+        reportString(writer, "type", type.name);
+        reportUint(writer, "magic", type.magic);
+        reportUint(writer, "received", type.received);
+        reportUint(writer, "bad_size", type.badSize);
+        reportObjectEnd(writer);
+    }
+    reportArrayEnd(writer);
+
+    reportObjectBegin(writer, "echo");
+    reportUint(writer, "replies", _echoReplies);
+    reportUint(writer, "busy", _echoBusy);
+    reportObjectEnd(writer);
+
+    if (_txStatsKnown) {
+        StatsMessage stats;
+        portENTER_CRITICAL(&_txStatsMux);
+        stats = _txStats;
+        portEXIT_CRITICAL(&_txStatsMux);
+
+        reportObjectBegin(writer, "tx_report");
+        reportUint(writer, "sent", stats.sent);
+        reportUint(writer, "send_failures", stats.sendFailures);
+        reportUint(writer, "uptime_ms", stats.uptimeMs);
+        reportObjectEnd(writer);
+    }
+
+    FecDecoderStats fec;
+    fecDecoderGetStats(&fec);
+    if (fec.parityFrames > 0) {
+        reportObjectBegin(writer, "fec");
+        reportUint(writer, "k", fec.lastK);
+        reportUint(writer, "m", fec.lastM);
+        reportUint(writer, "parity_frames", fec.parityFrames);
+        reportUint(writer, "bad_parity", fec.badParity);
+        reportUint(writer, "groups", fec.groups);
+        reportUint(writer, "groups_clean", fec.groupsClean);
+        reportUint(writer, "groups_repaired", fec.groupsRepaired);
+        reportUint(writer, "groups_failed", fec.groupsFailed);
+        reportUint(writer, "recovered", fec.recovered);
+        reportUint(writer, "unrecovered", fec.unrecovered);
+        reportUint(writer, "verify_failures", fec.verifyFailures);
+        reportUint(writer, "raw_loss_ppm", lossPpm(_pings.missed()));
+        reportUint(writer, "post_fec_missed", postFecMissed(&fec));
+        reportUint(writer, "post_fec_loss_ppm", lossPpm(postFecMissed(&fec)));
+        reportUint(writer, "decodes", fec.decodes);
+        reportUint(writer, "decode_us_max", fec.decodeUsMax);
+        reportUint(writer, "decode_us_mean", (fec.decodes > 0) ? fec.decodeUsTotal / fec.decodes : 0);
+        reportObjectEnd(writer);
+    }
+
+    #if USE_ESPNOW
+        RateLimitEntry sources[RATE_LIMIT_TABLE_SIZE];
+        int count = espnowGetRateLimitSources(sources, RATE_LIMIT_TABLE_SIZE);
+        char macStr[18];
+        reportArrayBegin(writer, "sources");
+        for (int i = 0; i < count; i++) {
+            formatMac(sources[i].mac, macStr, sizeof(macStr));
+            reportObjectBegin(writer, nullptr);
+            reportString(writer, "mac", macStr);
+            reportUint(writer, "allowed", sources[i].allowed);
+            reportUint(writer, "throttled", sources[i].throttled);
+            reportObjectEnd(writer);
+        }
+        reportArrayEnd(writer);
+    #endif
+}
+
+void diagnosticReceiverWriteReport(Print* out, ReportFormat format) {
+    uint32_t now = millis();
+    ReportWriter writer;
+    reportBegin(&writer, out, format);
+
+    reportString(&writer, "report", "espnow-diagnostic");
+    reportUint(&writer, "version", 1);
+    reportObjectBegin(&writer, "receiver");
+    #if USE_ESPNOW
+        char macStr[ESPNOW_MAC_STR_LEN];
+        espnowGetMACString(macStr, sizeof(macStr));
+        reportString(&writer, "mac", macStr);
+    #endif
+    reportUint(&writer, "uptime_ms", now);
+    reportObjectEnd(&writer);
+
+    writeConfigReport(&writer);
+    writeTestReport(&writer, now);
+    writeTransmittersReport(&writer, now);
+    writePipelineReport(&writer);
+
+    uint32_t degradedEvents;
+    uint32_t eventsDropped;
+    portENTER_CRITICAL(&_linkStatsMux);
+    degradedEvents = _linkDegradedEvents;
+    eventsDropped = _linkEventsDropped;
+    portEXIT_CRITICAL(&_linkStatsMux);
+
+    reportObjectBegin(&writer, "events");
+    reportUint(&writer, "signal_loss", _signalLossEvents);
+    reportUint(&writer, "link_degraded", degradedEvents);
+    reportUint(&writer, "link_events_not_shown", eventsDropped);
+    reportUint(&writer, "captures_completed", eventCaptureGetCount());
+    eventCaptureWriteReport(&writer);
+    reportObjectEnd(&writer);
+
+    soakMonitorWriteReport(&writer);
+    reportEnd(&writer);
 }
 
 void diagnosticReceiverReset() {
-    _totalReceived = 0;
-    _totalMissed = 0;
+    _pings.resetCounters();
+    resetLinkStats();
     _signalLossEvents = 0;
+    _rejectedMac = 0;
+    _ignoredComplete = 0;
+    _echoReplies = 0;
+    _echoBusy = 0;
+    _txStatsKnown = false;
+    clearDropLog();
+    clearRecords();
+    messageResetStats();
+    fecDecoderReset();
+
+    #if USE_ESPNOW
+        espnowResetRxStats();
+    #endif
+
+    #if RESERVOIR_ENABLED
+        packetReservoirReset();
+    #endif
+
+    if (soakMonitorIsActive()) {
+        soakMonitorStart(millis());
+    }
+}
+
+void diagnosticReceiverRestartTest() {
+    diagnosticReceiverReset();
+    _pings.reset();
+    _testStartTime = 0;
+    _signalLost = false;
+    _testComplete = false;
+    _summaryPrinted = false;
+    _transmitterKnown = false;
+}
+
+void diagnosticReceiverSetSoakMode(bool enabled) {
+    _soakMode = enabled;
+
+    if (!enabled) {
+        soakMonitorStop();
+    } else if (_pings.started()) {
+        soakMonitorStart(millis());
+    }
+    // Otherwise soak tracking starts with the first ping
+}
+
+bool diagnosticReceiverIsSoakMode() {
+    return _soakMode;
 }
 
 uint32_t diagnosticReceiverGetReceived() {
-    return _totalReceived;
+    return _pings.received();
 }
 
 uint32_t diagnosticReceiverGetMissed() {
-    return _totalMissed;
+    return _pings.missed();
+}
+
+uint32_t diagnosticReceiverGetInternalDrops() {
+    return _pings.internalDrops();
 }
 
 uint32_t diagnosticReceiverGetLossEvents() {
     return _signalLossEvents;
 }
+
+int diagnosticReceiverGetTransmitters(TransmitterEntry* out, int maxEntries) {
+    portENTER_CRITICAL(&_linkStatsMux);
+    int count = transmitterTableGetAll(&_transmitters, out, maxEntries);
+    portEXIT_CRITICAL(&_linkStatsMux);
+    return count;
+}
+
+bool diagnosticReceiverGetTransmitter(const uint8_t* mac, TransmitterEntry* out) {
+    portENTER_CRITICAL(&_linkStatsMux);
+    const TransmitterEntry* entry = transmitterTableFind(&_transmitters, mac);
+    if (entry != nullptr) *out = *entry;
+    portEXIT_CRITICAL(&_linkStatsMux);
+    return entry != nullptr;
+}
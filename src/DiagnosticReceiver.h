@@ -5,12 +5,30 @@
 // Receives pings from OER.Diagnostic.ESPNowTransmitter and logs:
 // - Each received ping with timestamp
 // - Signal loss events (no ping for 3+ seconds)
+// - Partial loss per transmitter (LINK DEGRADED / LINK OK, with
+//   hysteresis over the last LOSS_WINDOW_PACKETS pings and
+//   LOSS_WINDOW_SECONDS seconds)
 // - Missed packets (sequence gaps)
 // - 60-second heartbeat status
+// - Announce, echo and stats frames (see MessageTypes.h)
+// - Pings rebuilt from FEC parity frames, and loss after FEC
+//   (see FecDecoder.h)
 //
 // Serial Commands:
 //   S - Print statistics summary
 //   R - Reset all counters
+//   K - Toggle soak mode (test never ends, hourly summaries)
+//   C - Print captured signal-loss events
+//   D - Dump reservoir-sampled packet trace
+//   F - Flash-write stress self-test (receive during NVS writes)
+//   T - Start trace recording / stop and dump (see Trace.h)
+//   B - Binary ping log: start/stop streaming blocks (see BinaryLog.h)
+//   G - Injection self-test: synthetic traffic vs ground truth
+//   X - Capacity test: ramp injected rate to find the knee (see CapacityTest.h)
+//   P - Test plan: edit, run or abort scripted steps (see TestPlan.h)
+//   M - Allocation check: receive and log paths must not touch the heap
+//   J - Structured report as JSON (see ReportWriter.h)
+//   V - Structured report as CSV
 //   H - Print help
 //
 // To save logs: Capture Serial output to a file using your
@@ -22,6 +40,8 @@
 #define DIAGNOSTICRECEIVER_H
 
 #include <Arduino.h>
+#include "ReportWriter.h"
+#include "modules/transmitter_table.h"
 
 // ============================================================
 //                   PING MESSAGE STRUCTURE
@@ -38,6 +58,18 @@ struct PingMessage {
 
 #define PING_MAGIC 0xAA
 
+// ============================================================
+//                   PACKET RECORD
+// ============================================================
+// Compact per-packet record kept by captures and traces.
+
+struct PacketRecord {
+    uint32_t arrivalMs;      // Receiver millis() at arrival
+    uint32_t sequenceNumber; // Ping sequence number
+    int8_t rssi;             // Signal strength in dBm (0 = unknown)
+    uint16_t interArrivalMs; // Time since previous ping (saturates at 65535)
+};
+
 // ============================================================
 //                    CONFIGURATION
 // ============================================================
@@ -46,29 +78,82 @@ struct PingMessage {
 #define HEARTBEAT_INTERVAL_MS 60000  // Status heartbeat every 60 seconds
 #define TEST_PACKET_COUNT     10000  // Expected packets from transmitter
 #define TEST_END_TIMEOUT_MS   10000  // End test after 10s of no packets
+#define SOAK_MODE_DEFAULT     0      // 1 = Start in soak mode (never completes)
+#define FLASH_STRESS_WRITES   200    // NVS writes performed by the F self-test
+#define INJECT_INTERVAL_US    500    // G self-test: spacing of synthetic pings
+#define INJECT_BURST_MAX      16     // G self-test: max frames injected per loop pass
+#define LOCK_TRANSMITTER      1      // 1 = Count only the first transmitter's pings
+#define DROP_LOG_SIZE         16     // Runs of internally dropped sequences awaiting their gap
+#define ALLOC_CHECK_MS        10000  // M self-test: allocation counting window
+#define ALLOC_CHECK_MIN_PINGS 100    // M self-test: pings needed before it can pass
+#define LOSS_EWMA_HALF_LIFE   100    // Pings; a loss this many pings ago weighs half
+#define TRANSMITTER_PRINT_MAX 8      // Busiest transmitters listed with quantiles in S output
+#define LINK_ALARM_LOSS_PPM   100000 // LINK DEGRADED at 10% loss (95% confident) in either window ...
+#define LINK_CLEAR_LOSS_PPM   50000  // ... LINK OK once both are back to 5%
+#define LINK_ALARM_MIN_SLOTS  32     // Ping slots a window needs before it can alarm
+#define LINK_EVENT_QUEUE_SIZE 8      // Alarm transitions awaiting the loop
+#define RECORD_QUEUE_SIZE     128    // Ping records awaiting the loop for capture and reservoir (PSRAM)
+#define REPORT_AT_END         1      // Structured report after the final summary: 0 = none, 1 = JSON, 2 = CSV
 
 // ============================================================
 //                    FUNCTIONS
 // ============================================================
 
 // Initialize the diagnostic receiver system
+// Subscribes to ESP-NOW frames (espnowSubscribe), so it runs alongside
+// whatever the prop does with its own ESP-NOW traffic
 void diagnosticReceiverInit();
 
 // Call from loop - handles timeouts, heartbeat, and serial commands
 void diagnosticReceiverLoop();
 
-// Call from ESP-NOW receive callback with raw data
+// Process one received frame of any type (called by the subscription;
+// also usable directly). Routed by magic byte through the message table
+// in MessageTypes.cpp, which checks the length before calling a handler.
+void diagnosticReceiverOnFrame(const uint8_t* mac, const uint8_t* data, int len);
+
+// Message handlers - data is already validated for type and length.
+// IRAM-resident receive hot path - never print (notices are deferred to the loop)
 void diagnosticReceiverOnPing(const uint8_t* mac, const uint8_t* data, int len);
+void diagnosticReceiverOnAnnounce(const uint8_t* mac, const uint8_t* data, int len);
+void diagnosticReceiverOnEcho(const uint8_t* mac, const uint8_t* data, int len);
+void diagnosticReceiverOnStats(const uint8_t* mac, const uint8_t* data, int len);
+void diagnosticReceiverOnFecParity(const uint8_t* mac, const uint8_t* data, int len);
+
+// Call from the ESP-NOW drop callback (ring full or rate limited)
+// Producer context, possibly with the ring lock held - records the sequence
+// number so the resulting gap is counted as an internal drop, not RF loss
+void diagnosticReceiverOnRingDrop(const uint8_t* mac, const uint8_t* data, int len);
 
 // Get statistics
 uint32_t diagnosticReceiverGetReceived();
-uint32_t diagnosticReceiverGetMissed();
+uint32_t diagnosticReceiverGetMissed();          // Over-the-air losses only
+uint32_t diagnosticReceiverGetInternalDrops();   // Gap pings the receive path dropped
 uint32_t diagnosticReceiverGetLossEvents();
 
+// Copy the tracked transmitters (up to maxEntries), busiest first.
+// Returns the number copied.
+int diagnosticReceiverGetTransmitters(TransmitterEntry* out, int maxEntries);
+
+// Copy the entry for mac. Returns false if it is not tracked.
+bool diagnosticReceiverGetTransmitter(const uint8_t* mac, TransmitterEntry* out);
+
 // Print current statistics
 void diagnosticReceiverPrintStats();
 
+// Write the complete results (config, counters, per-transmitter
+// quantiles and loss, pipeline, events, soak windows) as a
+// structured report, streamed to out in chunks
+void diagnosticReceiverWriteReport(Print* out, ReportFormat format);
+
 // Reset all counters
 void diagnosticReceiverReset();
 
+// Reset counters and test state (first ping, completion) for a fresh run
+void diagnosticReceiverRestartTest();
+
+// Soak mode - test never completes, rolling windows + hourly summaries
+void diagnosticReceiverSetSoakMode(bool enabled);
+bool diagnosticReceiverIsSoakMode();
+
 #endif
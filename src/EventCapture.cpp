@@ -0,0 +1,226 @@
+// ============================================================
+//            EVENT CAPTURE (pre/post-trigger)
+// ============================================================
+
+#include "EventCapture.h"
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+enum CaptureState {
+    CAPTURE_ARMED,  // Filling pre-trigger ring
+    CAPTURE_POST    // Trigger fired, appending post-trigger records
+};
+
+// Loop records and triggers; reports may read from another task
+static portMUX_TYPE _captureMux = portMUX_INITIALIZER_UNLOCKED;
+
+static PacketRecord _preRing[CAPTURE_PRE_PACKETS];
+static uint16_t _preHead = 0;
+static uint16_t _preCount = 0;
+
+static CaptureEvent* _events = nullptr;  // CAPTURE_MAX_EVENTS blobs
+static CaptureEvent* _current = nullptr; // Blob being filled
+static CaptureState _state = CAPTURE_ARMED;
+
+static uint32_t _started = 0;            // Captures started since boot
+static volatile uint32_t _completed = 0; // Captures completed since boot
+static uint32_t _printed = 0;            // Captures auto-printed
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static CaptureEvent* eventSlot(uint32_t id) {
+    return &_events[(id - 1) % CAPTURE_MAX_EVENTS];
+}
+
+// Freeze the pre-trigger ring into a new blob - call with lock held
+static void startCapture(uint8_t trigger, uint32_t now, uint32_t detail) {
+    _started++;
+    CaptureEvent* ev = eventSlot(_started);
+
+    ev->id = _started;
+    ev->trigger = trigger;
+    ev->triggerMs = now;
+    ev->detail = detail;
+    ev->preCount = _preCount;
+    ev->postCount = 0;
+
+    // Copy oldest first so records are in arrival order
+    uint16_t start = (_preHead + CAPTURE_PRE_PACKETS - _preCount) % CAPTURE_PRE_PACKETS;
+    for (uint16_t i = 0; i < _preCount; i++) {
+        ev->records[i] = _preRing[(start + i) % CAPTURE_PRE_PACKETS];
+    }
+
+    _preCount = 0;
+    _current = ev;
+    _state = CAPTURE_POST;
+}
+
+static const char* triggerName(uint8_t trigger) {
+    switch (trigger) {
+        case CAPTURE_TRIGGER_SIGNAL_LOST: return "SIGNAL LOST";
+        case CAPTURE_TRIGGER_GAP:         return "SEQUENCE GAP";
+        default:                          return "UNKNOWN";
+    }
+}
+
+static void printEvent(const CaptureEvent* ev, bool inProgress) {
+    unsigned long id = ev->id;
+
+    Serial.println();
+    Serial.printf("[CAPTURE] #%lu %s at %lu ms, %s %lu, %u pre + %u post packets%s\n",
+                  id, triggerName(ev->trigger), (unsigned long)ev->triggerMs,
+                  (ev->trigger == CAPTURE_TRIGGER_SIGNAL_LOST) ? "silence ms" : "missed",
+                  (unsigned long)ev->detail, ev->preCount, ev->postCount,
+                  inProgress ? " (in progress)" : "");
+    Serial.printf("[CAPTURE] #%lu      dt_ms        seq  rssi   gap_ms\n", id);
+
+    uint16_t total = ev->preCount + ev->postCount;
+    for (uint16_t i = 0; i < total; i++) {
+        if (i == ev->preCount) {
+            Serial.printf("[CAPTURE] #%lu   -------- trigger --------\n", id);
+        }
+        const PacketRecord* rec = &ev->records[i];
+        long dt = (int32_t)(rec->arrivalMs - ev->triggerMs);
+        Serial.printf("[CAPTURE] #%lu %10ld %10lu %5d %8u\n",
+                      id, dt, (unsigned long)rec->sequenceNumber, rec->rssi, rec->interArrivalMs);
+    }
+    Serial.println();
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+bool eventCaptureInit() {
+    if (_events == nullptr) {
+        size_t size = sizeof(CaptureEvent) * CAPTURE_MAX_EVENTS;
+        #ifdef BOARD_HAS_PSRAM
+            _events = (CaptureEvent*)ps_malloc(size);
+        #endif
+        if (_events == nullptr) {
+            _events = (CaptureEvent*)malloc(size);
+        }
+        if (_events == nullptr) {
+            Serial.println("[Capture] Failed to allocate capture buffer - disabled");
+            return false;
+        }
+    }
+
+    portENTER_CRITICAL(&_captureMux);
+    _preHead = 0;
+    _preCount = 0;
+    _current = nullptr;
+    _state = CAPTURE_ARMED;
+    _started = 0;
+    _completed = 0;
+    _printed = 0;
+    portEXIT_CRITICAL(&_captureMux);
+    return true;
+}
+
+void eventCaptureRecordPing(const PacketRecord* record, uint32_t missed) {
+    if (_events == nullptr) return;
+
+    portENTER_CRITICAL(&_captureMux);
+
+    if (_state == CAPTURE_ARMED && missed >= CAPTURE_GAP_TRIGGER) {
+        // The ping that revealed the gap is the first post-trigger record
+        startCapture(CAPTURE_TRIGGER_GAP, record->arrivalMs, missed);
+    }
+
+    if (_state == CAPTURE_POST) {
+        _current->records[_current->preCount + _current->postCount] = *record;
+        _current->postCount++;
+        if (_current->postCount >= CAPTURE_POST_PACKETS) {
+            _state = CAPTURE_ARMED;
+            _completed++;
+        }
+    } else {
+        _preRing[_preHead] = *record;
+        _preHead = (_preHead + 1) % CAPTURE_PRE_PACKETS;
+        if (_preCount < CAPTURE_PRE_PACKETS) _preCount++;
+    }
+
+    portEXIT_CRITICAL(&_captureMux);
+}
+
+void eventCaptureTrigger(uint8_t trigger, uint32_t now, uint32_t detail) {
+    if (_events == nullptr) return;
+
+    portENTER_CRITICAL(&_captureMux);
+    if (_state == CAPTURE_ARMED) {
+        startCapture(trigger, now, detail);
+    }
+    portEXIT_CRITICAL(&_captureMux);
+}
+
+void eventCaptureUpdate() {
+    uint32_t completed = _completed;
+    if (_printed == completed) return;
+
+    // Skip captures already overwritten by newer ones
+    if (completed - _printed > CAPTURE_MAX_EVENTS) {
+        _printed = completed - CAPTURE_MAX_EVENTS;
+    }
+
+    while (_printed < completed) {
+        _printed++;
+        #if CAPTURE_AUTO_PRINT
+            printEvent(eventSlot(_printed), false);
+        #endif
+    }
+}
+
+uint32_t eventCaptureGetCount() {
+    return _completed;
+}
+
+void eventCapturePrintAll() {
+    if (_events == nullptr || _started == 0) {
+        Serial.println("[CAPTURE] No captures recorded");
+        return;
+    }
+
+    uint32_t first = (_started > CAPTURE_MAX_EVENTS) ? _started - CAPTURE_MAX_EVENTS + 1 : 1;
+    for (uint32_t id = first; id <= _started; id++) {
+        printEvent(eventSlot(id), id > _completed);
+    }
+}
+
+void eventCaptureWriteReport(ReportWriter* writer) {
+    reportArrayBegin(writer, "captures");
+    if (_events != nullptr && _started > 0) {
+        uint32_t first = (_started > CAPTURE_MAX_EVENTS) ? _started - CAPTURE_MAX_EVENTS + 1 : 1;
+        for (uint32_t id = first; id <= _started; id++) {
+            const CaptureEvent* ev = eventSlot(id);
+            reportObjectBegin(writer, nullptr);
+            reportUint(writer, "id", ev->id);
+            reportString(writer, "trigger", triggerName(ev->trigger));
+            reportUint(writer, "trigger_ms", ev->triggerMs);
+            reportUint(writer, "detail", ev->detail);
+            reportBool(writer, "complete", id <= _completed);
+            reportUint(writer, "pre_count", ev->preCount);
+            reportUint(writer, "post_count", ev->postCount);
+            #if CAPTURE_REPORT_RECORDS
+                reportArrayBegin(writer, "records");
+                uint16_t total = ev->preCount + ev->postCount;
+                for (uint16_t i = 0; i < total; i++) {
+                    const PacketRecord* rec = &ev->records[i];
+                    reportObjectBegin(writer, nullptr);
+                    reportInt(writer, "dt_ms", (int32_t)(rec->arrivalMs - ev->triggerMs));
+                    reportUint(writer, "seq", rec->sequenceNumber);
+                    reportInt(writer, "rssi", rec->rssi);
+                    reportUint(writer, "gap_ms", rec->interArrivalMs);
+                    reportObjectEnd(writer);
+                }
+                reportArrayEnd(writer);
+            #endif
+            reportObjectEnd(writer);
+        }
+    }
+    reportArrayEnd(writer);
+}
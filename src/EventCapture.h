@@ -0,0 +1,76 @@
+// ============================================================
+//            EVENT CAPTURE (pre/post-trigger)
+// ============================================================
+//
+// Oscilloscope-style capture around link incidents:
+// - A rolling pre-trigger ring holds the most recent packets
+// - A trigger (SIGNAL LOST or a large sequence gap) freezes it
+// - The next CAPTURE_POST_PACKETS packets are appended
+// - The finished capture is stored as one event blob
+//
+// Gives full-resolution arrival/sequence/RSSI detail exactly
+// around incidents without logging every packet.
+//
+// ============================================================
+
+#ifndef EVENTCAPTURE_H
+#define EVENTCAPTURE_H
+
+#include <Arduino.h>
+#include "DiagnosticReceiver.h"
+#include "ReportWriter.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define CAPTURE_PRE_PACKETS   64   // Packets kept before the trigger
+#define CAPTURE_POST_PACKETS  64   // Packets recorded after the trigger
+#define CAPTURE_GAP_TRIGGER   10   // Sequence gap (packets) that triggers a capture
+#define CAPTURE_MAX_EVENTS    4    // Stored captures (oldest overwritten)
+#define CAPTURE_AUTO_PRINT    1    // 1 = Print each capture when it completes
+#define CAPTURE_REPORT_RECORDS 1   // 1 = Include packet records in structured reports
+
+// Trigger sources
+#define CAPTURE_TRIGGER_SIGNAL_LOST 1  // No ping for SIGNAL_TIMEOUT_MS
+#define CAPTURE_TRIGGER_GAP         2  // Sequence gap >= CAPTURE_GAP_TRIGGER
+
+// One capture event blob
+struct CaptureEvent {
+    uint32_t id;             // Capture number (1-based)
+    uint8_t trigger;         // CAPTURE_TRIGGER_*
+    uint32_t triggerMs;      // millis() when the trigger fired
+    uint32_t detail;         // Silence in ms (signal lost) or missed packets (gap)
+    uint16_t preCount;       // Records before the trigger
+    uint16_t postCount;      // Records after the trigger
+    PacketRecord records[CAPTURE_PRE_PACKETS + CAPTURE_POST_PACKETS];
+};
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Allocate capture storage (PSRAM when available) and arm
+bool eventCaptureInit();
+
+// Call from the loop for every accepted ping, in arrival order (the
+// capture blobs may be in PSRAM, out of bounds for IRAM code)
+// missed: sequence gap before this ping (may fire a gap trigger)
+void eventCaptureRecordPing(const PacketRecord* record, uint32_t missed);
+
+// Fire a trigger from the loop (e.g. SIGNAL LOST)
+void eventCaptureTrigger(uint8_t trigger, uint32_t now, uint32_t detail);
+
+// Call from loop - prints captures as they complete
+void eventCaptureUpdate();
+
+// Number of completed captures since boot
+uint32_t eventCaptureGetCount();
+
+// Print all stored captures
+void eventCapturePrintAll();
+
+// Write stored captures as a "captures" array (see ReportWriter.h)
+void eventCaptureWriteReport(ReportWriter* writer);
+
+#endif
@@ -0,0 +1,233 @@
+// ============================================================
+//            FEC DECODER
+// ============================================================
+
+#include "FecDecoder.h"
+#include "modules/fec_codec.h"
+
+#define FEC_FRAME_LEN   sizeof(PingMessage)
+#define FEC_FRAME_WORDS ((FEC_FRAME_LEN + 3) / 4)  // Word-aligned for the XOR kernels
+
+static_assert(sizeof(((FecParityMessage*)nullptr)->parity) == FEC_FRAME_LEN, "Parity covers one ping frame");
+static_assert(FEC_HISTORY >= FEC_MAX_DATA, "History must hold a whole group");
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// Accepted ping, at sequence % FEC_HISTORY
+struct HistorySlot {
+    uint32_t frame[FEC_FRAME_WORDS];
+    uint32_t sequence;
+    bool valid;
+};
+
+// One group of k pings and the parity rows received for it
+struct FecGroup {
+    uint32_t parity[FEC_MAX_PARITY][FEC_FRAME_WORDS];
+    uint32_t first;
+    uint8_t k;
+    uint8_t m;
+    uint8_t parityMask;  // Bit r = parity row r held
+    uint8_t missing;     // Pings missing at the last check
+    bool used;
+    bool done;           // Complete, repaired or given up - nothing left to do
+};
+
+static DRAM_ATTR HistorySlot _history[FEC_HISTORY];
+static DRAM_ATTR FecGroup _groups[FEC_GROUPS];
+static uint8_t _nextGroup = 0;         // Slot the next new group takes (oldest first)
+static uint32_t _generation = 0;       // Bumped by reset; decodes that span one are dropped
+static FecDecoderStats _stats;
+static portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static inline HistorySlot* IRAM_ATTR slotFor(uint32_t sequence) {
+    return &_history[sequence % FEC_HISTORY];
+}
+
+// Bit i set if ping first + i is held. Caller holds _mux.
+static uint32_t IRAM_ATTR presentMask(const FecGroup* group) {
+    uint32_t mask = 0;
+    for (int i = 0; i < group->k; i++) {
+        const HistorySlot* slot = slotFor(group->first + i);
+        if (slot->valid && slot->sequence == group->first + i) mask |= 1u << i;
+    }
+    return mask;
+}
+
+// Count a group that is being evicted. Caller holds _mux.
+static void IRAM_ATTR retireGroup(FecGroup* group) {
+    if (!group->used || group->done) return;
+    if (group->missing > 0) {
+        _stats.groupsFailed++;
+        _stats.unrecovered += group->missing;
+    } else {
+        _stats.groupsClean++;
+    }
+}
+
+// Re-check a group and decode it if enough parity is held. Called
+// with _mux held; returns with it released. The decode itself runs
+// on copies outside the lock.
+static void IRAM_ATTR tryGroup(FecGroup* group) {
+    uint32_t present = presentMask(group);
+    group->missing = group->k - __builtin_popcount(present);
+    if (group->missing == 0) {
+        group->done = true;
+        _stats.groupsClean++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    if (group->missing > __builtin_popcount(group->parityMask)) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    uint32_t data[FEC_MAX_DATA][FEC_FRAME_WORDS];
+    uint32_t parity[FEC_MAX_PARITY][FEC_FRAME_WORDS];
+    uint8_t* dataPtr[FEC_MAX_DATA];
+    uint8_t* parityPtr[FEC_MAX_PARITY];
+    int k = group->k;
+    uint32_t first = group->first;
+    uint8_t parityMask = group->parityMask;
+    uint32_t generation = _generation;
+    for (int i = 0; i < k; i++) {
+        if (present & (1u << i)) memcpy(data[i], slotFor(first + i)->frame, sizeof(data[i]));
+        dataPtr[i] = (uint8_t*)data[i];
+    }
+    memcpy(parity, group->parity, sizeof(parity));
+    for (int r = 0; r < FEC_MAX_PARITY; r++) parityPtr[r] = (uint8_t*)parity[r];
+    portEXIT_CRITICAL(&_mux);
+
+    uint32_t startUs = micros();
+    bool decoded = fecDecode(dataPtr, k, present, parityPtr, parityMask, FEC_FRAME_LEN);
+    uint32_t elapsedUs = micros() - startUs;
+
+    portENTER_CRITICAL(&_mux);
+    if (generation != _generation || !group->used || group->done || group->first != first) {
+        portEXIT_CRITICAL(&_mux);  // Reset or evicted meanwhile
+        return;
+    }
+    _stats.decodes++;
+    _stats.decodeUsTotal += elapsedUs;
+    if (elapsedUs > _stats.decodeUsMax) _stats.decodeUsMax = elapsedUs;
+    if (decoded) {
+        uint8_t failed = 0;
+        for (int i = 0; i < k; i++) {
+            if (present & (1u << i)) continue;
+            const PingMessage* ping = (const PingMessage*)data[i];
+            if (ping->magic != PING_MAGIC || ping->sequenceNumber != first + i) {
+                failed++;
+                continue;
+            }
+            HistorySlot* slot = slotFor(first + i);
+            memcpy(slot->frame, data[i], sizeof(slot->frame));
+            slot->sequence = first + i;
+            slot->valid = true;
+            _stats.recovered++;
+        }
+
+        // A frame that fails the check means the parity does not match
+        // what was sent - more parity will not help either
+        group->done = true;
+        group->missing = failed;
+        if (failed == 0) {
+            _stats.groupsRepaired++;
+        } else {
+            _stats.verifyFailures += failed;
+            _stats.groupsFailed++;
+            _stats.unrecovered += failed;
+        }
+    }
+    portEXIT_CRITICAL(&_mux);
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void fecDecoderReset() {
+    portENTER_CRITICAL(&_mux);
+    memset(_history, 0, sizeof(_history));
+    memset(_groups, 0, sizeof(_groups));
+    memset(&_stats, 0, sizeof(_stats));
+    _nextGroup = 0;
+    _generation++;
+    portEXIT_CRITICAL(&_mux);
+}
+
+void IRAM_ATTR fecDecoderOnPing(const PingMessage* ping) {
+    uint32_t sequence = ping->sequenceNumber;
+
+    portENTER_CRITICAL(&_mux);
+    HistorySlot* slot = slotFor(sequence);
+    memcpy(slot->frame, ping, FEC_FRAME_LEN);
+    slot->sequence = sequence;
+    slot->valid = true;
+    portEXIT_CRITICAL(&_mux);
+
+    // A late ping may complete a group whose parity is already here
+    for (int g = 0; g < FEC_GROUPS; g++) {
+        portENTER_CRITICAL(&_mux);
+        FecGroup* group = &_groups[g];
+        if (group->used && !group->done && sequence - group->first < group->k) {
+            tryGroup(group);
+        } else {
+            portEXIT_CRITICAL(&_mux);
+        }
+    }
+}
+
+void IRAM_ATTR fecDecoderOnParity(const FecParityMessage* parity) {
+    portENTER_CRITICAL(&_mux);
+    if (parity->k == 0 || parity->k > FEC_MAX_DATA || parity->m == 0 || parity->m > FEC_MAX_PARITY ||
+        parity->row >= parity->m) {
+        _stats.badParity++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    FecGroup* group = nullptr;
+    for (int g = 0; g < FEC_GROUPS; g++) {
+        if (_groups[g].used && _groups[g].first == parity->firstSequence) {
+            group = &_groups[g];
+            break;
+        }
+    }
+    if (group == nullptr) {
+        group = &_groups[_nextGroup];
+        _nextGroup = (_nextGroup + 1) % FEC_GROUPS;
+        retireGroup(group);
+        memset(group, 0, sizeof(*group));
+        group->used = true;
+        group->first = parity->firstSequence;
+        group->k = parity->k;
+        group->m = parity->m;
+        _stats.groups++;
+    } else if (group->k != parity->k || group->m != parity->m) {
+        _stats.badParity++;
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+
+    _stats.parityFrames++;
+    _stats.lastK = parity->k;
+    _stats.lastM = parity->m;
+    memcpy(group->parity[parity->row], parity->parity, FEC_FRAME_LEN);
+    group->parityMask |= 1u << parity->row;
+    if (group->done) {
+        portEXIT_CRITICAL(&_mux);
+        return;
+    }
+    tryGroup(group);
+}
+
+void fecDecoderGetStats(FecDecoderStats* stats) {
+    portENTER_CRITICAL(&_mux);
+    *stats = _stats;
+    portEXIT_CRITICAL(&_mux);
+}
@@ -0,0 +1,79 @@
+// ============================================================
+//            FEC DECODER
+// ============================================================
+//
+// Rebuilds lost pings from parity frames (FEC_PARITY_MAGIC) so the
+// receiver can show how much a forward error correction scheme
+// would buy over the raw link.
+//
+// A transmitter using FEC sends, after every k pings, m parity
+// frames over the k 9-byte ping frames (modules/fec_codec.h). Each
+// parity frame names the group by its first sequence number. The
+// receiver keeps the last FEC_HISTORY accepted pings; when a
+// group's parity arrives and no more of its pings are missing than
+// parity rows are held, the missing pings are decoded, checked
+// (magic and sequence number) and counted as recovered.
+//
+// Recovered pings are not fed back into the receive statistics:
+// the ping counters keep measuring the raw link, and the decoder's
+// counters say what FEC would have delivered on top of it. Loss
+// after FEC is the RF-missed count less the recovered pings.
+//
+// Only the monitored transmitter's pings and parity reach the
+// decoder (the history is keyed by sequence, not MAC), with or
+// without LOCK_TRANSMITTER. Parity frames count against the per-MAC
+// rate limit like any other frame: raise ESPNOW_RATE_LIMIT_PPS for
+// fast ping intervals.
+//
+// The xor and rs schemes of tools/fec_whatif.cpp map directly onto
+// (k, m); the host build sends parity with --fec K:M:
+//   program --interval-us 4000 --loss 10 --fec 16:4
+//
+// ============================================================
+
+#ifndef FECDECODER_H
+#define FECDECODER_H
+
+#include <Arduino.h>
+#include "MessageTypes.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define FEC_HISTORY 64  // Accepted pings kept for decoding (>= largest k)
+#define FEC_GROUPS  4   // Groups awaiting parity or late pings at once
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+struct FecDecoderStats {
+    uint32_t parityFrames;    // Parity frames accepted
+    uint32_t badParity;       // Bad k/m/row, or not matching its group
+    uint32_t groups;          // Groups seen (any parity frame arrived)
+    uint32_t groupsClean;     // No ping missing
+    uint32_t groupsRepaired;  // Every missing ping rebuilt
+    uint32_t groupsFailed;    // Retired with pings still missing
+    uint32_t recovered;       // Pings rebuilt and verified
+    uint32_t unrecovered;     // Pings still missing in failed groups
+    uint32_t verifyFailures;  // Rebuilt frame not the expected ping
+    uint32_t decodes;         // fecDecode() calls
+    uint32_t decodeUsTotal;
+    uint32_t decodeUsMax;
+    uint8_t lastK;            // Scheme of the last parity frame
+    uint8_t lastM;
+};
+
+// Forget pings, groups and counters
+void fecDecoderReset();
+
+// Remember one accepted ping. IRAM-resident, callable from the receive path.
+void fecDecoderOnPing(const PingMessage* ping);
+
+// Take one parity frame and decode its group if possible. IRAM-resident.
+void fecDecoderOnParity(const FecParityMessage* parity);
+
+void fecDecoderGetStats(FecDecoderStats* stats);
+
+#endif
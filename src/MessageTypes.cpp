@@ -0,0 +1,133 @@
+// ============================================================
+//            DIAGNOSTIC MESSAGE TYPES
+// ============================================================
+
+#include "MessageTypes.h"
+
+#include <array>
+
+typedef void (*MessageHandler)(const uint8_t* mac, const uint8_t* data, int len);
+
+// One registered type: its magic byte, accepted length range and handler
+struct MessageType {
+    const char* name;
+    uint8_t magic;
+    uint8_t minLen;
+    uint8_t maxLen;
+    MessageHandler handler;
+};
+
+// ============================================================
+//                    REGISTRY
+// ============================================================
+// Add new diagnostic types here - the route table follows.
+
+static void IRAM_ATTR onUnknown(const uint8_t* mac, const uint8_t* data, int len) {}
+
+static constexpr MessageType MESSAGE_TYPES[] = {
+    {"Ping",      PING_MAGIC,       sizeof(PingMessage),      sizeof(PingMessage),      diagnosticReceiverOnPing},
+    {"Announce",  ANNOUNCE_MAGIC,   ANNOUNCE_MIN_LEN,         sizeof(AnnounceMessage),  diagnosticReceiverOnAnnounce},
+    {"Echo",      ECHO_MAGIC,       sizeof(EchoMessage),      sizeof(EchoMessage),      diagnosticReceiverOnEcho},
+    {"Stats",     STATS_MAGIC,      sizeof(StatsMessage),     sizeof(StatsMessage),     diagnosticReceiverOnStats},
+    {"FecParity", FEC_PARITY_MAGIC, sizeof(FecParityMessage), sizeof(FecParityMessage), diagnosticReceiverOnFecParity},
+};
+
+static constexpr int MESSAGE_TYPE_COUNT = sizeof(MESSAGE_TYPES) / sizeof(MESSAGE_TYPES[0]);
+
+// Index used for unregistered magic bytes
+static constexpr uint8_t MESSAGE_TYPE_UNKNOWN = MESSAGE_TYPE_COUNT;
+
+static constexpr bool magicsAreUnique() {
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        for (int j = i + 1; j < MESSAGE_TYPE_COUNT; j++) {
+            if (MESSAGE_TYPES[i].magic == MESSAGE_TYPES[j].magic) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(magicsAreUnique(), "Two message types share a magic byte");
+static_assert(MESSAGE_TYPE_COUNT < 255, "Type index must fit in a byte");
+
+// ============================================================
+//                    ROUTE TABLE
+// ============================================================
+
+// Per magic byte: type index and accepted length range.
+// Unknown bytes accept any length so they are counted as unknown.
+struct MessageRoute {
+    uint8_t type;
+    uint8_t minLen;
+    uint8_t lenSpan;  // maxLen - minLen, so the check is one unsigned compare
+};
+
+static constexpr std::array<MessageRoute, 256> buildRoutes() {
+    std::array<MessageRoute, 256> routes{};
+    for (auto& route : routes) {
+        route = {MESSAGE_TYPE_UNKNOWN, 0, 255};
+    }
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        const MessageType& type = MESSAGE_TYPES[i];
+        routes[type.magic] = {(uint8_t)i, type.minLen, (uint8_t)(type.maxLen - type.minLen)};
+    }
+    return routes;
+}
+
+static constexpr std::array<MessageHandler, MESSAGE_TYPE_COUNT + 1> buildHandlers() {
+    std::array<MessageHandler, MESSAGE_TYPE_COUNT + 1> handlers{};
+    for (int i = 0; i < MESSAGE_TYPE_COUNT; i++) {
+        handlers[i] = MESSAGE_TYPES[i].handler;
+    }
+    handlers[MESSAGE_TYPE_UNKNOWN] = onUnknown;
+    return handlers;
+}
+
+// Read on every frame - keep in DRAM, not flash
+static DRAM_ATTR const std::array<MessageRoute, 256> _routes = buildRoutes();
+static DRAM_ATTR const std::array<MessageHandler, MESSAGE_TYPE_COUNT + 1> _handlers = buildHandlers();
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// Written by the ESP-NOW task only; the last slot counts unknown types
+static uint32_t _received[MESSAGE_TYPE_COUNT + 1];
+static uint32_t _badSize[MESSAGE_TYPE_COUNT + 1];
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void IRAM_ATTR messageDispatch(const uint8_t* mac, const uint8_t* data, int len) {
+    if (len <= 0) return;
+
+    const MessageRoute route = _routes[data[0]];
+    if ((uint32_t)(len - route.minLen) > route.lenSpan) {
+        _badSize[route.type]++;
+        return;
+    }
+
+    _received[route.type]++;
+    _handlers[route.type](mac, data, len);
+}
+
+int messageGetTypeCount() {
+    return MESSAGE_TYPE_COUNT;
+}
+
+void messageGetTypeStats(int index, MessageTypeStats* stats) {
+    if (index < 0 || index >= MESSAGE_TYPE_COUNT) return;
+    stats->name = MESSAGE_TYPES[index].name;
+    stats->magic = MESSAGE_TYPES[index].magic;
+    stats->received = _received[index];
+    stats->badSize = _badSize[index];
+}
+
+uint32_t messageGetUnknownCount() {
+    return _received[MESSAGE_TYPE_UNKNOWN];
+}
+
+void messageResetStats() {
+    memset(_received, 0, sizeof(_received));
+    memset(_badSize, 0, sizeof(_badSize));
+}
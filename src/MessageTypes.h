@@ -0,0 +1,95 @@
+// ============================================================
+//            DIAGNOSTIC MESSAGE TYPES
+// ============================================================
+//
+// Every diagnostic frame starts with a type (magic) byte. The
+// registry in MessageTypes.cpp lists each type with its size
+// policy and handler; a 256-entry route table indexed by that
+// byte is built from it at compile time. Dispatch is one table
+// load, one range compare and one indirect call whatever the
+// number of types, so adding a type never slows down pings.
+//
+// Unknown types and frames of the wrong size are counted per
+// type and dropped.
+//
+// ============================================================
+
+#ifndef MESSAGETYPES_H
+#define MESSAGETYPES_H
+
+#include <Arduino.h>
+#include "DiagnosticReceiver.h"
+
+// ============================================================
+//                    MESSAGE STRUCTURES
+// ============================================================
+// PingMessage (PING_MAGIC) is defined in DiagnosticReceiver.h.
+
+#define ANNOUNCE_MAGIC   0xA1  // Transmitter identity, sent at boot
+#define ECHO_MAGIC       0xA2  // Round-trip request, answered with ECHO_REPLY_MAGIC
+#define ECHO_REPLY_MAGIC 0xA3  // Sent by the receiver only
+#define STATS_MAGIC      0xA4  // Transmitter's own counters
+#define FEC_PARITY_MAGIC 0xA5  // Parity over a group of pings (see FecDecoder.h)
+
+#define ANNOUNCE_NAME_LEN 16
+
+#pragma pack(push, 1)
+struct AnnounceMessage {
+    uint8_t magic;
+    uint8_t version;                // Transmitter firmware version
+    uint16_t intervalMs;            // Ping interval the transmitter uses
+    char name[ANNOUNCE_NAME_LEN];   // NUL-padded; may be cut short on the air
+};
+
+struct EchoMessage {
+    uint8_t magic;
+    uint32_t token;    // Chosen by the requester, returned unchanged
+    uint32_t sentUs;   // Requester's micros() at send, returned unchanged
+};
+
+struct StatsMessage {
+    uint8_t magic;
+    uint32_t sent;          // Pings handed to esp_now_send()
+    uint32_t sendFailures;  // Send callbacks reporting failure
+    uint32_t uptimeMs;
+};
+
+// Parity row `row` of the m sent over pings firstSequence ..
+// firstSequence + k - 1, sent right after the last of them
+struct FecParityMessage {
+    uint8_t magic;
+    uint32_t firstSequence;
+    uint8_t k;                             // Pings in the group
+    uint8_t m;                             // Parity frames per group
+    uint8_t row;                           // 0 .. m - 1; row 0 is plain XOR
+    uint8_t parity[sizeof(PingMessage)];   // Over the whole ping frames
+};
+#pragma pack(pop)
+
+// Announce name is optional: anything from the fixed header up
+#define ANNOUNCE_MIN_LEN (sizeof(AnnounceMessage) - ANNOUNCE_NAME_LEN)
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+struct MessageTypeStats {
+    const char* name;
+    uint8_t magic;
+    uint32_t received;  // Dispatched to the handler
+    uint32_t badSize;   // Right type, length outside the size policy
+};
+
+// Route one raw frame to its type handler - IRAM-resident, never prints
+void messageDispatch(const uint8_t* mac, const uint8_t* data, int len);
+
+// Registered types (for iterating with messageGetTypeStats)
+int messageGetTypeCount();
+void messageGetTypeStats(int index, MessageTypeStats* stats);
+
+// Frames whose type byte is not registered
+uint32_t messageGetUnknownCount();
+
+void messageResetStats();
+
+#endif
@@ -0,0 +1,124 @@
+// ============================================================
+//            PACKET RESERVOIR (uniform sampled trace)
+// ============================================================
+
+#include "PacketReservoir.h"
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// Records arrive from the loop; reports may read from another task
+static portMUX_TYPE _reservoirMux = portMUX_INITIALIZER_UNLOCKED;
+
+static PacketRecord* _samples = nullptr;  // RESERVOIR_SIZE records
+static volatile uint32_t _seen = 0;       // Packets offered since reset
+static uint32_t _rngState = 1;            // xorshift32 state (never 0)
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+// xorshift32 - cheap and good enough for slot selection
+static uint32_t nextRandom() {
+    uint32_t x = _rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    _rngState = x;
+    return x;
+}
+
+// Uniform integer in [0, range) without division (Lemire reduction)
+static uint32_t randomBelow(uint32_t range) {
+    return (uint32_t)(((uint64_t)nextRandom() * range) >> 32);
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+bool packetReservoirInit() {
+    if (_samples == nullptr) {
+        size_t size = sizeof(PacketRecord) * RESERVOIR_SIZE;
+        #ifdef BOARD_HAS_PSRAM
+            _samples = (PacketRecord*)ps_malloc(size);
+        #endif
+        if (_samples == nullptr) {
+            _samples = (PacketRecord*)malloc(size);
+        }
+        if (_samples == nullptr) {
+            Serial.println("[Reservoir] Failed to allocate sample buffer - disabled");
+            return false;
+        }
+    }
+
+    packetReservoirReset();
+    return true;
+}
+
+void packetReservoirReset() {
+    portENTER_CRITICAL(&_reservoirMux);
+    _seen = 0;
+    _rngState = esp_random() | 1;
+    portEXIT_CRITICAL(&_reservoirMux);
+}
+
+void packetReservoirRecord(const PacketRecord* record) {
+    if (_samples == nullptr) return;
+
+    portENTER_CRITICAL(&_reservoirMux);
+
+    uint32_t seen = _seen;
+    if (seen < RESERVOIR_SIZE) {
+        // Filling phase - keep everything
+        _samples[seen] = *record;
+    } else if (seen != UINT32_MAX) {
+        // Item n (0-based) replaces a random slot with probability K/(n+1)
+        uint32_t slot = randomBelow(seen + 1);
+        if (slot < RESERVOIR_SIZE) {
+            _samples[slot] = *record;
+        }
+    }
+    if (seen != UINT32_MAX) {
+        _seen = seen + 1;
+    }
+
+    portEXIT_CRITICAL(&_reservoirMux);
+}
+
+uint32_t packetReservoirGetSeen() {
+    return _seen;
+}
+
+uint32_t packetReservoirGetCount() {
+    return (_seen < RESERVOIR_SIZE) ? _seen : RESERVOIR_SIZE;
+}
+
+void packetReservoirDump(unsigned long testStartMs) {
+    if (_samples == nullptr) {
+        Serial.println("[RESERVOIR] Disabled (no buffer)");
+        return;
+    }
+
+    uint32_t count = packetReservoirGetCount();
+
+    Serial.println();
+    Serial.printf("[RESERVOIR] %lu of %lu packets sampled uniformly\n",
+                  (unsigned long)count, (unsigned long)_seen);
+    Serial.println("[RESERVOIR] seq,t_ms,gap_ms,rssi");
+
+    for (uint32_t i = 0; i < count; i++) {
+        // Copy under lock so a concurrent replacement can't tear the record
+        PacketRecord rec;
+        portENTER_CRITICAL(&_reservoirMux);
+        rec = _samples[i];
+        portEXIT_CRITICAL(&_reservoirMux);
+
+        Serial.printf("[RESERVOIR] %lu,%lu,%u,%d\n",
+                      (unsigned long)rec.sequenceNumber,
+                      (unsigned long)(rec.arrivalMs - testStartMs),
+                      rec.interArrivalMs, rec.rssi);
+    }
+    Serial.println();
+}
@@ -0,0 +1,51 @@
+// ============================================================
+//            PACKET RESERVOIR (uniform sampled trace)
+// ============================================================
+//
+// Keeps a statistically uniform sample of RESERVOIR_SIZE packet
+// records over an arbitrarily long test (reservoir sampling,
+// Algorithm R). Every accepted ping has the same probability of
+// being in the sample, so arrival and RSSI distributions from the
+// dump are unbiased even for multi-million-packet soaks.
+//
+// The buffer is allocated once in PSRAM. Dumped at the end of the
+// test and on the D serial command as [RESERVOIR] CSV lines.
+//
+// ============================================================
+
+#ifndef PACKETRESERVOIR_H
+#define PACKETRESERVOIR_H
+
+#include <Arduino.h>
+#include "DiagnosticReceiver.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define RESERVOIR_ENABLED 1     // 1 = Keep a sampled packet trace
+#define RESERVOIR_SIZE    1024  // Records kept (12 bytes each)
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Allocate the sample buffer (PSRAM when available) and clear it
+bool packetReservoirInit();
+
+// Clear the sample without freeing the buffer
+void packetReservoirReset();
+
+// Offer one packet to the reservoir - call for every accepted ping
+void packetReservoirRecord(const PacketRecord* record);
+
+// Packets offered since the last reset
+uint32_t packetReservoirGetSeen();
+
+// Records currently held (min of seen and RESERVOIR_SIZE)
+uint32_t packetReservoirGetCount();
+
+// Dump the sample as CSV, arrival times relative to testStartMs
+void packetReservoirDump(unsigned long testStartMs);
+
+#endif
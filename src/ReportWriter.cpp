@@ -0,0 +1,241 @@
+// ============================================================
+//            STRUCTURED REPORT WRITER (JSON / CSV)
+// ============================================================
+
+#include "ReportWriter.h"
+
+// ============================================================
+//                    OUTPUT
+// ============================================================
+
+static void flush(ReportWriter* writer) {
+    if (writer->used == 0) return;
+    writer->out->write((const uint8_t*)writer->chunk, writer->used);
+    writer->bytes += writer->used;
+    writer->used = 0;
+}
+
+static void put(ReportWriter* writer, char c) {
+    if (writer->used == REPORT_CHUNK_SIZE) flush(writer);
+    writer->chunk[writer->used++] = c;
+}
+
+static void putText(ReportWriter* writer, const char* text) {
+    while (*text) put(writer, *text++);
+}
+
+// JSON string body: quotes, backslashes and control characters escaped
+static void putJsonString(ReportWriter* writer, const char* text) {
+    put(writer, '"');
+    for (; *text; text++) {
+        char c = *text;
+        if (c == '"' || c == '\\') {
+            put(writer, '\\');
+            put(writer, c);
+        } else if ((uint8_t)c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)(uint8_t)c);
+            putText(writer, escaped);
+        } else {
+            put(writer, c);
+        }
+    }
+    put(writer, '"');
+}
+
+// CSV field: quoted only when it holds a separator, quote or newline
+static void putCsvField(ReportWriter* writer, const char* text) {
+    if (strpbrk(text, ",\"\r\n") == nullptr) {
+        putText(writer, text);
+        return;
+    }
+    put(writer, '"');
+    for (; *text; text++) {
+        if (*text == '"') put(writer, '"');
+        put(writer, *text);
+    }
+    put(writer, '"');
+}
+
+// ============================================================
+//                    STRUCTURE
+// ============================================================
+
+// Append this member's name (or array index) to the CSV path
+static void pushPath(ReportWriter* writer, const char* key) {
+    uint8_t len = writer->pathLen[writer->depth];
+    char index[8];
+    if (writer->array[writer->depth - 1]) {
+        snprintf(index, sizeof(index), "%u", (unsigned)writer->count[writer->depth - 1]);
+        key = index;
+    }
+    int written = snprintf(writer->path + len, REPORT_PATH_LEN - len, "%s%s", (len > 0) ? "." : "", key);
+    if (written < 0 || len + written >= REPORT_PATH_LEN) {
+        writer->path[REPORT_PATH_LEN - 1] = '\0';
+    }
+}
+
+// Separator and key before a new member of the current container
+static void beginMember(ReportWriter* writer, const char* key) {
+    bool inArray = writer->array[writer->depth - 1];
+    if (key == nullptr) key = "";
+
+    if (writer->format == REPORT_JSON) {
+        if (writer->count[writer->depth - 1] > 0) put(writer, ',');
+        if (!inArray) {
+            putJsonString(writer, key);
+            put(writer, ':');
+        }
+    } else {
+        pushPath(writer, key);
+    }
+}
+
+static void endMember(ReportWriter* writer) {
+    writer->count[writer->depth - 1]++;
+    writer->path[writer->pathLen[writer->depth]] = '\0';
+}
+
+// One scalar: rendered already as JSON text (number, literal or quoted)
+static void writeValue(ReportWriter* writer, const char* key, const char* jsonText, const char* csvText) {
+    if (writer->skipped > 0) return;
+    beginMember(writer, key);
+    if (writer->format == REPORT_JSON) {
+        putText(writer, jsonText);
+    } else {
+        putCsvField(writer, writer->path);
+        put(writer, ',');
+        putCsvField(writer, csvText);
+        put(writer, '\n');
+    }
+    endMember(writer);
+}
+
+static void openContainer(ReportWriter* writer, const char* key, bool array) {
+    if (writer->skipped > 0 || writer->depth >= REPORT_MAX_DEPTH) {
+        writer->skipped++;  // Too deep: left out with everything inside it
+        return;
+    }
+
+    beginMember(writer, key);
+    if (writer->format == REPORT_JSON) put(writer, array ? '[' : '{');
+
+    writer->array[writer->depth] = array;
+    writer->count[writer->depth] = 0;
+    writer->depth++;
+    writer->pathLen[writer->depth] = strlen(writer->path);
+}
+
+static void closeContainer(ReportWriter* writer) {
+    if (writer->skipped > 0) {
+        writer->skipped--;
+        return;
+    }
+    if (writer->depth <= 1) return;  // The root closes in reportEnd()
+
+    writer->depth--;
+    if (writer->format == REPORT_JSON) put(writer, writer->array[writer->depth] ? ']' : '}');
+    endMember(writer);
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void reportBegin(ReportWriter* writer, Print* out, ReportFormat format) {
+    memset(writer, 0, sizeof(*writer));
+    writer->out = out;
+    writer->format = format;
+
+    char marker[32];
+    snprintf(marker, sizeof(marker), "[REPORT %s]\n", reportFormatName(format));
+    out->write((const uint8_t*)marker, strlen(marker));
+
+    if (format == REPORT_JSON) {
+        put(writer, '{');
+    } else {
+        putText(writer, "path,value\n");
+    }
+
+    // The document itself is the root object
+    writer->array[0] = false;
+    writer->depth = 1;
+}
+
+void reportEnd(ReportWriter* writer) {
+    writer->skipped = 0;
+    while (writer->depth > 1) closeContainer(writer);
+    if (writer->format == REPORT_JSON) putText(writer, "}\n");
+    flush(writer);
+
+    char marker[40];
+    snprintf(marker, sizeof(marker), "[REPORT END] %lu bytes\n", (unsigned long)writer->bytes);
+    writer->out->write((const uint8_t*)marker, strlen(marker));
+}
+
+void reportObjectBegin(ReportWriter* writer, const char* key) {
+    openContainer(writer, key, false);
+}
+
+void reportObjectEnd(ReportWriter* writer) {
+    closeContainer(writer);
+}
+
+void reportArrayBegin(ReportWriter* writer, const char* key) {
+    openContainer(writer, key, true);
+}
+
+void reportArrayEnd(ReportWriter* writer) {
+    closeContainer(writer);
+}
+
+void reportUint(ReportWriter* writer, const char* key, uint64_t value) {
+    // Built by hand: newlib-nano printf has no %llu
+    char text[24];
+    char* p = text + sizeof(text) - 1;
+    *p = '\0';
+    do {
+        *--p = '0' + (char)(value % 10);
+        value /= 10;
+    } while (value > 0);
+    writeValue(writer, key, p, p);
+}
+
+void reportInt(ReportWriter* writer, const char* key, int32_t value) {
+    char text[16];
+    snprintf(text, sizeof(text), "%ld", (long)value);
+    writeValue(writer, key, text, text);
+}
+
+void reportBool(ReportWriter* writer, const char* key, bool value) {
+    const char* text = value ? "true" : "false";
+    writeValue(writer, key, text, text);
+}
+
+void reportString(ReportWriter* writer, const char* key, const char* value) {
+    if (writer->format == REPORT_CSV) {
+        writeValue(writer, key, nullptr, value);
+        return;
+    }
+    if (writer->skipped > 0) return;
+    beginMember(writer, key);
+    putJsonString(writer, value);
+    endMember(writer);
+}
+
+void reportNumber(ReportWriter* writer, const char* key, const char* text) {
+    writeValue(writer, key, text, text);
+}
+
+void reportMoments(ReportWriter* writer, const WelfordStats* stats) {
+    char text[16];
+    reportUint(writer, "n", stats->count);
+    statsFormatQ8(welfordMeanQ8(stats), text, sizeof(text));
+    reportNumber(writer, "mean", text);
+    statsFormatQ8((int32_t)welfordStdDevQ8(stats), text, sizeof(text));
+    reportNumber(writer, "sd", text);
+}
+
+const char* reportFormatName(ReportFormat format) {
+    return (format == REPORT_CSV) ? "csv" : "json";
+}
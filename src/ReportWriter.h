@@ -0,0 +1,100 @@
+// ============================================================
+//            STRUCTURED REPORT WRITER (JSON / CSV)
+// ============================================================
+//
+// Streams machine-readable results to any Print (Serial on the
+// device, stdout on the host) without building the document in
+// RAM: values are formatted into a REPORT_CHUNK_SIZE buffer that
+// is written out whenever it fills.
+//
+// Callers describe the document once, as nested objects and
+// arrays of named values; the writer renders either:
+//
+//   JSON - one compact document:
+//     {"test":{"received":9990,...},"transmitters":[{"mac":...},...]}
+//
+//   CSV  - one "path,value" row per value, array items indexed:
+//     path,value
+//     test.received,9990
+//     transmitters.0.mac,AA:BB:CC:DD:EE:FF
+//
+// Every report is framed by marker lines so it can be cut out of
+// a Serial log that also carries human-readable output:
+//
+//   [REPORT json]
+//   ...
+//   [REPORT END] 4321 bytes
+//
+// Not thread-safe - one writer per report, from the loop.
+//
+// ============================================================
+
+#ifndef REPORTWRITER_H
+#define REPORTWRITER_H
+
+#include <Arduino.h>
+#include "modules/fixed_stats.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define REPORT_CHUNK_SIZE 128  // Bytes buffered per write to the output
+#define REPORT_MAX_DEPTH  8    // Nested objects/arrays, the root included
+#define REPORT_PATH_LEN   80   // CSV: longest "a.b.3.c" path
+
+enum ReportFormat {
+    REPORT_JSON = 1,
+    REPORT_CSV = 2,
+};
+
+// Writer state. Treat the fields as private; use the functions below.
+struct ReportWriter {
+    Print* out;
+    ReportFormat format;
+    uint32_t bytes;                         // Written so far (document only)
+    char chunk[REPORT_CHUNK_SIZE];
+    uint16_t used;
+    uint8_t depth;                          // Open containers, the root included
+    uint8_t skipped;                        // Containers opened beyond REPORT_MAX_DEPTH
+    bool array[REPORT_MAX_DEPTH];           // Container at each depth is an array
+    uint16_t count[REPORT_MAX_DEPTH];       // Members written at each depth
+    uint8_t pathLen[REPORT_MAX_DEPTH + 1];  // CSV: path length at each depth
+    char path[REPORT_PATH_LEN];
+};
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Start a report: opening marker, then "{" (JSON) or the header row (CSV)
+void reportBegin(ReportWriter* writer, Print* out, ReportFormat format);
+
+// Close any open containers, flush and print the closing marker
+void reportEnd(ReportWriter* writer);
+
+// Containers. key names the member inside an object and is
+// ignored inside arrays (items are numbered).
+void reportObjectBegin(ReportWriter* writer, const char* key);
+void reportObjectEnd(ReportWriter* writer);
+void reportArrayBegin(ReportWriter* writer, const char* key);
+void reportArrayEnd(ReportWriter* writer);
+
+// Values
+void reportUint(ReportWriter* writer, const char* key, uint64_t value);
+void reportInt(ReportWriter* writer, const char* key, int32_t value);
+void reportBool(ReportWriter* writer, const char* key, bool value);
+void reportString(ReportWriter* writer, const char* key, const char* value);
+
+// Pre-formatted number, e.g. "12.34" from statsFormatQ8()
+void reportNumber(ReportWriter* writer, const char* key, const char* text);
+
+// Members "n", "mean" and "sd" of a running mean/variance, written
+// into the open object. Enough for a reader to put a confidence
+// interval on the mean (tools/report_compare.cpp).
+void reportMoments(ReportWriter* writer, const WelfordStats* stats);
+
+// Format name for the report marker ("json" / "csv")
+const char* reportFormatName(ReportFormat format);
+
+#endif
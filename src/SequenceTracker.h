@@ -0,0 +1,241 @@
+// ============================================================
+//            SEQUENCE TRACKER
+// ============================================================
+//
+// Gap and timing bookkeeping for any message stream carrying an
+// incrementing sequence number, as a class template resolved at
+// compile time:
+//
+//   Traits - the message: sequence field and width, sender
+//            timestamp, integrity check (see PingTraits in
+//            DiagnosticReceiver.cpp)
+//   Clock  - where arrival times come from (MillisClock)
+//   Drops  - which of a gap's sequences the receive path dropped
+//            itself (NoInternalDrops unless the caller logs its drops)
+//
+// record() is forced inline, so a tracker costs what hand-written
+// code would and lands in IRAM with its caller. Trackers for
+// different streams run side by side, e.g. a 16-bit event stream:
+//
+//   struct EventTraits {
+//       typedef GameEvent Message;
+//       typedef uint16_t Sequence;
+//       static Sequence sequence(const GameEvent* e) { return e->seq; }
+//       static uint32_t timestampMs(const GameEvent* e) { return e->timeMs; }
+//       static bool intact(const GameEvent* e) { return e->crc == crc8(e); }
+//   };
+//   static SequenceTracker<EventTraits> _events;
+//
+// Sequences wrap at their width: a step forward of less than half
+// the range counts the skipped numbers as lost. The tracker stays at
+// the highest sequence seen: a late (reordered) message within
+// LATE_WINDOW of it takes back the loss counted for it, once - a
+// duplicate of it does not. If Drops named its sequence, that was an
+// internal drop, not an RF loss. A restart (sequence and sender clock
+// both back) or a step back beyond LATE_WINDOW resynchronises without
+// loss.
+//
+// Not thread-safe - one writer, the receive path.
+//
+// ============================================================
+
+#ifndef SEQUENCETRACKER_H
+#define SEQUENCETRACKER_H
+
+#include <Arduino.h>
+#include <limits>
+
+#define TRACKER_INLINE inline __attribute__((always_inline))
+
+// Default clock: Arduino millis()
+struct MillisClock {
+    static TRACKER_INLINE uint32_t nowMs() { return millis(); }
+};
+
+// Default drop policy: every skipped sequence was lost over the air.
+// take() is called as the stream advances from last to current. It
+// returns how many of the gap's sequences (last, current) the receive
+// path dropped, and sets bit i of *mask for every dropped sequence
+// current - i (0 < i < 64) - including ones at or behind last, i.e.
+// reordered messages that were dropped after their gap was counted.
+struct NoInternalDrops {
+    static TRACKER_INLINE uint32_t take(uint32_t last, uint32_t current, uint32_t gap, uint64_t* mask) {
+        return 0;
+    }
+};
+
+template <typename Traits, typename Clock = MillisClock, typename Drops = NoInternalDrops>
+class SequenceTracker {
+public:
+    typedef typename Traits::Message Message;
+    typedef typename Traits::Sequence Sequence;
+
+    static_assert(std::numeric_limits<Sequence>::is_integer && !std::numeric_limits<Sequence>::is_signed,
+                  "Sequence must be an unsigned integer");
+
+    // What one accepted message did to the stream
+    struct Arrival {
+        uint32_t nowMs;        // Clock at arrival
+        uint32_t missed;       // Lost over the air just before this message
+        uint32_t internal;     // Dropped by the receive path just before it
+        uint32_t sinceLastMs;  // Since the previous message, 0 for the first
+        bool first;            // First message since reset()
+        bool late;             // Behind the highest sequence seen (reordered or duplicate)
+        bool recovered;        // Late, and took back an RF loss counted for its gap
+        uint32_t lateBy;       // Sequences behind the highest seen, 0 unless late
+        uint64_t nowInternal;  // Bit i: this - i was counted lost, but the receive path dropped it
+        bool restarted;        // Sequence and sender clock both went back (see RESTART_MS)
+    };
+
+    // Account for one message. Returns false (counted as corrupt) if
+    // the message fails the integrity check; arrival is then untouched.
+    TRACKER_INLINE bool record(const Message* msg, Arrival* arrival) {
+        if (!Traits::intact(msg)) {
+            _corrupt++;
+            return false;
+        }
+
+        Sequence seq = Traits::sequence(msg);
+        uint32_t senderMs = Traits::timestampMs(msg);
+        arrival->nowMs = Clock::nowMs();
+        arrival->missed = 0;
+        arrival->internal = 0;
+        arrival->sinceLastMs = 0;
+        arrival->first = !_started;
+        arrival->late = false;
+        arrival->recovered = false;
+        arrival->lateBy = 0;
+        arrival->nowInternal = 0;
+        arrival->restarted = false;
+
+        bool advance = true;
+        if (_started) {
+            Sequence step = (Sequence)(seq - _last);
+            Sequence back = (Sequence)(_last - seq);
+            if (step >= 1 && step < HALF_RANGE) {
+                uint32_t gap = step - 1;
+                uint64_t dropped = 0;
+                arrival->internal = Drops::take(_last, seq, gap, &dropped);
+                arrival->missed = gap - arrival->internal;
+                _seen = (step < LATE_WINDOW) ? (_seen << step) | 1 : 1;
+                _dropped = (step < LATE_WINDOW) ? _dropped << step : 0;
+
+                // Drops behind the previous highest were counted lost
+                // with an earlier gap, unless they arrived after all
+                uint64_t thisGap = (step < LATE_WINDOW) ? ((uint64_t)1 << step) - 1 : ~(uint64_t)0;
+                uint64_t earlier = dropped & ~thisGap & ~_seen & ~_dropped;
+                uint32_t moved = __builtin_popcountll(earlier);
+                if (moved > _missed) moved = _missed;
+                _missed -= moved;
+                _internal += moved;
+                arrival->nowInternal = earlier;
+                _dropped |= dropped;
+            } else if (step == 0) {
+                arrival->late = true;  // Duplicate of the latest
+                advance = false;
+            } else if (senderMs + RESTART_MS < _lastSenderMs) {
+                arrival->restarted = true;
+                _restarts++;
+                _seen = 1;
+                _dropped = 0;
+            } else if (back < LATE_WINDOW) {
+                arrival->late = true;
+                arrival->lateBy = back;
+                advance = false;
+                uint64_t bit = (uint64_t)1 << back;
+                if (!(_seen & bit)) {
+                    _seen |= bit;
+                    _late++;
+                    if (_dropped & bit) {
+                        _dropped &= ~bit;  // Counted as a receive-path drop
+                        if (_internal > 0) _internal--;
+                    } else if (_missed > 0) {
+                        _missed--;  // Counted lost when its gap was seen
+                        arrival->recovered = true;
+                    }
+                }
+            } else {
+                _seen = 1;  // Far behind: resynchronise
+                _dropped = 0;
+            }
+            arrival->sinceLastMs = arrival->nowMs - _lastMs;
+        } else {
+            _started = true;
+            _first = seq;
+            _seen = 1;
+            _dropped = 0;
+        }
+
+        if (advance) {
+            _last = seq;
+            _lastSenderMs = senderMs;
+        }
+        _lastMs = arrival->nowMs;
+        _received++;
+        _missed += arrival->missed;
+        _internal += arrival->internal;
+        return true;
+    }
+
+    // Zero the counters but keep following the stream
+    void resetCounters() {
+        _received = 0;
+        _missed = 0;
+        _internal = 0;
+        _corrupt = 0;
+        _restarts = 0;
+        _late = 0;
+    }
+
+    // Forget the stream too - the next message is a first one
+    void reset() {
+        resetCounters();
+        _started = false;
+        _first = 0;
+        _last = 0;
+        _lastMs = 0;
+        _lastSenderMs = 0;
+        _seen = 0;
+        _dropped = 0;
+    }
+
+    bool started() const { return _started; }
+    Sequence firstSequence() const { return _first; }
+    Sequence lastSequence() const { return _last; }  // Highest seen
+    uint32_t lastArrivalMs() const { return _lastMs; }
+
+    uint32_t received() const { return _received; }
+    uint32_t missed() const { return _missed; }
+    uint32_t internalDrops() const { return _internal; }
+    uint32_t corrupt() const { return _corrupt; }
+    uint32_t restarts() const { return _restarts; }
+    uint32_t late() const { return _late; }  // Arrived after a later one; not counted missed
+
+    // A late (reordered) message is only slightly older than the one
+    // before it; a sender clock this far back means the sender rebooted
+    static constexpr uint32_t RESTART_MS = 1000;
+
+    // Sequences behind the highest one that a late message is matched
+    // against (one bit each)
+    static constexpr uint32_t LATE_WINDOW = 64;
+
+private:
+    static constexpr Sequence HALF_RANGE = (Sequence)((Sequence)1 << (sizeof(Sequence) * 8 - 1));
+
+    bool _started = false;
+    Sequence _first = 0;
+    Sequence _last = 0;
+    uint32_t _lastMs = 0;
+    uint32_t _lastSenderMs = 0;
+    uint64_t _seen = 0;     // Bit i: sequence _last - i arrived
+    uint64_t _dropped = 0;  // Bit i: sequence _last - i counted as an internal drop
+
+    uint32_t _received = 0;
+    uint32_t _missed = 0;
+    uint32_t _internal = 0;
+    uint32_t _corrupt = 0;
+    uint32_t _restarts = 0;
+    uint32_t _late = 0;
+};
+
+#endif
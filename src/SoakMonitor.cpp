@@ -0,0 +1,319 @@
+// ============================================================
+//            SOAK MONITOR (open-ended test mode)
+// ============================================================
+
+#include "SoakMonitor.h"
+#include "modules/fixed_stats.h"
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+// One bucket covers one second (or one minute). The tag holds the
+// window index + 1 so stale buckets are recognised (0 = unused).
+struct SoakBucket {
+    uint32_t tag;
+    uint32_t received;
+    uint32_t missed;
+    uint32_t lossEvents;
+    uint32_t maxGapMs;
+};
+
+static SoakBucket _seconds[SOAK_SECOND_SLOTS];
+static SoakBucket _minutes[SOAK_MINUTE_SLOTS];
+
+// Current window indices - written by loop, read by receive path
+static volatile uint32_t _currentSecond = 0;
+static volatile uint32_t _currentMinute = 0;
+
+static bool _active = false;
+static uint64_t _elapsedMs = 0;
+static unsigned long _lastUpdateTime = 0;
+static uint32_t _hoursReported = 0;
+
+// Lifetime summary across all completed hours
+static uint32_t _lossyHours = 0;
+static uint32_t _worstHour = 0;
+static uint32_t _worstHourRatePpm = 1000000;  // Success rate in ppm
+static uint32_t _longestGapMs = 0;
+static uint32_t _longestGapHour = 0;
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static void clearBucket(SoakBucket* bucket, uint32_t index) {
+    bucket->received = 0;
+    bucket->missed = 0;
+    bucket->lossEvents = 0;
+    bucket->maxGapMs = 0;
+    bucket->tag = index + 1;
+}
+
+// Move a bucket ring forward to target, clearing each new bucket
+// before it is published to the receive path
+static void advanceRing(SoakBucket* ring, uint32_t slots,
+                        volatile uint32_t* current, uint32_t target) {
+    if (target - *current > slots) {
+        *current = target - slots;
+    }
+    while (*current != target) {
+        uint32_t next = *current + 1;
+        clearBucket(&ring[next % slots], next);
+        *current = next;
+    }
+}
+
+// Sum buckets [first, last] (inclusive), skipping missing ones
+static void sumWindow(const SoakBucket* ring, uint32_t slots,
+                      uint32_t first, uint32_t last, SoakWindowStats* out) {
+    memset(out, 0, sizeof(*out));
+    for (uint32_t i = first; i <= last; i++) {
+        const SoakBucket* b = &ring[i % slots];
+        if (b->tag != i + 1) continue;
+        out->received += b->received;
+        out->missed += b->missed;
+        out->lossEvents += b->lossEvents;
+        if (b->maxGapMs > out->maxGapMs) out->maxGapMs = b->maxGapMs;
+        if (b->missed > 0) out->lossyBuckets++;
+    }
+}
+
+// Integer ppm so records match bit for bit between device and host
+static uint32_t successRatePpm(uint32_t received, uint32_t missed) {
+    return statsRatioPpm(received, (uint64_t)received + missed);
+}
+
+static void formatElapsed(uint64_t ms, char* buffer, size_t bufferSize) {
+    unsigned long totalSecs = (unsigned long)(ms / 1000);
+    unsigned long days = totalSecs / 86400;
+    unsigned long hours = (totalSecs % 86400) / 3600;
+    unsigned long mins = (totalSecs % 3600) / 60;
+    unsigned long secs = totalSecs % 60;
+    snprintf(buffer, bufferSize, "%lud %02lu:%02lu:%02lu", days, hours, mins, secs);
+}
+
+static void printBoxLine(const char* text) {
+    Serial.printf("║  %-54s║\n", text);
+}
+
+// Emit the one-line record for a completed hour
+static void emitHourSummary(uint32_t hour) {
+    uint32_t firstMinute = hour * 60;
+    SoakWindowStats stats;
+    sumWindow(_minutes, SOAK_MINUTE_SLOTS, firstMinute, firstMinute + 59, &stats);
+
+    // Worst single minute within the hour
+    uint32_t worstMinutePpm = 1000000;
+    for (uint32_t i = firstMinute; i < firstMinute + 60; i++) {
+        const SoakBucket* b = &_minutes[i % SOAK_MINUTE_SLOTS];
+        if (b->tag != i + 1) continue;
+        uint32_t rate = successRatePpm(b->received, b->missed);
+        if (rate < worstMinutePpm) worstMinutePpm = rate;
+    }
+
+    uint32_t ratePpm = successRatePpm(stats.received, stats.missed);
+
+    if (stats.missed > 0 || stats.lossEvents > 0) _lossyHours++;
+    if (ratePpm < _worstHourRatePpm) {
+        _worstHourRatePpm = ratePpm;
+        _worstHour = hour;
+    }
+    if (stats.maxGapMs > _longestGapMs) {
+        _longestGapMs = stats.maxGapMs;
+        _longestGapHour = hour;
+    }
+
+    char worstStr[16];
+    char rateStr[16];
+    statsFormatPercent(worstMinutePpm, worstStr, sizeof(worstStr));
+    statsFormatPercent(ratePpm, rateStr, sizeof(rateStr));
+    // Longer than Serial.printf()'s 63-byte stack buffer, so format it
+    // here rather than let the print malloc every hour
+    char line[192];
+    int len = snprintf(line, sizeof(line),
+                       "[SOAK] hour=%lu rx=%lu missed=%lu loss_events=%lu max_gap_ms=%lu "
+                       "lossy_minutes=%lu worst_minute=%s success=%s\n",
+                       (unsigned long)hour, (unsigned long)stats.received,
+                       (unsigned long)stats.missed, (unsigned long)stats.lossEvents,
+                       (unsigned long)stats.maxGapMs, (unsigned long)stats.lossyBuckets,
+                       worstStr, rateStr);
+    if (len >= (int)sizeof(line)) len = sizeof(line) - 1;
+    Serial.write((const uint8_t*)line, len);
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void soakMonitorStart(unsigned long now) {
+    memset(_seconds, 0, sizeof(_seconds));
+    memset(_minutes, 0, sizeof(_minutes));
+    clearBucket(&_seconds[0], 0);
+    clearBucket(&_minutes[0], 0);
+    _currentSecond = 0;
+    _currentMinute = 0;
+    _elapsedMs = 0;
+    _lastUpdateTime = now;
+    _hoursReported = 0;
+    _lossyHours = 0;
+    _worstHour = 0;
+    _worstHourRatePpm = 1000000;
+    _longestGapMs = 0;
+    _longestGapHour = 0;
+    _active = true;
+}
+
+void soakMonitorStop() {
+    _active = false;
+}
+
+bool soakMonitorIsActive() {
+    return _active;
+}
+
+void IRAM_ATTR soakMonitorRecordPing(uint32_t missed, unsigned long gapMs) {
+    if (!_active) return;
+
+    SoakBucket* sec = &_seconds[_currentSecond % SOAK_SECOND_SLOTS];
+    SoakBucket* min = &_minutes[_currentMinute % SOAK_MINUTE_SLOTS];
+
+    sec->received++;
+    sec->missed += missed;
+    if (gapMs > sec->maxGapMs) sec->maxGapMs = gapMs;
+
+    min->received++;
+    min->missed += missed;
+    if (gapMs > min->maxGapMs) min->maxGapMs = gapMs;
+}
+
+void soakMonitorRecordSignalLoss() {
+    if (!_active) return;
+
+    _seconds[_currentSecond % SOAK_SECOND_SLOTS].lossEvents++;
+    _minutes[_currentMinute % SOAK_MINUTE_SLOTS].lossEvents++;
+}
+
+void soakMonitorUpdate(unsigned long now) {
+    if (!_active) return;
+
+    _elapsedMs += (unsigned long)(now - _lastUpdateTime);
+    _lastUpdateTime = now;
+
+    uint32_t second = (uint32_t)(_elapsedMs / 1000);
+    if (second == _currentSecond) return;
+
+    advanceRing(_seconds, SOAK_SECOND_SLOTS, &_currentSecond, second);
+    advanceRing(_minutes, SOAK_MINUTE_SLOTS, &_currentMinute, second / 60);
+
+    // Emit a record for every hour that has fully elapsed
+    uint32_t hour = _currentMinute / 60;
+    while (_hoursReported < hour) {
+        emitHourSummary(_hoursReported);
+        _hoursReported++;
+    }
+}
+
+void soakMonitorGetMinute(SoakWindowStats* out) {
+    uint32_t last = _currentSecond;
+    uint32_t first = (last >= 59) ? last - 59 : 0;
+    sumWindow(_seconds, SOAK_SECOND_SLOTS, first, last, out);
+}
+
+void soakMonitorGetHour(SoakWindowStats* out) {
+    uint32_t last = _currentMinute;
+    uint32_t first = (last >= 59) ? last - 59 : 0;
+    sumWindow(_minutes, SOAK_MINUTE_SLOTS, first, last, out);
+}
+
+uint64_t soakMonitorElapsedMs() {
+    return _elapsedMs;
+}
+
+void soakMonitorPrintStats() {
+    char elapsedStr[24];
+    char line[64];
+    char rateStr[16];
+    SoakWindowStats minute;
+    SoakWindowStats hour;
+
+    formatElapsed(_elapsedMs, elapsedStr, sizeof(elapsedStr));
+    soakMonitorGetMinute(&minute);
+    soakMonitorGetHour(&hour);
+
+    Serial.println();
+    Serial.println("╔════════════════════════════════════════════════════════╗");
+    Serial.println("║              SOAK MONITOR                              ║");
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "Soak elapsed:       %s%s", elapsedStr, _active ? "" : " (stopped)");
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "Hours completed:    %lu", (unsigned long)_hoursReported);
+    printBoxLine(line);
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    statsFormatPercent(successRatePpm(minute.received, minute.missed), rateStr, sizeof(rateStr));
+    snprintf(line, sizeof(line), "Last minute:        rx %lu, missed %lu (%s)",
+             (unsigned long)minute.received, (unsigned long)minute.missed, rateStr);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Max gap:          %lu ms", (unsigned long)minute.maxGapMs);
+    printBoxLine(line);
+    statsFormatPercent(successRatePpm(hour.received, hour.missed), rateStr, sizeof(rateStr));
+    snprintf(line, sizeof(line), "Last hour:          rx %lu, missed %lu (%s)",
+             (unsigned long)hour.received, (unsigned long)hour.missed, rateStr);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Loss events:      %lu", (unsigned long)hour.lossEvents);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Max gap:          %lu ms", (unsigned long)hour.maxGapMs);
+    printBoxLine(line);
+    snprintf(line, sizeof(line), "  Lossy minutes:    %lu", (unsigned long)hour.lossyBuckets);
+    printBoxLine(line);
+
+    if (_hoursReported > 0) {
+        Serial.println("╠════════════════════════════════════════════════════════╣");
+        snprintf(line, sizeof(line), "Hours with loss:    %lu of %lu",
+                 (unsigned long)_lossyHours, (unsigned long)_hoursReported);
+        printBoxLine(line);
+        statsFormatPercent(_worstHourRatePpm, rateStr, sizeof(rateStr));
+        snprintf(line, sizeof(line), "Worst hour:         #%lu (%s)",
+                 (unsigned long)_worstHour, rateStr);
+        printBoxLine(line);
+        snprintf(line, sizeof(line), "Longest gap:        %lu ms (hour #%lu)",
+                 (unsigned long)_longestGapMs, (unsigned long)_longestGapHour);
+        printBoxLine(line);
+    }
+
+    Serial.println("╚════════════════════════════════════════════════════════╝");
+    Serial.println();
+}
+
+static void writeWindow(ReportWriter* writer, const char* key, const SoakWindowStats* window) {
+    reportObjectBegin(writer, key);
+    reportUint(writer, "received", window->received);
+    reportUint(writer, "missed", window->missed);
+    reportUint(writer, "success_ppm", successRatePpm(window->received, window->missed));
+    reportUint(writer, "loss_events", window->lossEvents);
+    reportUint(writer, "max_gap_ms", window->maxGapMs);
+    reportUint(writer, "lossy_buckets", window->lossyBuckets);
+    reportObjectEnd(writer);
+}
+
+void soakMonitorWriteReport(ReportWriter* writer) {
+    SoakWindowStats minute;
+    SoakWindowStats hour;
+    soakMonitorGetMinute(&minute);
+    soakMonitorGetHour(&hour);
+
+    reportObjectBegin(writer, "soak");
+    reportBool(writer, "active", _active);
+    reportUint(writer, "elapsed_ms", _elapsedMs);
+    reportUint(writer, "hours_completed", _hoursReported);
+    writeWindow(writer, "last_minute", &minute);
+    writeWindow(writer, "last_hour", &hour);
+    reportUint(writer, "lossy_hours", _lossyHours);
+    if (_hoursReported > 0) {
+        reportUint(writer, "worst_hour", _worstHour);
+        reportUint(writer, "worst_hour_success_ppm", _worstHourRatePpm);
+        reportUint(writer, "longest_gap_ms", _longestGapMs);
+        reportUint(writer, "longest_gap_hour", _longestGapHour);
+    }
+    reportObjectEnd(writer);
+}
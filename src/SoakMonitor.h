@@ -0,0 +1,73 @@
+// ============================================================
+//            SOAK MONITOR (open-ended test mode)
+// ============================================================
+//
+// Keeps rolling statistics for long unattended runs:
+// - 1-minute window built from 1-second buckets
+// - 1-hour window built from 1-minute buckets
+// - One summary record per completed hour on Serial
+//
+// All state is fixed-size, so a soak can run for weeks.
+// Hourly records are single lines prefixed with [SOAK] so they
+// can be grepped out of a captured log:
+//
+//   [SOAK] hour=12 rx=359998 missed=2 loss_events=1 ...
+//
+// Time is tracked as a 64-bit elapsed counter advanced from the
+// main loop, so millis() wrap-around (49.7 days) is harmless.
+//
+// ============================================================
+
+#ifndef SOAKMONITOR_H
+#define SOAKMONITOR_H
+
+#include <Arduino.h>
+#include "ReportWriter.h"
+
+// Bucket ring sizes - a few spare slots beyond 60 so the loop can
+// read a completed minute/hour while the receive path moves on
+#define SOAK_SECOND_SLOTS 64
+#define SOAK_MINUTE_SLOTS 64
+
+// Aggregated counters for a rolling window
+struct SoakWindowStats {
+    uint32_t received;
+    uint32_t missed;
+    uint32_t lossEvents;
+    uint32_t maxGapMs;      // Longest silence between two pings
+    uint32_t lossyBuckets;  // Buckets (seconds or minutes) with any missed packet
+};
+
+// Start (or restart) soak tracking - clears all windows
+void soakMonitorStart(unsigned long now);
+
+// Stop soak tracking (windows are kept for display)
+void soakMonitorStop();
+
+// True while soak tracking is active
+bool soakMonitorIsActive();
+
+// Call from the receive path for every accepted ping
+// missed: sequence gap before this ping, gapMs: time since previous ping
+void soakMonitorRecordPing(uint32_t missed, unsigned long gapMs);
+
+// Call when a signal loss event is raised
+void soakMonitorRecordSignalLoss();
+
+// Call from loop - advances the windows and emits hourly summaries
+void soakMonitorUpdate(unsigned long now);
+
+// Rolling window accessors
+void soakMonitorGetMinute(SoakWindowStats* out);
+void soakMonitorGetHour(SoakWindowStats* out);
+
+// Elapsed soak time in milliseconds (does not wrap)
+uint64_t soakMonitorElapsedMs();
+
+// Print rolling windows and lifetime soak summary
+void soakMonitorPrintStats();
+
+// Write the same as a "soak" object (see ReportWriter.h)
+void soakMonitorWriteReport(ReportWriter* writer);
+
+#endif
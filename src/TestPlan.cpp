@@ -0,0 +1,669 @@
+// ============================================================
+//            SCRIPTED TEST PLAN
+// ============================================================
+
+#include "TestPlan.h"
+#include "DiagnosticReceiver.h"
+#include "CapacityTest.h"
+#include "TrafficGenerator.h"
+#include "ReportWriter.h"
+#include "config.h"
+#include "modules/fixed_stats.h"
+#include <Preferences.h>
+
+#if USE_ESPNOW
+  #include "modules/espnow_module.h"
+#endif
+
+#define PLAN_NVS_NAMESPACE "testplan"
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+enum PlanStepKind : uint8_t {
+    STEP_AIR,     // Real transmitters
+    STEP_INJECT   // Synthetic pings through the receive ring
+};
+
+struct PlanStep {
+    PlanStepKind kind;
+    uint8_t channel;    // 0 = leave the radio where it is
+    uint8_t macs;       // inject: interleaved transmitters
+    uint16_t lossBp;    // inject: i.i.d. loss
+    uint16_t burstBp;   // inject: Gilbert-Elliott burst entry per ping
+    uint32_t slots;     // air: ping slots, inject: pings (0 = no limit)
+    uint32_t seconds;   // 0 = no limit
+    uint32_t pps;       // inject: pings sent per second, lost ones included
+};
+
+struct PlanResult {
+    uint8_t channel;         // Channel the step ran on (0 = unknown)
+    uint32_t durationMs;     // Step start to its end condition
+    uint32_t injected;       // inject: frames offered to the ring
+    uint32_t received;
+    uint32_t missed;         // RF loss as the receiver counted it
+    uint32_t internalDrops;
+    uint32_t truthLost;      // inject: pings the generator dropped
+    uint8_t countedMacs;     // Transmitters received/missed cover (1 = the locked one)
+    uint32_t ringDrops;
+    uint32_t lossEvents;
+};
+
+// One transmitter's statistics for a step (a TransmitterEntry is
+// 312 bytes; this keeps only what the report writes)
+struct PlanLink {
+    uint8_t mac[6];
+    uint32_t frames;
+    uint32_t missed;
+    WelfordStats lossRuns;
+    WelfordStats interArrival;
+    WelfordStats rssi;
+};
+
+enum PlanPhase {
+    PLAN_IDLE,
+    PLAN_AUTORUN,   // Waiting out PLAN_AUTORUN_DELAY_MS after boot
+    PLAN_RUN,       // Current step running
+    PLAN_SETTLE     // Letting the ring drain before recording the step
+};
+
+static PlanStep _steps[PLAN_MAX_STEPS];
+static PlanResult _results[PLAN_MAX_STEPS];
+static PlanLink _links[PLAN_MAX_STEPS][PLAN_REPORT_TRANSMITTERS];
+static uint8_t _linkCount[PLAN_MAX_STEPS];
+static uint8_t _stepCount = 0;
+static bool _autorun = false;
+
+static PlanPhase _phase = PLAN_IDLE;
+static uint8_t _current = 0;
+static unsigned long _phaseStartMs = 0;
+static bool _soakWasOn = false;
+static uint8_t _channelBefore = 0;
+static uint32_t _droppedBefore = 0;
+
+// inject steps - generator paced from the loop
+static TrafficGenerator _gen;
+static unsigned long _injectStartUs = 0;
+static uint32_t _injected = 0;
+static bool _generatorDone = false;
+
+// Line editor
+static bool _editing = false;
+static char _line[PLAN_LINE_MAX];
+static uint8_t _lineLen = 0;
+static bool _lineTooLong = false;
+
+// Whole plan as text, one step per line (NVS blob)
+static char _text[PLAN_MAX_STEPS * PLAN_LINE_MAX];
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+static void printBoxLine(const char* text) {
+    Serial.printf("║  %-54s║\n", text);
+}
+
+static void appendKey(char* buffer, size_t size, int* len, const char* key, uint32_t value) {
+    if (*len < 0 || (size_t)*len >= size) return;
+    *len += snprintf(buffer + *len, size - *len, " %s=%lu", key, (unsigned long)value);
+}
+
+// Canonical text of a step, as typed in the editor
+static void formatStep(const PlanStep* step, char* buffer, size_t size) {
+    int len = snprintf(buffer, size, "%s", (step->kind == STEP_AIR) ? "air" : "inject");
+    if (step->channel != 0) appendKey(buffer, size, &len, "ch", step->channel);
+    if (step->slots != 0) appendKey(buffer, size, &len, "n", step->slots);
+    if (step->seconds != 0) appendKey(buffer, size, &len, "t", step->seconds);
+    if (step->kind == STEP_INJECT) {
+        appendKey(buffer, size, &len, "pps", step->pps);
+        if (step->lossBp != 0) appendKey(buffer, size, &len, "loss", step->lossBp);
+        if (step->burstBp != 0) appendKey(buffer, size, &len, "burst", step->burstBp);
+        if (step->macs > 1) appendKey(buffer, size, &len, "macs", step->macs);
+    }
+}
+
+// Short label for the results table
+static void formatLabel(const PlanStep* step, char* buffer, size_t size) {
+    if (step->kind == STEP_AIR) {
+        snprintf(buffer, size, "air");
+        return;
+    }
+    int len = snprintf(buffer, size, "inj %lu/s", (unsigned long)step->pps);
+    if (step->lossBp != 0 && len < (int)size) {
+        len += snprintf(buffer + len, size - len, " l%u", (unsigned)step->lossBp);
+    }
+    if (step->burstBp != 0 && len < (int)size) {
+        len += snprintf(buffer + len, size - len, " b%u", (unsigned)step->burstBp);
+    }
+    if (step->macs > 1 && len < (int)size) {
+        snprintf(buffer + len, size - len, " x%u", (unsigned)step->macs);
+    }
+}
+
+// Parse one step line. Returns nullptr on success, else what is wrong.
+static const char* parseStep(const char* text, PlanStep* step) {
+    char buffer[PLAN_LINE_MAX];
+    snprintf(buffer, sizeof(buffer), "%s", text);
+
+    char* save = nullptr;
+    char* token = strtok_r(buffer, " \t", &save);
+    if (token == nullptr) return "empty step";
+
+    memset(step, 0, sizeof(*step));
+    if (strcasecmp(token, "air") == 0) {
+        step->kind = STEP_AIR;
+    } else if (strcasecmp(token, "inject") == 0) {
+        step->kind = STEP_INJECT;
+    } else {
+        return "a step starts with air or inject";
+    }
+    step->macs = 1;
+    step->pps = PLAN_INJECT_PPS;
+
+    while ((token = strtok_r(nullptr, " \t", &save)) != nullptr) {
+        char* equals = strchr(token, '=');
+        if (equals == nullptr || equals[1] == '\0') return "expected key=value";
+        *equals = '\0';
+        char* end;
+        unsigned long value = strtoul(equals + 1, &end, 10);
+        if (*end != '\0') return "values are whole numbers";
+
+        if (strcasecmp(token, "ch") == 0) {
+            if (value < 1 || value > 13) return "ch must be 1-13";
+            step->channel = (uint8_t)value;
+        } else if (strcasecmp(token, "n") == 0) {
+            step->slots = value;
+        } else if (strcasecmp(token, "t") == 0) {
+            if (value > PLAN_STEP_MAX_MS / 1000) return "t is beyond PLAN_STEP_MAX_MS";
+            step->seconds = value;
+        } else if (step->kind == STEP_AIR) {
+            return "unknown key for an air step";
+        } else if (strcasecmp(token, "pps") == 0) {
+            if (value < 1 || value > 100000) return "pps must be 1-100000";
+            step->pps = value;
+        } else if (strcasecmp(token, "loss") == 0) {
+            if (value > 10000) return "loss must be 0-10000 bp";
+            step->lossBp = (uint16_t)value;
+        } else if (strcasecmp(token, "burst") == 0) {
+            if (value > 10000) return "burst must be 0-10000 bp";
+            step->burstBp = (uint16_t)value;
+        } else if (strcasecmp(token, "macs") == 0) {
+            if (value < 1 || value > TRAFFIC_MAX_MACS) return "macs must be 1-8";
+            step->macs = (uint8_t)value;
+        } else {
+            return "unknown key";
+        }
+    }
+
+    if (step->slots == 0 && step->seconds == 0) {
+        if (step->kind == STEP_AIR) return "an air step needs n= or t=";
+        step->slots = PLAN_INJECT_PINGS;
+    }
+    return nullptr;
+}
+
+static void listSteps() {
+    char text[PLAN_LINE_MAX];
+    if (_stepCount == 0) {
+        Serial.println("[PLAN] No steps");
+        return;
+    }
+    for (int i = 0; i < _stepCount; i++) {
+        formatStep(&_steps[i], text, sizeof(text));
+        Serial.printf("[PLAN] %2d: %s\n", i + 1, text);
+    }
+    Serial.printf("[PLAN] Autorun %s\n", _autorun ? "on" : "off");
+}
+
+// ============================================================
+//                    NVS
+// ============================================================
+
+static void savePlan() {
+    Preferences prefs;
+    if (!prefs.begin(PLAN_NVS_NAMESPACE, false)) {
+        Serial.println("[PLAN] Failed to open NVS namespace");
+        return;
+    }
+
+    size_t len = 0;
+    _text[0] = '\0';
+    for (int i = 0; i < _stepCount; i++) {
+        formatStep(&_steps[i], _text + len, sizeof(_text) - len - 1);
+        len += strlen(_text + len);
+        _text[len++] = '\n';
+        _text[len] = '\0';
+    }
+    prefs.putBytes("steps", _text, len + 1);
+    prefs.putUInt("auto", _autorun ? 1 : 0);
+    prefs.end();
+    Serial.printf("[PLAN] Saved %d steps (%u bytes)\n", _stepCount, (unsigned)(len + 1));
+}
+
+static void loadPlan() {
+    Preferences prefs;
+    _stepCount = 0;
+    if (!prefs.begin(PLAN_NVS_NAMESPACE, true)) return;  // Nothing saved yet
+
+    size_t len = prefs.getBytes("steps", _text, sizeof(_text));
+    _autorun = prefs.getUInt("auto", 0) != 0;
+    prefs.end();
+    if (len == 0) return;
+    _text[len - 1] = '\0';
+
+    char* save = nullptr;
+    for (char* line = strtok_r(_text, "\n", &save); line != nullptr; line = strtok_r(nullptr, "\n", &save)) {
+        if (_stepCount >= PLAN_MAX_STEPS) break;
+        const char* error = parseStep(line, &_steps[_stepCount]);
+        if (error != nullptr) {
+            Serial.printf("[PLAN] Saved step skipped (%s): %s\n", error, line);
+            continue;
+        }
+        _stepCount++;
+    }
+}
+
+// ============================================================
+//                    STEPS
+// ============================================================
+
+#if USE_ESPNOW
+static void beginStep() {
+    const PlanStep* step = &_steps[_current];
+    PlanResult* result = &_results[_current];
+    char text[PLAN_LINE_MAX];
+    memset(result, 0, sizeof(*result));
+    _linkCount[_current] = 0;
+
+    if (step->channel != 0 && !espnowSetChannel(step->channel)) {
+        Serial.printf("[PLAN] Cannot move to channel %d (WiFi connected?) - staying\n", step->channel);
+    }
+    result->channel = espnowGetChannel();
+
+    diagnosticReceiverRestartTest();
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+    _droppedBefore = rx.dropped;
+
+    if (step->kind == STEP_INJECT) {
+        TrafficConfig config;
+        trafficGeneratorDefaultConfig(&config);
+        config.macCount = step->macs;
+        config.packetsPerMac = (step->slots > 0)
+            ? (step->slots + step->macs - 1) / step->macs
+            : (uint32_t)(((uint64_t)step->pps * step->seconds) / step->macs);
+        config.intervalMs = ((uint32_t)step->macs * 1000 > step->pps) ? (uint32_t)step->macs * 1000 / step->pps : 1;
+        config.lossBp = step->lossBp;
+        config.burstEnterBp = step->burstBp;
+        config.duplicateBp = 0;
+        config.reorderBp = 0;
+        config.seed = esp_random() | 1;
+        trafficGeneratorInit(&_gen, &config);
+        _injected = 0;
+        _generatorDone = false;
+        _injectStartUs = micros();
+    }
+
+    formatStep(step, text, sizeof(text));
+    Serial.printf("[PLAN] Step %d/%d on channel %d: %s\n", _current + 1, _stepCount, result->channel, text);
+    _phaseStartMs = millis();
+    _phase = PLAN_RUN;
+}
+
+static void recordStep() {
+    const PlanStep* step = &_steps[_current];
+    PlanResult* result = &_results[_current];
+    EspNowRxStats rx;
+    espnowGetRxStats(&rx);
+
+    result->injected = _injected;
+    result->received = diagnosticReceiverGetReceived();
+    result->missed = diagnosticReceiverGetMissed();
+    result->internalDrops = diagnosticReceiverGetInternalDrops();
+    result->ringDrops = rx.dropped - _droppedBefore;
+    result->lossEvents = diagnosticReceiverGetLossEvents();
+    result->truthLost = (step->kind == STEP_INJECT) ? trafficGeneratorGetTruth(&_gen)->lost : 0;
+    result->countedMacs = 1;
+
+    // The ping counters follow the locked transmitter only; a multi-MAC
+    // step is counted over every generator MAC from the transmitter table
+    if (step->kind == STEP_INJECT && step->macs > 1) {
+        result->received = 0;
+        result->missed = 0;
+        result->internalDrops = 0;
+        result->countedMacs = step->macs;
+        for (uint8_t m = 0; m < step->macs; m++) {
+            uint8_t mac[6];
+            TransmitterEntry entry;
+            trafficGeneratorGetMac(m, mac);
+            if (!diagnosticReceiverGetTransmitter(mac, &entry)) continue;
+            result->received += entry.frames;
+            result->missed += entry.missed;
+            result->internalDrops += entry.internal;
+        }
+    }
+
+    TransmitterEntry entries[PLAN_REPORT_TRANSMITTERS];
+    int count = diagnosticReceiverGetTransmitters(entries, PLAN_REPORT_TRANSMITTERS);
+    for (int i = 0; i < count; i++) {
+        PlanLink* link = &_links[_current][i];
+        memcpy(link->mac, entries[i].mac, 6);
+        link->frames = entries[i].frames;
+        link->missed = entries[i].missed;
+        link->lossRuns = entries[i].lossRuns;
+        link->interArrival = entries[i].interArrivalStats;
+        link->rssi = entries[i].rssiStats;
+    }
+    _linkCount[_current] = (uint8_t)count;
+
+    Serial.printf("[PLAN] step=%d ms=%lu macs=%u received=%lu missed=%lu internal=%lu ring_drops=%lu loss_events=%lu",
+                  _current + 1, (unsigned long)result->durationMs, (unsigned)result->countedMacs,
+                  (unsigned long)result->received, (unsigned long)result->missed,
+                  (unsigned long)result->internalDrops, (unsigned long)result->ringDrops,
+                  (unsigned long)result->lossEvents);
+    if (step->kind == STEP_INJECT) {
+        Serial.printf(" truth_lost=%lu", (unsigned long)result->truthLost);
+    }
+    Serial.println();
+}
+
+static void printResults() {
+    char line[64];
+    char label[24];
+    char seconds[12];
+    char loss[16];
+
+    Serial.println();
+    Serial.println("╔════════════════════════════════════════════════════════╗");
+    Serial.println("║              TEST PLAN RESULTS                         ║");
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    snprintf(line, sizeof(line), "%-2s %-19s %2s %6s %7s %7s %5s",
+             "#", "Step", "Ch", "Secs", "Recv", "Loss", "Drops");
+    printBoxLine(line);
+    for (int i = 0; i < _stepCount; i++) {
+        const PlanResult* result = &_results[i];
+        uint64_t slots = (uint64_t)result->received + result->missed;
+        formatLabel(&_steps[i], label, sizeof(label));
+        snprintf(seconds, sizeof(seconds), "%lu.%lu", (unsigned long)(result->durationMs / 1000),
+                 (unsigned long)(result->durationMs % 1000 / 100));
+        statsFormatPercent((slots > 0) ? statsRatioPpm(result->missed, slots) : 0, loss, sizeof(loss));
+        snprintf(line, sizeof(line), "%-2d %-19.19s %2u %6s %7lu %7s %5lu",
+                 i + 1, label, (unsigned)result->channel, seconds, (unsigned long)result->received,
+                 loss, (unsigned long)result->ringDrops);
+        printBoxLine(line);
+    }
+    Serial.println("╠════════════════════════════════════════════════════════╣");
+    printBoxLine("Loss = missed / (received + missed)");
+    printBoxLine("Recv/Loss: locked transmitter; xN steps all N MACs");
+    printBoxLine("Drops = frames the receive ring could not take");
+    Serial.println("╚════════════════════════════════════════════════════════╝");
+    Serial.println();
+}
+
+static void writeReport(ReportFormat format) {
+    ReportWriter writer;
+    char text[PLAN_LINE_MAX];
+
+    reportBegin(&writer, &Serial, format);
+    reportString(&writer, "report", "test-plan");
+    reportArrayBegin(&writer, "plan");
+    for (int i = 0; i < _stepCount; i++) {
+        const PlanResult* result = &_results[i];
+        formatStep(&_steps[i], text, sizeof(text));
+        reportObjectBegin(&writer, nullptr);
+        reportString(&writer, "step", text);
+        reportUint(&writer, "channel", result->channel);
+        reportUint(&writer, "duration_ms", result->durationMs);
+        if (_steps[i].kind == STEP_INJECT) reportUint(&writer, "injected", result->injected);
+        reportUint(&writer, "counted_macs", result->countedMacs);
+        reportUint(&writer, "received", result->received);
+        reportUint(&writer, "missed", result->missed);
+        if (_steps[i].kind == STEP_INJECT) reportUint(&writer, "truth_lost", result->truthLost);
+        reportUint(&writer, "internal_drops", result->internalDrops);
+        reportUint(&writer, "ring_drops", result->ringDrops);
+        reportUint(&writer, "loss_events", result->lossEvents);
+        reportArrayBegin(&writer, "transmitters");
+        for (int t = 0; t < _linkCount[i]; t++) {
+            const PlanLink* link = &_links[i][t];
+            snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+                     link->mac[0], link->mac[1], link->mac[2], link->mac[3], link->mac[4], link->mac[5]);
+            reportObjectBegin(&writer, nullptr);
+            reportString(&writer, "mac", text);
+            reportUint(&writer, "frames", link->frames);
+            reportUint(&writer, "missed", link->missed);
+            reportObjectBegin(&writer, "loss_runs");
+            reportMoments(&writer, &link->lossRuns);
+            reportObjectEnd(&writer);
+            reportObjectBegin(&writer, "inter_arrival_ms");
+            reportMoments(&writer, &link->interArrival);
+            reportObjectEnd(&writer);
+            reportObjectBegin(&writer, "rssi_dbm");
+            reportMoments(&writer, &link->rssi);
+            reportObjectEnd(&writer);
+            reportObjectEnd(&writer);
+        }
+        reportArrayEnd(&writer);
+        reportObjectEnd(&writer);
+    }
+    reportArrayEnd(&writer);
+    reportEnd(&writer);
+}
+
+// Hand the receiver and radio back as they were before the plan
+static void restoreReceiver() {
+    _phase = PLAN_IDLE;
+    if (_channelBefore != 0 && espnowGetChannel() != _channelBefore) {
+        espnowSetChannel(_channelBefore);
+    }
+    diagnosticReceiverRestartTest();
+    diagnosticReceiverSetSoakMode(_soakWasOn);
+}
+
+static void finish() {
+    restoreReceiver();
+    printResults();
+    #if PLAN_REPORT
+        writeReport((ReportFormat)PLAN_REPORT);
+    #endif
+}
+
+// Offer the pings that are due at the step rate (no drift from rounding).
+// Paced by pings sent, so lost pings take their slot as over the air.
+static void injectDue(const PlanStep* step) {
+    uint64_t elapsedUs = (unsigned long)(micros() - _injectStartUs);
+    uint64_t due = (elapsedUs * step->pps) / 1000000;
+    const TrafficTruth* truth = trafficGeneratorGetTruth(&_gen);
+
+    for (int i = 0; i < PLAN_BURST_MAX && truth->sent < due; i++) {
+        TrafficFrame frame;
+        if (!trafficGeneratorNext(&_gen, &frame)) {
+            _generatorDone = true;
+            break;
+        }
+        espnowInjectFrame(frame.mac, (const uint8_t*)&frame.ping, sizeof(frame.ping));
+        _injected++;
+    }
+}
+
+static bool stepDone(const PlanStep* step, uint32_t elapsedMs) {
+    if (elapsedMs >= PLAN_STEP_MAX_MS) return true;
+    if (step->seconds > 0 && elapsedMs >= step->seconds * 1000) return true;
+    if (step->kind == STEP_INJECT) return _generatorDone;
+
+    uint32_t slots = diagnosticReceiverGetReceived() + diagnosticReceiverGetMissed() +
+                     diagnosticReceiverGetInternalDrops();
+    return step->slots > 0 && slots >= step->slots;
+}
+#endif
+
+// ============================================================
+//                    EDITOR
+// ============================================================
+
+static void editorCommand(char* line) {
+    // Trim surrounding blanks
+    while (*line == ' ' || *line == '\t') line++;
+    size_t len = strlen(line);
+    while (len > 0 && (line[len - 1] == ' ' || line[len - 1] == '\t')) line[--len] = '\0';
+    if (len == 0) return;
+
+    Serial.printf("[PLAN] > %s\n", line);
+
+    if (strcasecmp(line, "list") == 0) {
+        listSteps();
+    } else if (strcasecmp(line, "undo") == 0) {
+        if (_stepCount > 0) _stepCount--;
+        Serial.printf("[PLAN] %d steps\n", _stepCount);
+    } else if (strcasecmp(line, "clear") == 0) {
+        _stepCount = 0;
+        Serial.println("[PLAN] Cleared");
+    } else if (strcasecmp(line, "save") == 0) {
+        savePlan();
+    } else if (strcasecmp(line, "auto on") == 0 || strcasecmp(line, "auto off") == 0) {
+        _autorun = (strcasecmp(line, "auto on") == 0);
+        savePlan();
+        Serial.printf("[PLAN] Autorun %s\n", _autorun ? "on" : "off");
+    } else if (strcasecmp(line, "done") == 0) {
+        _editing = false;
+        Serial.println("[PLAN] Editor closed - P to reopen");
+    } else if (strcasecmp(line, "run") == 0) {
+        _editing = false;
+        testPlanStart();
+    } else if (_stepCount >= PLAN_MAX_STEPS) {
+        Serial.printf("[PLAN] Plan full (%d steps)\n", PLAN_MAX_STEPS);
+    } else {
+        const char* error = parseStep(line, &_steps[_stepCount]);
+        if (error != nullptr) {
+            Serial.printf("[PLAN] %s\n", error);
+            return;
+        }
+        _stepCount++;
+        Serial.printf("[PLAN] Step %d added\n", _stepCount);
+    }
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void testPlanInit() {
+    loadPlan();
+    if (_stepCount == 0) return;
+
+    Serial.printf("[PLAN] %d saved steps loaded\n", _stepCount);
+    if (_autorun) {
+        Serial.printf("[PLAN] Autorun in %d s - press P to cancel\n", PLAN_AUTORUN_DELAY_MS / 1000);
+        _phaseStartMs = millis();
+        _phase = PLAN_AUTORUN;
+    }
+}
+
+void testPlanStart() {
+#if USE_ESPNOW
+    if (_phase == PLAN_RUN || _phase == PLAN_SETTLE) return;
+    if (_stepCount == 0) {
+        Serial.println("[PLAN] No steps - P opens the editor");
+        _phase = PLAN_IDLE;
+        return;
+    }
+    if (capacityTestIsRunning()) {
+        Serial.println("[PLAN] Capacity test running - X stops it");
+        _phase = PLAN_IDLE;
+        return;
+    }
+
+    // Soak mode keeps the receiver processing past TEST_PACKET_COUNT
+    _soakWasOn = diagnosticReceiverIsSoakMode();
+    diagnosticReceiverSetSoakMode(true);
+    _channelBefore = espnowGetChannel();
+
+    Serial.printf("[PLAN] Running %d steps\n", _stepCount);
+    _current = 0;
+    beginStep();
+#else
+    Serial.println("[PLAN] ESP-NOW disabled");
+#endif
+}
+
+void testPlanStop() {
+    if (_phase == PLAN_AUTORUN) {
+        _phase = PLAN_IDLE;
+        Serial.println("[PLAN] Autorun cancelled");
+        return;
+    }
+#if USE_ESPNOW
+    if (_phase == PLAN_IDLE) return;
+    restoreReceiver();
+    Serial.printf("[PLAN] Aborted during step %d of %d\n", _current + 1, _stepCount);
+#endif
+}
+
+bool testPlanIsRunning() {
+    return _phase != PLAN_IDLE;
+}
+
+void testPlanEdit() {
+    _editing = true;
+    _lineLen = 0;
+    _lineTooLong = false;
+    Serial.println("[PLAN] Editor - one step per line:");
+    Serial.println("[PLAN]   air    [ch=N] [n=SLOTS] [t=SECONDS]");
+    Serial.println("[PLAN]   inject [ch=N] [n=PINGS] [t=SECONDS] [pps=N] [loss=BP] [burst=BP] [macs=N]");
+    Serial.println("[PLAN] Commands: list, undo, clear, save, auto on|off, run, done");
+    listSteps();
+}
+
+bool testPlanIsEditing() {
+    return _editing;
+}
+
+void testPlanInput(char c) {
+    if (c == '\r' || c == '\n') {
+        _line[_lineLen] = '\0';
+        if (_lineTooLong) {
+            Serial.printf("[PLAN] Line longer than %d characters ignored\n", PLAN_LINE_MAX - 1);
+        } else {
+            editorCommand(_line);
+        }
+        _lineLen = 0;
+        _lineTooLong = false;
+    } else if (c == '\b' || c == 0x7F) {
+        if (_lineLen > 0) _lineLen--;
+    } else if (_lineLen < PLAN_LINE_MAX - 1) {
+        _line[_lineLen++] = c;
+    } else {
+        _lineTooLong = true;
+    }
+}
+
+void testPlanUpdate() {
+#if USE_ESPNOW
+    if (_phase == PLAN_AUTORUN) {
+        if (millis() - _phaseStartMs >= PLAN_AUTORUN_DELAY_MS) {
+            _phase = PLAN_IDLE;
+            testPlanStart();
+        }
+    } else if (_phase == PLAN_RUN) {
+        const PlanStep* step = &_steps[_current];
+        if (step->kind == STEP_INJECT && !_generatorDone) injectDue(step);
+
+        uint32_t elapsedMs = millis() - _phaseStartMs;
+        if (stepDone(step, elapsedMs)) {
+            _results[_current].durationMs = elapsedMs;
+            _phaseStartMs = millis();
+            _phase = PLAN_SETTLE;
+        }
+    } else if (_phase == PLAN_SETTLE) {
+        if (millis() - _phaseStartMs >= PLAN_SETTLE_MS) {
+            recordStep();
+            if (++_current < _stepCount) {
+                beginStep();
+            } else {
+                finish();
+            }
+        }
+    }
+#endif
+}
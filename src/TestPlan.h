@@ -0,0 +1,83 @@
+// ============================================================
+//            SCRIPTED TEST PLAN
+// ============================================================
+//
+// Runs a list of test steps back to back and prints one
+// comparison table at the end, so a sweep over channels, rates
+// and impairments needs nobody at the keyboard. Each step
+// - moves the radio to its channel (if given)
+// - restarts the receiver counters, in soak mode so that
+//   TEST_PACKET_COUNT cannot end a step early
+// - runs until its ping-slot count or time limit is reached
+// - drains for PLAN_SETTLE_MS and records received, missed,
+//   internal drops, ring drops and signal-loss events, plus
+//   per-transmitter loss, loss-run, inter-arrival and RSSI
+//   statistics for the busiest PLAN_REPORT_TRANSMITTERS.
+//   received and missed are the locked transmitter's, except for
+//   inject steps with macs > 1, which sum every generator MAC
+//
+// One step per line:
+//
+//   air    [ch=N] [n=SLOTS] [t=SECONDS]
+//     Real transmitters over the air. Ends after n ping slots
+//     (received + missed) or t seconds, whichever comes first.
+//
+//   inject [ch=N] [n=PINGS] [t=SECONDS] [pps=RATE] [loss=BP] [burst=BP] [macs=N]
+//     Synthetic pings (TrafficGenerator) through the receive ring
+//     at pps pings/s, lost ones included. loss is the i.i.d. loss
+//     and burst the chance per ping of entering a Gilbert-Elliott
+//     loss burst, both in basis points (1 bp = 0.01%).
+//
+// Entered over serial with the P command, which opens a line
+// editor: type steps, then "run". "save" keeps the plan in NVS;
+// with "auto on" a saved plan starts PLAN_AUTORUN_DELAY_MS after
+// boot. P while a plan runs aborts it.
+//
+// ============================================================
+
+#ifndef TESTPLAN_H
+#define TESTPLAN_H
+
+#include <Arduino.h>
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define PLAN_MAX_STEPS        16      // Steps per plan
+#define PLAN_LINE_MAX         96      // Longest step or editor line
+#define PLAN_SETTLE_MS        200     // Drain time before a step is recorded
+#define PLAN_STEP_MAX_MS      600000  // Hard limit per step (10 min)
+#define PLAN_BURST_MAX        8       // Max frames injected per loop pass
+#define PLAN_INJECT_PPS       1000    // inject: default rate
+#define PLAN_INJECT_PINGS     1000    // inject: default count when neither n nor t is given
+#define PLAN_AUTORUN_DELAY_MS 5000    // Boot to autorun start (P cancels)
+#define PLAN_REPORT           1       // Structured report after the table: 0 = none, 1 = JSON, 2 = CSV
+#define PLAN_REPORT_TRANSMITTERS 4    // Busiest transmitters kept per step for the report
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Load the saved plan from NVS and arm autorun if enabled
+void testPlanInit();
+
+// Start the loaded plan (switches the receiver to soak mode until done)
+void testPlanStart();
+
+// Abort a running plan, or cancel a pending autorun
+void testPlanStop();
+
+// True while steps run or autorun is pending
+bool testPlanIsRunning();
+
+// Open the line editor (P command). Serial characters then go to
+// testPlanInput() until the editor is closed with "done" or "run".
+void testPlanEdit();
+bool testPlanIsEditing();
+void testPlanInput(char c);
+
+// Call from loop - paces injected pings and advances the steps
+void testPlanUpdate();
+
+#endif
@@ -0,0 +1,165 @@
+// ============================================================
+//            CYCLE-STAMPED TRACE BUFFER
+// ============================================================
+
+#include "Trace.h"
+#include <esp_timer.h>
+
+#if TRACE_ENABLED
+
+// ============================================================
+//                    STATE
+// ============================================================
+
+#define TRACE_CORES 2
+
+struct TraceRecord {
+    uint32_t ccount;  // CCOUNT of the recording core
+    uint32_t arg;     // Event argument
+    uint8_t id;       // TraceEventId
+};
+
+// One ring per core. Tasks and ISRs on the same core reserve slots
+// with an atomic increment, so no lock is needed.
+static DRAM_ATTR TraceRecord _rings[TRACE_CORES][TRACE_RING_SIZE];
+static uint32_t _heads[TRACE_CORES];
+static volatile bool _running = false;
+static unsigned long _lastSync[TRACE_CORES];
+static uint32_t _loopMinCycles = 0;
+
+// Event names and Chrome trace phases, indexed by TraceEventId
+struct TraceEventInfo {
+    const char* name;
+    char phase;
+};
+
+static const TraceEventInfo _eventInfo[TRACE_EVENT_COUNT] = {
+    {"sync",          'i'},  // TRACE_SYNC
+    {"rx_callback",   'B'},  // TRACE_RX_CALLBACK_BEGIN
+    {"rx_callback",   'E'},  // TRACE_RX_CALLBACK_END
+    {"rx_ring_depth", 'C'},  // TRACE_RX_ENQUEUE
+    {"rx_drop",       'i'},  // TRACE_RX_DROP
+    {"rx_ring_depth", 'C'},  // TRACE_RX_DEQUEUE
+    {"rx_dispatch",   'B'},  // TRACE_RX_DISPATCH_BEGIN
+    {"rx_dispatch",   'E'},  // TRACE_RX_DISPATCH_END
+    {"ping",          'i'},  // TRACE_PING
+    {"gap",           'i'},  // TRACE_GAP
+    {"loop",          'B'},  // TRACE_LOOP_BEGIN
+    {"loop",          'E'},  // TRACE_LOOP_END
+    {"log",           'B'},  // TRACE_LOG_BEGIN
+    {"log",           'E'},  // TRACE_LOG_END
+    {"heartbeat",     'B'},  // TRACE_HEARTBEAT_BEGIN
+    {"heartbeat",     'E'},  // TRACE_HEARTBEAT_END
+};
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0,
+              "TRACE_RING_SIZE must be a power of 2");
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void IRAM_ATTR traceRecordAt(uint8_t id, uint32_t ccount, uint32_t arg) {
+    if (!_running) return;
+
+    uint32_t core = xPortGetCoreID();
+    uint32_t index = __atomic_fetch_add(&_heads[core], 1, __ATOMIC_RELAXED);
+    TraceRecord* rec = &_rings[core][index & (TRACE_RING_SIZE - 1)];
+
+    rec->ccount = ccount;
+    rec->arg = arg;
+    rec->id = id;
+}
+
+void IRAM_ATTR traceRecord(uint8_t id, uint32_t arg) {
+    traceRecordAt(id, traceGetCycleCount(), arg);
+}
+
+void traceLoopPass(uint32_t startCcount) {
+    if (!_running) return;
+
+    uint32_t endCcount = traceGetCycleCount();
+    if (endCcount - startCcount < _loopMinCycles) return;
+
+    traceRecordAt(TRACE_LOOP_BEGIN, startCcount, 0);
+    traceRecordAt(TRACE_LOOP_END, endCcount, 0);
+}
+
+void traceSyncTick() {
+    if (!_running) return;
+
+    uint32_t core = xPortGetCoreID();
+    unsigned long now = millis();
+    if (now - _lastSync[core] < TRACE_SYNC_INTERVAL_MS) return;
+    _lastSync[core] = now;
+
+    // Sample both clocks back to back
+    uint32_t ccount = traceGetCycleCount();
+    uint32_t timerUs = (uint32_t)esp_timer_get_time();
+    traceRecordAt(TRACE_SYNC, ccount, timerUs);
+}
+
+void traceStart() {
+    _running = false;
+
+    _loopMinCycles = getCpuFrequencyMhz() * TRACE_LOOP_MIN_US;
+    unsigned long now = millis();
+    for (int core = 0; core < TRACE_CORES; core++) {
+        __atomic_store_n(&_heads[core], 0, __ATOMIC_RELAXED);
+        _lastSync[core] = now - TRACE_SYNC_INTERVAL_MS;  // Sync on first tick
+    }
+
+    _running = true;
+    traceSyncTick();
+}
+
+void traceStop() {
+    _running = false;
+}
+
+bool traceIsRunning() {
+    return _running;
+}
+
+void traceDump() {
+    // Rings are only consistent once recording has stopped
+    traceStop();
+
+    Serial.println();
+    Serial.printf("[TRACE] BEGIN cpu_mhz=%lu cores=%d ring=%d\n",
+                  (unsigned long)getCpuFrequencyMhz(), TRACE_CORES, TRACE_RING_SIZE);
+
+    for (int id = 0; id < TRACE_EVENT_COUNT; id++) {
+        Serial.printf("[TRACE] NAME %d %c %s\n", id, _eventInfo[id].phase, _eventInfo[id].name);
+    }
+
+    for (int core = 0; core < TRACE_CORES; core++) {
+        uint32_t head = __atomic_load_n(&_heads[core], __ATOMIC_RELAXED);
+        uint32_t count = (head < TRACE_RING_SIZE) ? head : TRACE_RING_SIZE;
+
+        // Oldest first
+        for (uint32_t i = head - count; i != head; i++) {
+            const TraceRecord* rec = &_rings[core][i & (TRACE_RING_SIZE - 1)];
+            Serial.printf("[TRACE] EV %d %u %lu %lu\n", core, rec->id,
+                          (unsigned long)rec->ccount, (unsigned long)rec->arg);
+        }
+    }
+
+    Serial.println("[TRACE] END");
+    Serial.println();
+}
+
+#else
+
+void traceRecord(uint8_t id, uint32_t arg) {}
+void traceRecordAt(uint8_t id, uint32_t ccount, uint32_t arg) {}
+void traceLoopPass(uint32_t startCcount) {}
+void traceSyncTick() {}
+void traceStart() {}
+void traceStop() {}
+bool traceIsRunning() { return false; }
+void traceDump() {
+    Serial.println("[TRACE] Disabled (TRACE_ENABLED 0)");
+}
+
+#endif
@@ -0,0 +1,116 @@
+// ============================================================
+//            CYCLE-STAMPED TRACE BUFFER
+// ============================================================
+//
+// Low-overhead event tracing for the receive pipeline:
+// - TRACE_EVENT(id, arg) records (event id, CCOUNT, arg)
+// - One lock-free ring per core, oldest records overwritten
+// - Recording is armed/stopped at runtime (T serial command)
+// - Stopping dumps the rings as [TRACE] text lines
+//
+// Convert a captured dump to Chrome/Perfetto JSON on the host:
+//   tools/trace2chrome log.txt > trace.json
+// then open it in chrome://tracing or ui.perfetto.dev.
+//
+// CCOUNT runs per core and is not synchronised between cores.
+// TRACE_SYNC events pair CCOUNT with esp_timer time on each core
+// so the host tool can put both cores on one timeline.
+//
+// ============================================================
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <Arduino.h>
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define TRACE_ENABLED          1     // 1 = Compile trace points in
+#define TRACE_RING_SIZE        1024  // Records per core (power of 2, 12 bytes each)
+#define TRACE_SYNC_INTERVAL_MS 1000  // CCOUNT/esp_timer sync event period per core
+#define TRACE_LOOP_MIN_US      20    // Loop passes shorter than this are not traced
+
+// ============================================================
+//                    EVENT IDS
+// ============================================================
+// Names and phases (B = begin, E = end, i = instant, C = counter)
+// are emitted with every dump, so the host tool needs no table.
+
+enum TraceEventId : uint8_t {
+    TRACE_SYNC = 0,             // i  arg = esp_timer_get_time() low 32 bits
+    TRACE_RX_CALLBACK_BEGIN,    // B  WiFi task receive callback, arg = len
+    TRACE_RX_CALLBACK_END,      // E
+    TRACE_RX_ENQUEUE,           // C  arg = ring depth after enqueue
+    TRACE_RX_DROP,              // i  ring full, arg = depth
+    TRACE_RX_DEQUEUE,           // C  arg = ring depth before dequeue
+    TRACE_RX_DISPATCH_BEGIN,    // B  receive callback in ESP-NOW task, arg = len
+    TRACE_RX_DISPATCH_END,      // E
+    TRACE_PING,                 // i  accepted ping, arg = sequence number
+    TRACE_GAP,                  // i  sequence gap, arg = missed packets
+    TRACE_LOOP_BEGIN,           // B  diagnosticReceiverLoop()
+    TRACE_LOOP_END,             // E
+    TRACE_LOG_BEGIN,            // B  propLog() flush, arg = length
+    TRACE_LOG_END,              // E
+    TRACE_HEARTBEAT_BEGIN,      // B  60-second heartbeat status
+    TRACE_HEARTBEAT_END,        // E
+    TRACE_EVENT_COUNT
+};
+
+// ============================================================
+//                    MACROS
+// ============================================================
+
+#if TRACE_ENABLED
+  #define TRACE_EVENT(id, arg) traceRecord((id), (uint32_t)(arg))
+  #define TRACE_EVENT_AT(id, ccount, arg) traceRecordAt((id), (ccount), (uint32_t)(arg))
+  #define TRACE_CCOUNT() traceGetCycleCount()
+#else
+  #define TRACE_EVENT(id, arg) do {} while (0)
+  #define TRACE_EVENT_AT(id, ccount, arg) do {} while (0)
+  #define TRACE_CCOUNT() 0
+#endif
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Read the cycle counter of the calling core
+static inline uint32_t traceGetCycleCount() {
+#if defined(__XTENSA__)
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#else
+    return (uint32_t)micros();
+#endif
+}
+
+// Record an event on the calling core's ring (no-op unless armed)
+void traceRecord(uint8_t id, uint32_t arg);
+
+// Record an event with an explicit cycle stamp (for deferred begin/end pairs)
+void traceRecordAt(uint8_t id, uint32_t ccount, uint32_t arg);
+
+// Record a TRACE_LOOP_BEGIN/END pair for a loop pass that started at
+// startCcount, skipping idle passes shorter than TRACE_LOOP_MIN_US
+void traceLoopPass(uint32_t startCcount);
+
+// Emit a TRACE_SYNC on the calling core if one is due
+// Call periodically from a task on each core
+void traceSyncTick();
+
+// Clear the rings and start recording
+void traceStart();
+
+// Stop recording (rings are kept for dumping)
+void traceStop();
+
+// True while recording
+bool traceIsRunning();
+
+// Dump both rings as [TRACE] lines
+void traceDump();
+
+#endif
@@ -0,0 +1,205 @@
+// ============================================================
+//            SYNTHETIC TRAFFIC GENERATOR
+// ============================================================
+
+#include "TrafficGenerator.h"
+
+// ============================================================
+//                    HELPER FUNCTIONS
+// ============================================================
+
+// xorshift32 - same generator as the packet reservoir
+static uint32_t nextRandom(TrafficGenerator* gen) {
+    uint32_t x = gen->rngState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    gen->rngState = x;
+    return x;
+}
+
+// Uniform integer in [0, range) without division (Lemire reduction)
+static uint32_t randomBelow(TrafficGenerator* gen, uint32_t range) {
+    return (uint32_t)(((uint64_t)nextRandom(gen) * range) >> 32);
+}
+
+static bool chance(TrafficGenerator* gen, uint16_t bp) {
+    return bp > 0 && randomBelow(gen, 10000) < bp;
+}
+
+// Random transmitter that still has pings to send, -1 when all are done
+static int pickTransmitter(TrafficGenerator* gen) {
+    uint8_t count = gen->config.macCount;
+    uint8_t start = (uint8_t)randomBelow(gen, count);
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t index = (start + i) % count;
+        if (gen->remaining[index] > 0) return index;
+    }
+    return -1;
+}
+
+// Every emitted frame counts as passing each held frame
+static void noteEmitted(TrafficGenerator* gen) {
+    gen->truth.delivered++;
+    for (uint8_t i = 0; i < gen->heldCount; i++) {
+        if (gen->held[i].releaseAfter > 0) gen->held[i].releaseAfter--;
+        if (gen->held[i].passed < 0xFF) gen->held[i].passed++;
+    }
+}
+
+// Remove held frame i (keeps the rest in hold order)
+static void releaseHeld(TrafficGenerator* gen, uint8_t i, TrafficFrame* frame) {
+    *frame = gen->held[i].frame;
+    if (gen->held[i].passed > 0) gen->truth.reordered++;
+
+    for (uint8_t j = i + 1; j < gen->heldCount; j++) {
+        gen->held[j - 1] = gen->held[j];
+    }
+    gen->heldCount--;
+}
+
+// Transmitter sends one ping; returns false if the channel lost it
+static bool transmit(TrafficGenerator* gen, uint8_t index, TrafficFrame* frame) {
+    const TrafficConfig* cfg = &gen->config;
+    TrafficTruth* truth = &gen->truth;
+
+    // Reboot: sequence and uptime start over
+    if (cfg->restartEvery > 0 && gen->sinceRestart[index] >= cfg->restartEvery) {
+        gen->sequence[index] = 0;
+        gen->uptimeMs[index] = 0;
+        gen->sinceRestart[index] = 0;
+        truth->restarts++;
+    }
+
+    trafficGeneratorGetMac(index, frame->mac);
+    frame->ping.magic = PING_MAGIC;
+    frame->ping.sequenceNumber = gen->sequence[index]++;
+    frame->ping.uptimeMs = gen->uptimeMs[index];
+    gen->uptimeMs[index] += cfg->intervalMs;
+    gen->sinceRestart[index]++;
+    gen->remaining[index]--;
+    truth->sent++;
+    truth->sentPerMac[index]++;
+
+    // Gilbert-Elliott channel: loss drawn in the current state,
+    // then the state moves for the next ping
+    bool bad = gen->inBurst[index];
+    bool lost = chance(gen, bad ? cfg->burstLossBp : cfg->lossBp);
+    gen->inBurst[index] = bad ? !chance(gen, cfg->burstExitBp) : chance(gen, cfg->burstEnterBp);
+
+    if (!lost) {
+        gen->lossRun[index] = 0;
+        return true;
+    }
+
+    truth->lost++;
+    truth->lostPerMac[index]++;
+    if (bad) truth->lostInBurst++;
+    if (gen->lossRun[index] == 0) truth->lossRuns++;
+    gen->lossRun[index]++;
+    if (gen->lossRun[index] > truth->longestLossRun) {
+        truth->longestLossRun = gen->lossRun[index];
+    }
+    return false;
+}
+
+// ============================================================
+//                    PUBLIC FUNCTIONS
+// ============================================================
+
+void trafficGeneratorDefaultConfig(TrafficConfig* config) {
+    config->macCount = 1;
+    config->packetsPerMac = 5000;
+    config->intervalMs = 1;
+    config->lossBp = 100;        // 1%
+    config->burstEnterBp = 20;   // ~1 burst per 500 pings
+    config->burstExitBp = 2500;  // Mean burst state length 4 pings
+    config->burstLossBp = 8000;  // 80% loss inside a burst
+    config->duplicateBp = 50;    // 0.5%
+    config->reorderBp = 100;     // 1%
+    config->reorderDepth = 4;
+    config->restartEvery = 0;
+    config->seed = 1;
+}
+
+void trafficGeneratorInit(TrafficGenerator* gen, const TrafficConfig* config) {
+    memset(gen, 0, sizeof(*gen));
+    gen->config = *config;
+
+    TrafficConfig* cfg = &gen->config;
+    if (cfg->macCount < 1) cfg->macCount = 1;
+    if (cfg->macCount > TRAFFIC_MAX_MACS) cfg->macCount = TRAFFIC_MAX_MACS;
+    if (cfg->reorderDepth < 1) cfg->reorderDepth = 1;
+    if (cfg->reorderDepth > TRAFFIC_MAX_REORDER) cfg->reorderDepth = TRAFFIC_MAX_REORDER;
+
+    gen->rngState = (cfg->seed != 0) ? cfg->seed : 0x9E3779B9;
+    for (uint8_t i = 0; i < cfg->macCount; i++) {
+        gen->remaining[i] = cfg->packetsPerMac;
+    }
+}
+
+bool trafficGeneratorNext(TrafficGenerator* gen, TrafficFrame* frame) {
+    const TrafficConfig* cfg = &gen->config;
+
+    while (true) {
+        // Second copy of the previous frame
+        if (gen->duplicatePending) {
+            gen->duplicatePending = false;
+            *frame = gen->duplicate;
+            gen->truth.duplicates++;
+            noteEmitted(gen);
+            return true;
+        }
+
+        // A held frame whose turn has come (oldest first)
+        for (uint8_t i = 0; i < gen->heldCount; i++) {
+            if (gen->held[i].releaseAfter == 0) {
+                releaseHeld(gen, i, frame);
+                noteEmitted(gen);
+                return true;
+            }
+        }
+
+        int index = pickTransmitter(gen);
+        if (index < 0) {
+            // All pings sent - flush what is still held back
+            if (gen->heldCount == 0) return false;
+            releaseHeld(gen, 0, frame);
+            noteEmitted(gen);
+            return true;
+        }
+
+        TrafficFrame sent;
+        if (!transmit(gen, (uint8_t)index, &sent)) continue;
+
+        if (chance(gen, cfg->duplicateBp)) {
+            gen->duplicate = sent;
+            gen->duplicatePending = true;
+        }
+
+        if (gen->heldCount < cfg->reorderDepth && chance(gen, cfg->reorderBp)) {
+            TrafficHeldFrame* slot = &gen->held[gen->heldCount++];
+            slot->frame = sent;
+            slot->releaseAfter = (uint8_t)(1 + randomBelow(gen, cfg->reorderDepth));
+            slot->passed = 0;
+            continue;
+        }
+
+        *frame = sent;
+        noteEmitted(gen);
+        return true;
+    }
+}
+
+const TrafficTruth* trafficGeneratorGetTruth(const TrafficGenerator* gen) {
+    return &gen->truth;
+}
+
+void trafficGeneratorGetMac(uint8_t index, uint8_t* mac) {
+    mac[0] = 0x02;  // Locally administered
+    mac[1] = 0x54;  // 'T'
+    mac[2] = 0x47;  // 'G'
+    mac[3] = 0x00;
+    mac[4] = 0x00;
+    mac[5] = index + 1;
+}
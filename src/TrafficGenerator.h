@@ -0,0 +1,126 @@
+// ============================================================
+//            SYNTHETIC TRAFFIC GENERATOR
+// ============================================================
+//
+// Produces PingMessage streams with known impairments and exact
+// ground truth, for checking receiver statistics and for load
+// tests without a radio:
+// - i.i.d. loss plus Gilbert-Elliott bursts (per transmitter)
+// - Duplicates (frame repeated immediately)
+// - Bounded reordering (frame held back behind 1..N later frames)
+// - Transmitter restarts (sequence and uptime return to 0)
+// - Several transmitter MACs interleaved at random
+//
+// Pure computation - no timing, no I/O. Callers pace the frames
+// and deliver them (espnowInjectFrame() on device, the loopback
+// or a direct diagnosticReceiverOnFrame() call on the host).
+// Same config and seed -> same stream.
+//
+// Probabilities are in basis points (1 bp = 0.01%).
+//
+// ============================================================
+
+#ifndef TRAFFICGENERATOR_H
+#define TRAFFICGENERATOR_H
+
+#include <Arduino.h>
+#include "DiagnosticReceiver.h"
+
+// ============================================================
+//                    CONFIGURATION
+// ============================================================
+
+#define TRAFFIC_MAX_MACS    8   // Interleaved transmitters
+#define TRAFFIC_MAX_REORDER 8   // Frames that can be held back at once
+
+struct TrafficConfig {
+    uint8_t macCount;        // Transmitters interleaved (1..TRAFFIC_MAX_MACS)
+    uint32_t packetsPerMac;  // Pings each transmitter sends
+    uint32_t intervalMs;     // Transmitter uptime step per ping
+    uint16_t lossBp;         // Loss in the good state (i.i.d.)
+    uint16_t burstEnterBp;   // Gilbert-Elliott: good -> bad per ping
+    uint16_t burstExitBp;    // Gilbert-Elliott: bad -> good per ping
+    uint16_t burstLossBp;    // Loss in the bad state
+    uint16_t duplicateBp;    // Delivered frames sent twice
+    uint16_t reorderBp;      // Delivered frames held back ...
+    uint8_t reorderDepth;    // ... behind 1..reorderDepth later frames
+    uint32_t restartEvery;   // Transmitter reboots after N pings (0 = never)
+    uint32_t seed;           // Stream seed (0 is remapped)
+};
+
+// ============================================================
+//                    GROUND TRUTH
+// ============================================================
+
+struct TrafficTruth {
+    uint32_t sent;            // Pings the transmitters sent
+    uint32_t lost;            // Pings the channel dropped
+    uint32_t lostInBurst;     // ... of which while in the bad state
+    uint32_t lossRuns;        // Runs of consecutive losses (per transmitter)
+    uint32_t longestLossRun;  // Longest such run
+    uint32_t delivered;       // Frames emitted, duplicates included
+    uint32_t duplicates;      // Extra copies emitted
+    uint32_t reordered;       // Frames emitted after a later-sent frame
+    uint32_t restarts;        // Transmitter reboots
+    uint32_t sentPerMac[TRAFFIC_MAX_MACS];
+    uint32_t lostPerMac[TRAFFIC_MAX_MACS];
+};
+
+// One frame as the receiver would see it
+struct TrafficFrame {
+    uint8_t mac[6];
+    PingMessage ping;
+};
+
+// ============================================================
+//                    GENERATOR STATE
+// ============================================================
+// Plain struct so any number of generators can run side by side.
+// Treat the fields as private; use the functions below.
+
+struct TrafficHeldFrame {
+    TrafficFrame frame;
+    uint8_t releaseAfter;  // Emitted frames still to pass it
+    uint8_t passed;        // Emitted frames that did pass it
+};
+
+struct TrafficGenerator {
+    TrafficConfig config;
+    TrafficTruth truth;
+    uint32_t rngState;
+
+    // Per transmitter
+    uint32_t remaining[TRAFFIC_MAX_MACS];
+    uint32_t sequence[TRAFFIC_MAX_MACS];
+    uint32_t uptimeMs[TRAFFIC_MAX_MACS];
+    uint32_t sinceRestart[TRAFFIC_MAX_MACS];
+    uint32_t lossRun[TRAFFIC_MAX_MACS];
+    bool inBurst[TRAFFIC_MAX_MACS];
+
+    TrafficHeldFrame held[TRAFFIC_MAX_REORDER];
+    uint8_t heldCount;
+    TrafficFrame duplicate;
+    bool duplicatePending;
+};
+
+// ============================================================
+//                    FUNCTIONS
+// ============================================================
+
+// Fill config with the built-in mixed-impairment profile
+// (1 transmitter, 5000 pings, 1% loss, bursts, duplicates, reorder)
+void trafficGeneratorDefaultConfig(TrafficConfig* config);
+
+// Start a new stream (truth counters cleared)
+void trafficGeneratorInit(TrafficGenerator* gen, const TrafficConfig* config);
+
+// Produce the next frame. Returns false when the stream is finished.
+bool trafficGeneratorNext(TrafficGenerator* gen, TrafficFrame* frame);
+
+// Ground truth so far (final once Next() has returned false)
+const TrafficTruth* trafficGeneratorGetTruth(const TrafficGenerator* gen);
+
+// MAC address of transmitter index (02:54:47:00:00:index+1)
+void trafficGeneratorGetMac(uint8_t index, uint8_t* mac);
+
+#endif
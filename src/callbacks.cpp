@@ -10,11 +10,12 @@
 
 #if USE_MQTT
 // Called when MQTT message is received on subscribed topics
-void onMqttMessage(String topic, String payload) {
-  propLog("[MQTT] Received: " + payload);
+// topic and payload are NUL-terminated and only valid during the call
+void onMqttMessage(const char* topic, const char* payload) {
+  propLogf("[MQTT] Received: %s", payload);
 
   // Handle reset command (case-insensitive)
-  if (payload.equalsIgnoreCase("reset")) {
+  if (strcasecmp(payload, "reset") == 0) {
     propLog("[MQTT] Reset command received");
     propRequestReset();
     return;
@@ -22,17 +23,23 @@ void onMqttMessage(String topic, String payload) {
 
   // Add your puzzle-specific MQTT handling here
   // Example:
-  // if (payload.equalsIgnoreCase("solve")) {
+  // if (strcasecmp(payload, "solve") == 0) {
   //   solvePuzzle();
   // }
 }
 #endif
 
 #if USE_ESPNOW
-// Called when ESP-NOW message is received
-void onEspNowReceive(const uint8_t* mac, const uint8_t* data, int len) {
-  // Forward to diagnostic receiver for processing
-  diagnosticReceiverOnPing(mac, data, len);
+// Called when ESP-NOW message is received (every frame, on Core 0)
+// The diagnostic receiver subscribes to pings itself - add your
+// puzzle-specific ESP-NOW handling here, or use espnowSubscribe()
+void IRAM_ATTR onEspNowReceive(const uint8_t* mac, const uint8_t* data, int len) {
+}
+
+// Called when the ESP-NOW receive path drops a frame (ring full or rate limited)
+void IRAM_ATTR onEspNowDrop(const uint8_t* mac, const uint8_t* data, int len) {
+  // Lets the diagnostic receiver keep internal drops out of RF loss
+  diagnosticReceiverOnRingDrop(mac, data, len);
 }
 
 // Called when ESP-NOW send completes
@@ -10,11 +10,12 @@
 // Implementations are in callbacks.cpp - customize them there.
 
 #if USE_MQTT
-void onMqttMessage(String topic, String payload);
+void onMqttMessage(const char* topic, const char* payload);
 #endif
 
 #if USE_ESPNOW
 void onEspNowReceive(const uint8_t* mac, const uint8_t* data, int len);
+void onEspNowDrop(const uint8_t* mac, const uint8_t* data, int len);
 void onEspNowSend(const uint8_t* mac, bool success);
 #endif
 
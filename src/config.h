@@ -68,6 +68,12 @@
 // Host MAC address - set this to your host device's MAC
 // Only used when ESPNOW_HOST is 0 (client mode)
 #define ESPNOW_HOST_MAC {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF}
+// Capture RSSI of received frames (enables promiscuous mode, mgmt frames only)
+#define ESPNOW_TRACK_RSSI 1
+// Accept radio frames only from these MACs (dropped before any copy)
+// 0 = accept every sender. Up to MAC_SET_CAPACITY (16) entries.
+#define ESPNOW_ALLOWLIST_ENABLED 0
+#define ESPNOW_ALLOWLIST { ESPNOW_HOST_MAC }
 #endif
 
 // ============================================================
@@ -2,6 +2,7 @@
 #include "config.h"
 #include "setup.h"
 #include "DiagnosticReceiver.h"
+#include "Trace.h"
 #include "esp_task_wdt.h"
 
 // MQTT runs on Core 1 (main loop)
@@ -51,5 +52,12 @@ void loopMain() {
   // ============================================================
   // Run diagnostic receiver logic (Core 1)
   // ============================================================
+  uint32_t loopStart = TRACE_CCOUNT();
   diagnosticReceiverLoop();
+  #if TRACE_ENABLED
+    traceLoopPass(loopStart);
+    traceSyncTick();
+  #else
+    (void)loopStart;
+  #endif
 }
@@ -0,0 +1,50 @@
+#include "alloc_counter.h"
+
+#ifdef ALLOC_COUNTER
+
+static uint32_t _allocations = 0;
+
+// The linker routes every malloc/calloc/realloc call here (--wrap)
+extern "C" {
+
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* IRAM_ATTR __wrap_malloc(size_t size) {
+    __atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* IRAM_ATTR __wrap_calloc(size_t count, size_t size) {
+    __atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* IRAM_ATTR __wrap_realloc(void* ptr, size_t size) {
+    // realloc(ptr, 0) frees
+    if (size > 0) __atomic_fetch_add(&_allocations, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+}
+
+bool allocCounterAvailable() {
+    return true;
+}
+
+uint32_t allocCounterGet() {
+    return __atomic_load_n(&_allocations, __ATOMIC_RELAXED);
+}
+
+#else
+
+bool allocCounterAvailable() {
+    return false;
+}
+
+uint32_t allocCounterGet() {
+    return 0;
+}
+
+#endif
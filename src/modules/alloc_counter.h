@@ -0,0 +1,19 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <Arduino.h>
+
+// Heap allocation counter. Built when ALLOC_COUNTER is defined and the
+// firmware is linked with
+//   -Wl,--wrap=malloc -Wl,--wrap=calloc -Wl,--wrap=realloc
+// (both set for [env:esp32s3] in platformio.ini). Every malloc, calloc
+// and growing realloc - and so new and Arduino String - is counted.
+// Direct heap_caps_malloc() calls (WiFi driver, FreeRTOS) are not.
+
+// True when the counter is linked in
+bool allocCounterAvailable();
+
+// Allocations since boot, 0 if unavailable
+uint32_t allocCounterGet();
+
+#endif
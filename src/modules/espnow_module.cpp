@@ -2,28 +2,181 @@
 #include <esp_now.h>
 #include <esp_wifi.h>
 #include <WiFi.h>
+#include "../Trace.h"
+
+static_assert(ESPNOW_FRAME_MAX_LEN == ESP_NOW_MAX_DATA_LEN, "EspNowFrame must hold any ESP-NOW payload");
+
+// Task configuration - receive ring consumer on Core 0
+#define ESPNOW_TASK_STACK 4096
+#define ESPNOW_TASK_PRIORITY 5
 
 static bool _initialized = false;
 static bool _isHost = false;
 static EspNowReceiveCallback _receiveCallback = nullptr;
+static SubscriberRegistry _subscribers;
 static EspNowSendCallback _sendCallback = nullptr;
+static EspNowDropCallback _dropCallback = nullptr;
 static TaskHandle_t _espnowTaskHandle = nullptr;
 
 static uint8_t _broadcastAddress[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-// Queue for passing received messages to the task
-static QueueHandle_t _receiveQueue = nullptr;
+// RSSI of the last ESP-NOW frame seen by the promiscuous callback
+static bool _rssiTracking = false;
+static volatile int8_t _lastRssi = 0;
+
+// RSSI of the frame currently being delivered to the receive callback
+static volatile int8_t _deliveryRssi = 0;
+
+// Receive ring for passing received messages to the task.
+// Produced by the WiFi task (plus injected frames), consumed by the
+// ESP-NOW task on Core 0. Lives in DRAM so the enqueue never touches flash.
+// Subscribers read the frames in place.
+static DRAM_ATTR EspNowFrame _rxRing[ESPNOW_RX_RING_SIZE];
+static volatile uint32_t _rxHead = 0;      // Written by producer only
+static volatile uint32_t _rxTail = 0;      // Written by consumer only
+static volatile uint32_t _rxReceived = 0;  // Frames handed to us by the WiFi stack
+static volatile uint32_t _rxBadLength = 0; // Frames rejected for their length
+static volatile uint32_t _rxDropped = 0;   // Frames lost because the ring was full
+static volatile uint32_t _rxLate = 0;      // Frames queued longer than ESPNOW_RX_LATE_US
+static volatile uint32_t _rxDelivered = 0; // Frames dispatched to subscribers / callback
+static volatile uint32_t _rxUnclaimed = 0; // Dispatched frames nobody listened for
+static volatile uint32_t _rxHighWater = 0; // Deepest ring occupancy seen
+static volatile uint32_t _rxPeakLatencyUs = 0; // Worst queue-to-callback-return time
+
+// Sender allowlist - looked up by the WiFi task, changed from the loop
+static DRAM_ATTR MacSet _allowlist;
+static volatile bool _allowlistActive = false;
+static volatile uint32_t _rxNotAllowed = 0;  // Frames from senders not on the list
+static portMUX_TYPE _allowlistMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Per-source rate limiting - WiFi task only, plus readers on the loop
+static DRAM_ATTR RateLimiter _rateLimiter;
+static portMUX_TYPE _rateMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Producers are the WiFi task and espnowInjectFrame() callers (any task,
+// either core), so the reserve-and-publish step is serialised. The
+// consumer side stays lock-free.
+static portMUX_TYPE _rxProducerMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Copy one frame into the receive ring and wake the ESP-NOW task.
+// rssi is the frame's signal strength, 0 if unknown.
+// Returns false if the ring was full and the frame was dropped.
+static bool IRAM_ATTR _enqueueFrame(const uint8_t* mac, const uint8_t* data, int len, int8_t rssi) {
+    portENTER_CRITICAL(&_rxProducerMux);
+
+    uint32_t head = _rxHead;
+    uint32_t depth = head - _rxTail;
+    if (depth >= ESPNOW_RX_RING_SIZE) {
+        _rxDropped++;
+        if (_dropCallback != nullptr) {
+            _dropCallback(mac, data, len);
+        }
+        portEXIT_CRITICAL(&_rxProducerMux);
+        TRACE_EVENT(TRACE_RX_DROP, depth);
+        return false;
+    }
 
-struct EspNowMessage {
-    uint8_t mac[6];
-    uint8_t data[250];
-    int len;
-};
-
-// Internal receive callback - runs in WiFi task context
-static void _onDataReceive(const uint8_t* mac, const uint8_t* data, int len) {
-    if (_receiveCallback != nullptr) {
-        _receiveCallback(mac, data, len);
+    EspNowFrame* slot = &_rxRing[head % ESPNOW_RX_RING_SIZE];
+    memcpy(slot->mac, mac, 6);
+    memcpy(slot->data, data, len);
+    slot->len = len;
+    slot->rssi = rssi;
+    slot->enqueuedUs = micros();
+
+    // Publish the slot only after its contents are written
+    __atomic_store_n(&_rxHead, head + 1, __ATOMIC_RELEASE);
+
+    if (depth + 1 > _rxHighWater) {
+        _rxHighWater = depth + 1;
+    }
+    portEXIT_CRITICAL(&_rxProducerMux);
+    TRACE_EVENT(TRACE_RX_ENQUEUE, depth + 1);
+
+    if (_espnowTaskHandle != nullptr) {
+        xTaskNotifyGive(_espnowTaskHandle);
+    }
+    return true;
+}
+
+// Internal receive callback - runs in WiFi task context.
+// Copies the frame into the ring and wakes the ESP-NOW task; all
+// processing happens there. IRAM-resident so a flash cache miss
+// never stalls the WiFi task.
+static void IRAM_ATTR _onDataReceive(const uint8_t* mac, const uint8_t* data, int len) {
+    TRACE_EVENT(TRACE_RX_CALLBACK_BEGIN, len);
+    __atomic_fetch_add(&_rxReceived, 1, __ATOMIC_RELAXED);
+
+    // Unrelated senders are discarded before anything is copied
+    if (_allowlistActive) {
+        portENTER_CRITICAL(&_allowlistMux);
+        bool allowed = macSetContains(&_allowlist, mac);
+        portEXIT_CRITICAL(&_allowlistMux);
+        if (!allowed) {
+            __atomic_fetch_add(&_rxNotAllowed, 1, __ATOMIC_RELAXED);
+            TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+            return;
+        }
+    }
+
+    if (len <= 0 || len > ESPNOW_FRAME_MAX_LEN) {
+        __atomic_fetch_add(&_rxBadLength, 1, __ATOMIC_RELAXED);
+        TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+        return;
+    }
+
+    // Over-rate sources are dropped before they cost a ring slot
+    portENTER_CRITICAL(&_rateMux);
+    bool allowed = rateLimiterAllow(&_rateLimiter, mac, micros());
+    portEXIT_CRITICAL(&_rateMux);
+
+    if (allowed) {
+        _enqueueFrame(mac, data, len, _lastRssi);
+    } else if (_dropCallback != nullptr) {
+        _dropCallback(mac, data, len);
+    }
+
+    TRACE_EVENT(TRACE_RX_CALLBACK_END, 0);
+}
+
+// Deliver every queued frame to the matching subscribers and the
+// receive callback - ESP-NOW task only. The slot stays reserved until
+// all of them have returned, so they share it without copying.
+static void IRAM_ATTR _drainReceiveRing() {
+    uint32_t tail = _rxTail;
+    uint32_t head = __atomic_load_n(&_rxHead, __ATOMIC_ACQUIRE);
+
+    while (tail != head) {
+        const EspNowFrame* slot = &_rxRing[tail % ESPNOW_RX_RING_SIZE];
+        TRACE_EVENT(TRACE_RX_DEQUEUE, head - tail);
+
+        // Time spent queued behind a slow consumer
+        if (micros() - slot->enqueuedUs > ESPNOW_RX_LATE_US) {
+            _rxLate++;
+        }
+
+        TRACE_EVENT(TRACE_RX_DISPATCH_BEGIN, slot->len);
+        _deliveryRssi = slot->rssi;
+        int matched = subscriberRegistryDispatch(&_subscribers, slot);
+        if (_receiveCallback != nullptr) {
+            _receiveCallback(slot->mac, slot->data, slot->len);
+            matched++;
+        }
+        TRACE_EVENT(TRACE_RX_DISPATCH_END, 0);
+
+        _rxDelivered++;
+        if (matched == 0) {
+            _rxUnclaimed++;
+        }
+
+        uint32_t latencyUs = micros() - slot->enqueuedUs;
+        if (latencyUs > _rxPeakLatencyUs) {
+            _rxPeakLatencyUs = latencyUs;
+        }
+
+        // Release the slot back to the producer
+        tail++;
+        __atomic_store_n(&_rxTail, tail, __ATOMIC_RELEASE);
+        head = __atomic_load_n(&_rxHead, __ATOMIC_ACQUIRE);
     }
 }
 
@@ -34,14 +187,32 @@ static void _onDataSend(const uint8_t* mac, esp_now_send_status_t status) {
     }
 }
 
+// Promiscuous callback - runs in WiFi task context just before the
+// receive callback for the same frame. ESP-NOW frames are vendor-specific
+// action frames: subtype 0xD0, category 127, Espressif OUI 18:FE:34.
+static void IRAM_ATTR _onPromiscuousRx(void* buf, wifi_promiscuous_pkt_type_t type) {
+    if (type != WIFI_PKT_MGMT) return;
+
+    const wifi_promiscuous_pkt_t* pkt = (const wifi_promiscuous_pkt_t*)buf;
+    const uint8_t* frame = pkt->payload;
+
+    if (pkt->rx_ctrl.sig_len < 28) return;
+    if (frame[0] != 0xD0) return;
+    if (frame[24] != 127 || frame[25] != 0x18 || frame[26] != 0xFE || frame[27] != 0x34) return;
+
+    _lastRssi = pkt->rx_ctrl.rssi;
+}
+
 // FreeRTOS task running on Core 0
-// ESP-NOW callbacks are handled by the WiFi task on Core 0 automatically
-// This task is available for any periodic ESP-NOW maintenance if needed
+// The WiFi task only enqueues received frames; this task drains the
+// receive ring and runs the receive callback outside WiFi task context.
 static void espnowTask(void* param) {
     while (true) {
-        // ESP-NOW is event-driven, callbacks handle messages
-        // This task can be used for periodic broadcasts or maintenance
-        vTaskDelay(100 / portTICK_PERIOD_MS);
+        // Sleep until the receive callback signals new frames
+        // (100ms timeout keeps the task available for maintenance)
+        ulTaskNotifyTake(pdTRUE, 100 / portTICK_PERIOD_MS);
+        _drainReceiveRing();
+        traceSyncTick();
     }
 }
 
@@ -70,6 +241,9 @@ bool espnowInit(bool isHost, const uint8_t* hostMac) {
         return false;
     }
 
+    rateLimiterInit(&_rateLimiter, ESPNOW_RATE_LIMIT_PPS, ESPNOW_RATE_LIMIT_BURST);
+    macSetInit(&_allowlist);
+
     // Register callbacks
     esp_now_register_recv_cb(_onDataReceive);
     esp_now_register_send_cb(_onDataSend);
@@ -109,16 +283,18 @@ bool espnowInit(bool isHost, const uint8_t* hostMac) {
         }
     }
 
+    char macStr[ESPNOW_MAC_STR_LEN];
+    espnowGetMACString(macStr, sizeof(macStr));
     Serial.print("[ESP-NOW] This device MAC: ");
-    Serial.println(WiFi.macAddress());
+    Serial.println(macStr);
 
     // Start ESP-NOW task on Core 0
     xTaskCreatePinnedToCore(
         espnowTask,
         "ESPNowTask",
-        4096,
+        ESPNOW_TASK_STACK,
         NULL,
-        1,
+        ESPNOW_TASK_PRIORITY,
         &_espnowTaskHandle,
         0  // Core 0
     );
@@ -132,6 +308,18 @@ void espnowSetReceiveCallback(EspNowReceiveCallback callback) {
     _receiveCallback = callback;
 }
 
+int espnowSubscribe(const EspNowFilter* filter, EspNowFrameHandler handler, void* context) {
+    return subscriberRegistryAdd(&_subscribers, filter, handler, context);
+}
+
+void espnowUnsubscribe(int id) {
+    subscriberRegistryRemove(&_subscribers, id);
+}
+
+void espnowSetDropCallback(EspNowDropCallback callback) {
+    _dropCallback = callback;
+}
+
 void espnowSetSendCallback(EspNowSendCallback callback) {
     _sendCallback = callback;
 }
@@ -144,8 +332,12 @@ bool espnowSend(const uint8_t* mac, const uint8_t* data, size_t len) {
     return result == ESP_OK;
 }
 
+bool espnowSendString(const uint8_t* mac, const char* message) {
+    return espnowSend(mac, (const uint8_t*)message, strlen(message));
+}
+
 bool espnowSendString(const uint8_t* mac, const String& message) {
-    return espnowSend(mac, (const uint8_t*)message.c_str(), message.length());
+    return espnowSendString(mac, message.c_str());
 }
 
 bool espnowBroadcast(const uint8_t* data, size_t len) {
@@ -169,8 +361,17 @@ bool espnowRemovePeer(const uint8_t* mac) {
     return esp_now_del_peer(mac) == ESP_OK;
 }
 
+void espnowGetMACString(char* buffer, size_t bufferSize) {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    snprintf(buffer, bufferSize, "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
 String espnowGetMAC() {
-    return WiFi.macAddress();
+    char buffer[ESPNOW_MAC_STR_LEN];
+    espnowGetMACString(buffer, sizeof(buffer));
+    return String(buffer);
 }
 
 bool espnowIsInitialized() {
@@ -181,6 +382,109 @@ bool espnowIsHost() {
     return _isHost;
 }
 
+bool espnowEnableRssiTracking() {
+    if (!_initialized) return false;
+    if (_rssiTracking) return true;
+
+    wifi_promiscuous_filter_t filter = {};
+    filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+    esp_wifi_set_promiscuous_filter(&filter);
+    esp_wifi_set_promiscuous_rx_cb(_onPromiscuousRx);
+
+    if (esp_wifi_set_promiscuous(true) != ESP_OK) {
+        Serial.println("[ESP-NOW] Failed to enable RSSI tracking");
+        return false;
+    }
+
+    _rssiTracking = true;
+    Serial.println("[ESP-NOW] RSSI tracking enabled");
+    return true;
+}
+
+int8_t IRAM_ATTR espnowGetLastRssi() {
+    return _deliveryRssi;
+}
+
+bool espnowAllowlistAdd(const uint8_t* mac) {
+    portENTER_CRITICAL(&_allowlistMux);
+    bool added = macSetAdd(&_allowlist, mac);
+    _allowlistActive = macSetCount(&_allowlist) > 0;
+    portEXIT_CRITICAL(&_allowlistMux);
+    return added;
+}
+
+bool espnowAllowlistRemove(const uint8_t* mac) {
+    portENTER_CRITICAL(&_allowlistMux);
+    bool removed = macSetRemove(&_allowlist, mac);
+    _allowlistActive = macSetCount(&_allowlist) > 0;
+    portEXIT_CRITICAL(&_allowlistMux);
+    return removed;
+}
+
+void espnowAllowlistClear() {
+    portENTER_CRITICAL(&_allowlistMux);
+    macSetInit(&_allowlist);
+    _allowlistActive = false;
+    portEXIT_CRITICAL(&_allowlistMux);
+}
+
+int espnowAllowlistCount() {
+    return macSetCount(&_allowlist);
+}
+
+bool espnowInjectFrame(const uint8_t* mac, const uint8_t* data, int len) {
+    if (!_initialized) return false;
+
+    __atomic_fetch_add(&_rxReceived, 1, __ATOMIC_RELAXED);
+    if (len <= 0 || len > ESPNOW_FRAME_MAX_LEN) {
+        __atomic_fetch_add(&_rxBadLength, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    return _enqueueFrame(mac, data, len, 0);  // Never heard over the air: RSSI unknown
+}
+
+void espnowGetRxStats(EspNowRxStats* stats) {
+    stats->received = _rxReceived;
+    stats->notAllowed = _rxNotAllowed;
+    stats->badLength = _rxBadLength;
+    stats->rateLimited = _rateLimiter.throttled;
+    stats->rateEvictions = _rateLimiter.evictions;
+    stats->dropped = _rxDropped;
+    stats->late = _rxLate;
+    stats->delivered = _rxDelivered;
+    stats->unclaimed = _rxUnclaimed;
+    stats->highWater = _rxHighWater;
+    stats->depth = _rxHead - _rxTail;
+}
+
+int espnowGetRateLimitSources(RateLimitEntry* out, int maxEntries) {
+    // Copy under the lock, sort outside it
+    RateLimiter snapshot;
+    portENTER_CRITICAL(&_rateMux);
+    snapshot = _rateLimiter;
+    portEXIT_CRITICAL(&_rateMux);
+
+    return rateLimiterGetSources(&snapshot, out, maxEntries);
+}
+
+uint32_t espnowTakeRxPeakLatency() {
+    return __atomic_exchange_n(&_rxPeakLatencyUs, 0, __ATOMIC_RELAXED);
+}
+
+void espnowResetRxStats() {
+    _rxReceived = 0;
+    _rxNotAllowed = 0;
+    _rxBadLength = 0;
+    portENTER_CRITICAL(&_rateMux);
+    rateLimiterResetCounters(&_rateLimiter);
+    portEXIT_CRITICAL(&_rateMux);
+    _rxDropped = 0;
+    _rxLate = 0;
+    _rxDelivered = 0;
+    _rxUnclaimed = 0;
+    _rxHighWater = 0;
+}
+
 void espnowSyncChannel() {
     if (!_initialized) return;
 
@@ -196,3 +500,17 @@ void espnowSyncChannel() {
     Serial.print("[ESP-NOW] Channel synced to WiFi channel ");
     Serial.println(channel);
 }
+
+bool espnowSetChannel(uint8_t channel) {
+    if (!_initialized || channel < 1 || channel > 13) return false;
+    if (WiFi.isConnected()) return false;
+
+    return esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE) == ESP_OK;
+}
+
+uint8_t espnowGetChannel() {
+    uint8_t primary = 0;
+    wifi_second_chan_t secondary;
+    if (esp_wifi_get_channel(&primary, &secondary) != ESP_OK) return 0;
+    return primary;
+}
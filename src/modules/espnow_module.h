@@ -2,10 +2,42 @@
 #define ESPNOW_MODULE_H
 
 #include <Arduino.h>
+#include "rate_limiter.h"
+#include "mac_set.h"
+#include "subscriber_registry.h"
+
+// Receive ring depth (frames buffered between WiFi task and ESP-NOW task)
+#ifndef ESPNOW_RX_RING_SIZE
+#define ESPNOW_RX_RING_SIZE 32
+#endif
+
+// Frames that wait longer than this in the ring count as consumer lag
+#ifndef ESPNOW_RX_LATE_US
+#define ESPNOW_RX_LATE_US 10000
+#endif
+
+// Per-source-MAC token bucket applied to radio frames before the ring,
+// so one flooding sender cannot take the consumer's time from the rest.
+// Injected frames (espnowInjectFrame) are not limited.
+#ifndef ESPNOW_RATE_LIMIT_PPS
+#define ESPNOW_RATE_LIMIT_PPS 500   // Sustained frames/s per MAC (0 = off)
+#endif
+#ifndef ESPNOW_RATE_LIMIT_BURST
+#define ESPNOW_RATE_LIMIT_BURST 32  // Frames a source may send back to back
+#endif
 
 // Callback function type for incoming ESP-NOW messages
+// Called from the ESP-NOW task on Core 0, not from the WiFi task.
+// Place implementations in IRAM (IRAM_ATTR) to keep the path cache-miss free.
+// Sees every frame; use espnowSubscribe() to receive a filtered subset.
 typedef void (*EspNowReceiveCallback)(const uint8_t* mac, const uint8_t* data, int len);
 
+// Callback function type for frames the receive path had to drop
+// (ring full or rate limited). Called in the producer's context (WiFi
+// task or injector), possibly with the ring lock held: must be IRAM_ATTR,
+// short, and must not block or print.
+typedef void (*EspNowDropCallback)(const uint8_t* mac, const uint8_t* data, int len);
+
 // Callback function type for send status
 typedef void (*EspNowSendCallback)(const uint8_t* mac, bool success);
 
@@ -18,6 +50,20 @@ bool espnowInit(bool isHost, const uint8_t* hostMac = nullptr);
 // Set callback for received messages
 void espnowSetReceiveCallback(EspNowReceiveCallback callback);
 
+// Register a receive subscriber: handler gets every frame matching filter
+// as a read-only pointer into the receive ring (no copy). Each frame is
+// dispatched once to all matching subscribers, then to the receive
+// callback. Returns a subscriber id, or -1 if ESPNOW_MAX_SUBSCRIBERS are
+// registered. May be called before espnowInit().
+int espnowSubscribe(const EspNowFilter* filter, EspNowFrameHandler handler, void* context = nullptr);
+
+// Remove a subscriber registered with espnowSubscribe()
+void espnowUnsubscribe(int id);
+
+// Set callback for frames dropped by the ring or the rate limiter
+// Lets the application tell internal drops apart from over-the-air loss.
+void espnowSetDropCallback(EspNowDropCallback callback);
+
 // Set callback for send status
 void espnowSetSendCallback(EspNowSendCallback callback);
 
@@ -27,8 +73,9 @@ void espnowSetSendCallback(EspNowSendCallback callback);
 // len: Data length
 bool espnowSend(const uint8_t* mac, const uint8_t* data, size_t len);
 
-// Send string message
-bool espnowSendString(const uint8_t* mac, const String& message);
+// Send string message (without the terminating NUL)
+bool espnowSendString(const uint8_t* mac, const char* message);
+bool espnowSendString(const uint8_t* mac, const String& message);  // Allocates - prefer const char*
 
 // Broadcast data to all peers (host mode only)
 bool espnowBroadcast(const uint8_t* data, size_t len);
@@ -39,8 +86,11 @@ bool espnowAddPeer(const uint8_t* mac);
 // Remove a peer
 bool espnowRemovePeer(const uint8_t* mac);
 
-// Get own MAC address as string
-String espnowGetMAC();
+// Get own MAC address as "AA:BB:CC:DD:EE:FF" into buffer
+// (at least ESPNOW_MAC_STR_LEN bytes)
+#define ESPNOW_MAC_STR_LEN 18
+void espnowGetMACString(char* buffer, size_t bufferSize);
+String espnowGetMAC();  // Allocates - prefer espnowGetMACString()
 
 // Check if ESP-NOW is initialized
 bool espnowIsInitialized();
@@ -48,8 +98,72 @@ bool espnowIsInitialized();
 // Check if running as host
 bool espnowIsHost();
 
+// Enable RSSI capture for received ESP-NOW frames
+// Uses promiscuous mode filtered to management frames, since the
+// receive callback does not carry radio metadata.
+// Call after espnowInit(). Returns true if enabled.
+bool espnowEnableRssiTracking();
+
+// RSSI (dBm) of the most recent ESP-NOW frame, 0 if unknown
+// Valid inside the receive callback for the frame being delivered
+int8_t espnowGetLastRssi();
+
+// Receive ring counters, one per pipeline stage. Every frame that
+// enters is either rejected, dropped, still queued or delivered:
+//   received = notAllowed + badLength + rateLimited + dropped + depth + delivered
+// Delivered frames that no subscriber or receive callback took are
+// counted again under unclaimed.
+struct EspNowRxStats {
+    uint32_t received;   // Receive callback entries (plus injected frames)
+    uint32_t notAllowed; // Sender not on the allowlist (first check, no copy)
+    uint32_t badLength;  // Rejected before the ring: empty or oversized
+    uint32_t rateLimited;    // Refused by the per-MAC token bucket
+    uint32_t rateEvictions;  // Sources pushed out of the rate table
+    uint32_t dropped;    // Dropped because the ring was full
+    uint32_t late;       // Delivered, but queued longer than ESPNOW_RX_LATE_US
+    uint32_t delivered;  // Dispatched to subscribers / the receive callback
+    uint32_t unclaimed;  // ... of which nobody was listening for
+    uint32_t highWater;  // Deepest ring occupancy seen
+    uint32_t depth;      // Frames currently queued
+};
+
+// Sender allowlist for radio frames, checked first in the receive
+// callback. Empty = accept every sender. Injected frames are not filtered.
+// Call after espnowInit(). Add returns false if the list is full.
+bool espnowAllowlistAdd(const uint8_t* mac);
+bool espnowAllowlistRemove(const uint8_t* mac);
+void espnowAllowlistClear();
+int espnowAllowlistCount();
+
+// Inject a frame into the receive ring as if the radio had delivered it
+// (self-tests, capacity tests), with RSSI 0 (unknown) so it stays out of
+// signal statistics. Safe to call from any task.
+// Returns false if ESP-NOW is not initialized or the ring was full.
+bool espnowInjectFrame(const uint8_t* mac, const uint8_t* data, int len);
+
+// Get receive ring counters
+void espnowGetRxStats(EspNowRxStats* stats);
+
+// Copy the rate limiter's tracked sources (busiest first) into out.
+// Returns the number copied (at most RATE_LIMIT_TABLE_SIZE).
+int espnowGetRateLimitSources(RateLimitEntry* out, int maxEntries);
+
+// Worst time (us) from a frame entering the ring to its receive callback
+// returning, since the previous call. Clears the peak.
+uint32_t espnowTakeRxPeakLatency();
+
+// Reset receive ring counters
+void espnowResetRxStats();
+
 // Sync ESP-NOW to current WiFi channel
 // Call this after WiFi connects if using both WiFi and ESP-NOW
 void espnowSyncChannel();
 
+// Move the radio to channel (1-13) for sending and receiving.
+// Fails while WiFi is connected - the access point owns the channel.
+bool espnowSetChannel(uint8_t channel);
+
+// Current radio channel (0 if unknown)
+uint8_t espnowGetChannel();
+
 #endif
@@ -0,0 +1,176 @@
+#include "fec_codec.h"
+
+static_assert(FEC_MAX_DATA <= 32, "presentMask holds one bit per data frame");
+static_assert(FEC_MAX_PARITY <= 8, "parityMask holds one bit per parity row");
+static_assert(FEC_MAX_DATA + FEC_MAX_PARITY <= 256, "Cauchy points must be distinct field elements");
+
+// ============================================================
+//                    GF(256)
+// ============================================================
+// Polynomial x^8 + x^4 + x^3 + x^2 + 1 (0x11D), generator 2.
+// exp is doubled so log[a] + log[b] never needs a modulo.
+
+struct GfTables {
+    uint8_t exp[510];
+    uint8_t log[256];
+};
+
+static constexpr GfTables buildGfTables() {
+    GfTables t{};
+    int x = 1;
+    for (int i = 0; i < 255; i++) {
+        t.exp[i] = (uint8_t)x;
+        t.exp[i + 255] = (uint8_t)x;
+        t.log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= 0x11D;
+    }
+    return t;
+}
+
+// Read per multiply from the receive path - keep in DRAM, not flash
+static DRAM_ATTR const GfTables _gf = buildGfTables();
+
+static inline uint8_t IRAM_ATTR gfMul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return _gf.exp[_gf.log[a] + _gf.log[b]];
+}
+
+// a != 0
+static inline uint8_t IRAM_ATTR gfInv(uint8_t a) {
+    return _gf.exp[255 - _gf.log[a]];
+}
+
+uint8_t IRAM_ATTR fecCoefficient(int row, int index) {
+    // Cauchy 1 / (x_r + y_i), column scaled by 1 / C[0][i] = y_i
+    uint8_t y = (uint8_t)(FEC_MAX_PARITY + index);
+    return gfMul(y, gfInv((uint8_t)row ^ y));
+}
+
+// ============================================================
+//                    BUFFER KERNELS
+// ============================================================
+
+static void IRAM_ATTR xorInto(uint8_t* dst, const uint8_t* src, size_t len) {
+    size_t i = 0;
+    if ((((uintptr_t)dst | (uintptr_t)src) & 3) == 0) {
+        uint32_t* d = (uint32_t*)dst;
+        const uint32_t* s = (const uint32_t*)src;
+        for (; i + 4 <= len; i += 4) *d++ ^= *s++;
+    }
+    for (; i < len; i++) dst[i] ^= src[i];
+}
+
+void IRAM_ATTR fecMulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len) {
+    if (c == 0) return;
+    if (c == 1) {
+        xorInto(dst, src, len);
+        return;
+    }
+
+    // c * b = low[b & 15] ^ high[b >> 4]: 32 multiplies, then two
+    // lookups per byte
+    uint8_t low[16];
+    uint8_t high[16];
+    for (int n = 0; n < 16; n++) {
+        low[n] = gfMul(c, (uint8_t)n);
+        high[n] = gfMul(c, (uint8_t)(n << 4));
+    }
+
+    size_t i = 0;
+    if ((((uintptr_t)dst | (uintptr_t)src) & 3) == 0) {
+        uint32_t* d = (uint32_t*)dst;
+        const uint32_t* s = (const uint32_t*)src;
+        for (; i + 4 <= len; i += 4) {
+            uint32_t w = *s++;
+            uint32_t product = (uint32_t)(low[w & 15] ^ high[(w >> 4) & 15]) |
+                               (uint32_t)(low[(w >> 8) & 15] ^ high[(w >> 12) & 15]) << 8 |
+                               (uint32_t)(low[(w >> 16) & 15] ^ high[(w >> 20) & 15]) << 16 |
+                               (uint32_t)(low[(w >> 24) & 15] ^ high[w >> 28]) << 24;
+            *d++ ^= product;
+        }
+    }
+    for (; i < len; i++) dst[i] ^= low[src[i] & 15] ^ high[src[i] >> 4];
+}
+
+// ============================================================
+//                    ENCODE / DECODE
+// ============================================================
+
+void fecEncode(const uint8_t* const* data, int k, int row, size_t len, uint8_t* parity) {
+    memset(parity, 0, len);
+    for (int i = 0; i < k; i++) fecMulAdd(parity, data[i], fecCoefficient(row, i), len);
+}
+
+// Invert the n x n matrix a in place (Gauss-Jordan). Cauchy
+// submatrices are never singular, so every pivot search succeeds.
+static bool IRAM_ATTR invert(uint8_t a[FEC_MAX_PARITY][FEC_MAX_PARITY], int n) {
+    uint8_t inv[FEC_MAX_PARITY][FEC_MAX_PARITY] = {};
+    for (int i = 0; i < n; i++) inv[i][i] = 1;
+
+    for (int col = 0; col < n; col++) {
+        int pivot = col;
+        while (pivot < n && a[pivot][col] == 0) pivot++;
+        if (pivot == n) return false;
+        if (pivot != col) {
+            for (int j = 0; j < n; j++) {
+                uint8_t t = a[col][j]; a[col][j] = a[pivot][j]; a[pivot][j] = t;
+                t = inv[col][j]; inv[col][j] = inv[pivot][j]; inv[pivot][j] = t;
+            }
+        }
+
+        uint8_t scale = gfInv(a[col][col]);
+        for (int j = 0; j < n; j++) {
+            a[col][j] = gfMul(a[col][j], scale);
+            inv[col][j] = gfMul(inv[col][j], scale);
+        }
+        for (int row = 0; row < n; row++) {
+            uint8_t f = a[row][col];
+            if (row == col || f == 0) continue;
+            for (int j = 0; j < n; j++) {
+                a[row][j] ^= gfMul(f, a[col][j]);
+                inv[row][j] ^= gfMul(f, inv[col][j]);
+            }
+        }
+    }
+    memcpy(a, inv, sizeof(inv));
+    return true;
+}
+
+bool IRAM_ATTR fecDecode(uint8_t* const* data, int k, uint32_t presentMask, uint8_t* const* parity,
+                         uint8_t parityMask, size_t len) {
+    int lost[FEC_MAX_PARITY];
+    int rows[FEC_MAX_PARITY];
+    int erasures = 0;
+    for (int i = 0; i < k; i++) {
+        if (presentMask & (1u << i)) continue;
+        if (erasures == FEC_MAX_PARITY) return false;
+        lost[erasures++] = i;
+    }
+    if (erasures == 0) return true;
+
+    int available = 0;
+    for (int r = 0; r < FEC_MAX_PARITY && available < erasures; r++) {
+        if (parityMask & (1u << r)) rows[available++] = r;
+    }
+    if (available < erasures) return false;
+
+    // Syndromes: each used parity row minus the data that arrived,
+    // leaving sum over the lost frames of coef * data
+    uint8_t a[FEC_MAX_PARITY][FEC_MAX_PARITY];
+    for (int t = 0; t < erasures; t++) {
+        uint8_t* s = parity[rows[t]];
+        for (int i = 0; i < k; i++) {
+            if (presentMask & (1u << i)) fecMulAdd(s, data[i], fecCoefficient(rows[t], i), len);
+        }
+        for (int u = 0; u < erasures; u++) a[t][u] = fecCoefficient(rows[t], lost[u]);
+    }
+    if (!invert(a, erasures)) return false;
+
+    for (int u = 0; u < erasures; u++) {
+        uint8_t* out = data[lost[u]];
+        memset(out, 0, len);
+        for (int t = 0; t < erasures; t++) fecMulAdd(out, parity[rows[t]], a[u][t], len);
+    }
+    return true;
+}
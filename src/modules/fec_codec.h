@@ -0,0 +1,54 @@
+#ifndef FEC_CODEC_H
+#define FEC_CODEC_H
+
+#include <Arduino.h>
+
+// Systematic erasure code over GF(256) for groups of equal-length
+// frames: k data frames plus up to FEC_MAX_PARITY parity frames,
+// any k of which rebuild the data.
+//
+// Parity row r is sum_i coef(r, i) * data[i]. The coefficients are a
+// Cauchy matrix (x_r = r, y_i = FEC_MAX_PARITY + i) with every column
+// scaled so row 0 is all ones: row 0 is plain XOR parity, and every
+// square submatrix stays invertible, so any mix of up to m lost data
+// frames is recoverable from any m parity rows. An XOR(k) scheme is
+// simply m = 1, and a transmitter can add RS rows without changing
+// what row 0 means. The coefficients depend only on (row, index),
+// not on k or m.
+//
+// Table-driven arithmetic: log/exp tables (768 bytes, DRAM) for
+// scalars, and per-coefficient nibble tables with 32-bit word
+// kernels for buffers; coefficient 1 is a word-wide XOR. Encode and
+// decode are shared by the transmitter side (host loopback) and the
+// receiver (FecDecoder.cpp). Plain functions, no state.
+
+// Data frames per group (k), at most 32
+#ifndef FEC_MAX_DATA
+#define FEC_MAX_DATA 32
+#endif
+
+// Parity frames per group (m), at most 8
+#ifndef FEC_MAX_PARITY
+#define FEC_MAX_PARITY 4
+#endif
+
+// Coefficient of data frame `index` in parity row `row`
+uint8_t fecCoefficient(int row, int index);
+
+// dst ^= c * src over len bytes. Word-wide when both are 4-byte aligned.
+void fecMulAdd(uint8_t* dst, const uint8_t* src, uint8_t c, size_t len);
+
+// parity = parity row `row` of the k data frames
+void fecEncode(const uint8_t* const* data, int k, int row, size_t len, uint8_t* parity);
+
+// Rebuild the data frames missing from presentMask (bit i = data[i]
+// arrived) from the parity rows in parityMask (bit r = parity[r]
+// arrived). data[i] must point at a writable len-byte buffer for
+// every i; missing ones are overwritten. parity buffers are used as
+// scratch and left modified. Returns false (nothing written) if more
+// frames are missing than parity rows arrived.
+// IRAM-resident: called from the receive path.
+bool fecDecode(uint8_t* const* data, int k, uint32_t presentMask, uint8_t* const* parity, uint8_t parityMask,
+               size_t len);
+
+#endif
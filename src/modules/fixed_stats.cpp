@@ -0,0 +1,195 @@
+#include "fixed_stats.h"
+
+#define ONE_Q16 65536u
+#define ONE_Q24 16777216u
+#define ONE_PPM 1000000u
+
+// Welford input range: samples are stored Q8 in 32 bits with headroom
+// for the difference from the mean plus the carried remainder
+#define WELFORD_MAX_SAMPLE ((1 << 21) - 1)
+#define WELFORD_MAX_COUNT  (1u << 30)
+
+// 95% Wilson interval constants, scaled by WILSON_SCALE = 10^8:
+// z^2 * 10^8 and z * 10^4 for z = 1.96
+#define WILSON_SCALE  100000000ULL
+#define WILSON_Z2     384160000ULL
+#define WILSON_Z_X1E4 19600ULL
+
+// ============================================================
+//                    WELFORD MEAN / VARIANCE
+// ============================================================
+// The mean carries its division remainder from one update to the next,
+// so it stays exact and keeps moving after millions of samples instead
+// of freezing once |x - mean| < count.
+
+void welfordInit(WelfordStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+}
+
+void IRAM_ATTR welfordAdd(WelfordStats* stats, int32_t sample) {
+    if (sample > WELFORD_MAX_SAMPLE) sample = WELFORD_MAX_SAMPLE;
+    if (sample < -WELFORD_MAX_SAMPLE) sample = -WELFORD_MAX_SAMPLE;
+    if (stats->count >= WELFORD_MAX_COUNT) return;
+
+    int32_t x = sample * 256;
+    int32_t n = (int32_t)++stats->count;
+    int32_t delta = x - stats->meanQ8;
+
+    // New mean * n = old meanQ8 * n + (delta + remainder), floor-divided
+    int32_t step = delta + stats->remainder;
+    int32_t quotient = step / n;
+    int32_t remainder = step - quotient * n;
+    if (remainder < 0) {
+        remainder += n;
+        quotient--;
+    }
+    stats->meanQ8 += quotient;
+    stats->remainder = remainder;
+
+    stats->m2Q16 += (int64_t)delta * (x - stats->meanQ8);
+}
+
+int32_t welfordMeanQ8(const WelfordStats* stats) {
+    return stats->meanQ8;
+}
+
+uint32_t welfordStdDevQ8(const WelfordStats* stats) {
+    if (stats->count < 2 || stats->m2Q16 <= 0) return 0;
+    uint64_t varianceQ16 = (uint64_t)stats->m2Q16 / (stats->count - 1);
+    return statsSqrt64(varianceQ16);
+}
+
+// ============================================================
+//                    EWMA EVENT RATE
+// ============================================================
+
+// keep^count in Q16 by repeated squaring (truncating each product)
+static uint32_t IRAM_ATTR _powQ16(uint32_t keep, uint32_t count) {
+    uint64_t result = ONE_Q16;
+    uint64_t base = keep;
+    while (count > 0 && result > 0) {
+        if (count & 1) result = (result * base) >> 16;
+        base = (base * base) >> 16;
+        count >>= 1;
+    }
+    return (uint32_t)result;
+}
+
+void ewmaInit(EwmaRate* ewma, uint32_t halfLife) {
+    if (halfLife < 1) halfLife = 1;
+
+    // Smallest keep with keep^halfLife >= 1/2, by bisection
+    uint32_t lo = 0;
+    uint32_t hi = ONE_Q16;
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (_powQ16(mid, halfLife) >= ONE_Q16 / 2) {
+            hi = mid;
+        } else {
+            lo = mid;
+        }
+    }
+
+    ewma->rateQ24 = 0;
+    ewma->keepQ16 = hi;
+    ewma->halfLife = halfLife;
+}
+
+void IRAM_ATTR ewmaAddRun(EwmaRate* ewma, bool event, uint32_t count) {
+    if (count == 0) return;
+
+    // After count trials the old estimate keeps weight keep^count and
+    // the rest goes to the trials' value
+    uint64_t kept = _powQ16(ewma->keepQ16, count);
+    if (event) {
+        ewma->rateQ24 = ONE_Q24 - (uint32_t)(((ONE_Q24 - ewma->rateQ24) * kept) >> 16);
+    } else {
+        ewma->rateQ24 = (uint32_t)((ewma->rateQ24 * kept) >> 16);
+    }
+}
+
+void IRAM_ATTR ewmaUndoEvent(EwmaRate* ewma, uint32_t age) {
+    // The trial entered with weight (1 - keep) and has decayed by
+    // keep^age since
+    uint64_t weightQ16 = ((uint64_t)(ONE_Q16 - ewma->keepQ16) * _powQ16(ewma->keepQ16, age)) >> 16;
+    uint32_t weightQ24 = (uint32_t)(weightQ16 << 8);
+    ewma->rateQ24 = (ewma->rateQ24 > weightQ24) ? ewma->rateQ24 - weightQ24 : 0;
+}
+
+uint32_t ewmaRatePpm(const EwmaRate* ewma) {
+    return statsRatioPpm(ewma->rateQ24, ONE_Q24);
+}
+
+// ============================================================
+//                    RATIOS AND INTERVALS
+// ============================================================
+
+uint32_t IRAM_ATTR statsRatioPpm(uint64_t num, uint64_t den) {
+    if (den == 0) return ONE_PPM;
+
+    // Keep num * 10^6 within 64 bits
+    while (num >= (1ULL << 44) || den >= (1ULL << 44)) {
+        num >>= 1;
+        den >>= 1;
+    }
+    if (den == 0) return ONE_PPM;
+    return (uint32_t)((num * ONE_PPM + den / 2) / den);
+}
+
+// Wilson bounds: (2s + z^2 -/+ z * sqrt(z^2 + 4 s (n - s) / n)) / (2 (n + z^2)),
+// everything scaled by 10^8 so z and z^2 are integers
+void IRAM_ATTR statsWilsonInterval(uint32_t successes, uint32_t trials, WilsonInterval* out) {
+    if (trials == 0) {
+        out->lowPpm = 0;
+        out->highPpm = ONE_PPM;
+        return;
+    }
+    if (successes > trials) successes = trials;
+
+    uint64_t s = successes;
+    uint64_t n = trials;
+
+    // 4 s (n - s) / n as whole part plus remainder so nothing overflows
+    uint64_t product = s * (n - s);
+    uint64_t whole = product / n;
+    uint64_t part = product - whole * n;
+    uint64_t inner = WILSON_Z2 + 4 * WILSON_SCALE * whole + (4 * WILSON_SCALE * part) / n;
+
+    uint64_t spread = WILSON_Z_X1E4 * statsSqrt64(inner);  // z * sqrt(...) * 10^8
+    uint64_t center = 2 * s * WILSON_SCALE + WILSON_Z2;
+    uint64_t den = 2 * (n * WILSON_SCALE + WILSON_Z2);
+
+    out->lowPpm = (center > spread) ? statsRatioPpm(center - spread, den) : 0;
+    uint32_t high = statsRatioPpm(center + spread, den);
+    out->highPpm = (high > ONE_PPM) ? ONE_PPM : high;
+}
+
+uint32_t IRAM_ATTR statsSqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ULL << 62;
+    while (bit > value) bit >>= 2;
+
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+void statsFormatPercent(uint32_t ppm, char* buffer, size_t bufferSize) {
+    uint32_t hundredths = (ppm + 50) / 100;
+    snprintf(buffer, bufferSize, "%lu.%02lu%%", (unsigned long)(hundredths / 100),
+             (unsigned long)(hundredths % 100));
+}
+
+void statsFormatQ8(int32_t valueQ8, char* buffer, size_t bufferSize) {
+    uint32_t magnitude = (valueQ8 < 0) ? (uint32_t)(-(int64_t)valueQ8) : (uint32_t)valueQ8;
+    uint32_t hundredths = (uint32_t)(((uint64_t)magnitude * 100 + 128) / 256);
+    snprintf(buffer, bufferSize, "%s%lu.%02lu", (valueQ8 < 0 && hundredths > 0) ? "-" : "",
+             (unsigned long)(hundredths / 100), (unsigned long)(hundredths % 100));
+}
@@ -0,0 +1,91 @@
+#ifndef FIXED_STATS_H
+#define FIXED_STATS_H
+
+#include <Arduino.h>
+
+// Integer-only statistics: running mean/variance, exponentially
+// weighted event rate and a confidence interval for a success ratio.
+// No float or libm anywhere, so the device and the host produce
+// bit-identical results. Plain structs - callers serialise updates
+// against reads.
+//
+// Fixed-point suffixes: Q8 = value * 256, Q24 = value * 2^24,
+// Ppm = parts per million (1000000 = 100%).
+
+// ============================================================
+//                    WELFORD MEAN / VARIANCE
+// ============================================================
+
+// Running mean and variance of integer samples (|x| < 2^21, clamped).
+// One 32-bit divide and one 32x32->64 multiply per sample.
+struct WelfordStats {
+    uint32_t count;      // Stops growing at 2^30
+    int32_t meanQ8;      // Mean is exactly meanQ8 + remainder / count
+    int32_t remainder;   // 0 <= remainder < count
+    int64_t m2Q16;       // Sum of squared deviations
+};
+
+void welfordInit(WelfordStats* stats);
+
+// IRAM-resident: called per received ping
+void welfordAdd(WelfordStats* stats, int32_t sample);
+
+int32_t welfordMeanQ8(const WelfordStats* stats);
+
+// Sample standard deviation (0 until two samples)
+uint32_t welfordStdDevQ8(const WelfordStats* stats);
+
+// ============================================================
+//                    EWMA EVENT RATE
+// ============================================================
+
+// Fraction of recent trials that were events (e.g. lost pings),
+// weighted so a trial halfLife trials ago counts half as much.
+struct EwmaRate {
+    uint32_t rateQ24;  // Current estimate, 0..2^24
+    uint32_t keepQ16;  // Weight kept per trial, keep^halfLife = 1/2
+    uint32_t halfLife;
+};
+
+// halfLife in trials (>= 1)
+void ewmaInit(EwmaRate* ewma, uint32_t halfLife);
+
+// Add count trials that all were (event) or were not (!event) events.
+// A run costs O(log count), so a long outage is as cheap as one trial.
+// IRAM-resident: called per received ping
+void ewmaAddRun(EwmaRate* ewma, bool event, uint32_t count);
+
+// Turn the event trial added age trials ago (0 = the latest) into a
+// non-event, e.g. a ping counted lost that turned up late. The
+// estimate is linear in its trials, so this is exact. IRAM-resident.
+void ewmaUndoEvent(EwmaRate* ewma, uint32_t age);
+
+uint32_t ewmaRatePpm(const EwmaRate* ewma);
+
+// ============================================================
+//                    RATIOS AND INTERVALS
+// ============================================================
+
+// num / den rounded to ppm (den 0 gives 1000000)
+uint32_t statsRatioPpm(uint64_t num, uint64_t den);
+
+// 95% Wilson score interval for successes out of trials
+// (z = 1.96; both bounds 0..1000000, {0, 1000000} for no trials).
+// This, statsRatioPpm() and statsSqrt64() are IRAM-resident: the
+// link alarm calls them from the receive path.
+struct WilsonInterval {
+    uint32_t lowPpm;
+    uint32_t highPpm;
+};
+void statsWilsonInterval(uint32_t successes, uint32_t trials, WilsonInterval* out);
+
+// Floor of the square root
+uint32_t statsSqrt64(uint64_t value);
+
+// Format ppm as a percentage with two decimals ("99.87%")
+void statsFormatPercent(uint32_t ppm, char* buffer, size_t bufferSize);
+
+// Format a Q8 value with two decimals ("-50.25")
+void statsFormatQ8(int32_t valueQ8, char* buffer, size_t bufferSize);
+
+#endif
@@ -0,0 +1,90 @@
+#include "loss_window.h"
+
+static_assert(LOSS_WINDOW_PACKETS % 32 == 0, "Packet window must be whole words");
+static_assert(LOSS_WINDOW_SECONDS > 0, "Time window needs a bucket");
+
+static inline void IRAM_ATTR _pushSlot(LossWindow* window, bool lost) {
+    uint32_t word = window->head / 32;
+    uint32_t mask = 1u << (window->head % 32);
+    if (lost) {
+        window->lostBits[word] |= mask;
+    } else {
+        window->lostBits[word] &= ~mask;
+    }
+    window->head = (window->head + 1) % LOSS_WINDOW_PACKETS;
+    if (window->filled < LOSS_WINDOW_PACKETS) window->filled++;
+}
+
+// Bucket for the second of nowMs, cleared if it last held an older second
+static inline uint32_t IRAM_ATTR _bucket(LossWindow* window, uint32_t nowMs) {
+    uint32_t second = nowMs / 1000;
+    uint32_t index = second % LOSS_WINDOW_SECONDS;
+    if (window->bucketSecond[index] != second) {
+        window->bucketSecond[index] = second;
+        window->bucketReceived[index] = 0;
+        window->bucketLost[index] = 0;
+    }
+    return index;
+}
+
+void lossWindowInit(LossWindow* window) {
+    memset(window, 0, sizeof(*window));
+}
+
+void IRAM_ATTR lossWindowAdd(LossWindow* window, uint32_t lost, uint32_t skipped, uint32_t nowMs) {
+    // A gap longer than the window only needs to fill it; the lost
+    // slots go last so a late ping finds its slot by age
+    uint32_t lostPushes = (lost < LOSS_WINDOW_PACKETS) ? lost : LOSS_WINDOW_PACKETS;
+    uint32_t skipPushes = (skipped < LOSS_WINDOW_PACKETS - lostPushes) ? skipped : LOSS_WINDOW_PACKETS - lostPushes;
+    for (uint32_t i = 0; i < skipPushes; i++) _pushSlot(window, false);
+    for (uint32_t i = 0; i < lostPushes; i++) _pushSlot(window, true);
+    _pushSlot(window, false);
+
+    uint32_t index = _bucket(window, nowMs);
+    uint32_t bucketReceived = window->bucketReceived[index] + 1 + skipped;
+    window->bucketReceived[index] = (bucketReceived < UINT16_MAX) ? bucketReceived : UINT16_MAX;
+    uint32_t bucketLost = window->bucketLost[index] + lost;
+    window->bucketLost[index] = (bucketLost < UINT16_MAX) ? bucketLost : UINT16_MAX;
+}
+
+bool IRAM_ATTR lossWindowLate(LossWindow* window, uint32_t age, uint32_t nowMs) {
+    if (age == 0 || age >= window->filled) return false;
+    uint32_t slot = (window->head + LOSS_WINDOW_PACKETS - 1 - age) % LOSS_WINDOW_PACKETS;
+    uint32_t mask = 1u << (slot % 32);
+    if ((window->lostBits[slot / 32] & mask) == 0) return false;
+    window->lostBits[slot / 32] &= ~mask;
+
+    // The gap was counted in the second its next ping arrived, which a
+    // late ping follows closely: take it back from the newest second
+    // with a loss
+    uint32_t second = nowMs / 1000;
+    for (uint32_t back = 0; back < LOSS_WINDOW_SECONDS; back++) {
+        uint32_t index = (second - back) % LOSS_WINDOW_SECONDS;
+        if (window->bucketSecond[index] != second - back || window->bucketLost[index] == 0) continue;
+        window->bucketLost[index]--;
+        if (window->bucketReceived[index] < UINT16_MAX) window->bucketReceived[index]++;
+        break;
+    }
+    return true;
+}
+
+void IRAM_ATTR lossWindowPackets(const LossWindow* window, LossWindowCounts* counts) {
+    uint32_t lost = 0;
+    for (int i = 0; i < LOSS_WINDOW_WORDS; i++) {
+        lost += __builtin_popcount(window->lostBits[i]);
+    }
+    counts->slots = window->filled;
+    counts->lost = lost;
+}
+
+void IRAM_ATTR lossWindowSeconds(const LossWindow* window, uint32_t nowMs, LossWindowCounts* counts) {
+    uint32_t second = nowMs / 1000;
+    counts->slots = 0;
+    counts->lost = 0;
+    for (int i = 0; i < LOSS_WINDOW_SECONDS; i++) {
+        uint32_t age = second - window->bucketSecond[i];
+        if (age >= LOSS_WINDOW_SECONDS) continue;
+        counts->slots += window->bucketReceived[i] + window->bucketLost[i];
+        counts->lost += window->bucketLost[i];
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef LOSS_WINDOW_H
+#define LOSS_WINDOW_H
+
+#include <Arduino.h>
+
+// Ping slots in the packet window (multiple of 32)
+#ifndef LOSS_WINDOW_PACKETS
+#define LOSS_WINDOW_PACKETS 128
+#endif
+
+// Seconds in the time window (one bucket each)
+#ifndef LOSS_WINDOW_SECONDS
+#define LOSS_WINDOW_SECONDS 8
+#endif
+
+#define LOSS_WINDOW_WORDS (LOSS_WINDOW_PACKETS / 32)
+
+// Sliding-window loss over the last LOSS_WINDOW_PACKETS ping slots
+// and the last LOSS_WINDOW_SECONDS seconds, both O(1) per ping:
+// - a bit-ring with one bit per slot (1 = lost), counted with popcount
+// - per-second buckets of received/lost, recycled when their second
+//   has left the window
+//
+// 84 bytes. Plain struct - callers serialise.
+struct LossWindow {
+    uint32_t lostBits[LOSS_WINDOW_WORDS];
+    uint16_t head;    // Next slot to write
+    uint16_t filled;  // Slots written, up to LOSS_WINDOW_PACKETS
+    uint16_t bucketReceived[LOSS_WINDOW_SECONDS];
+    uint16_t bucketLost[LOSS_WINDOW_SECONDS];
+    uint32_t bucketSecond[LOSS_WINDOW_SECONDS];  // millis() / 1000 the bucket counts
+};
+
+// Counts over one window
+struct LossWindowCounts {
+    uint32_t slots;  // Ping slots seen (received + lost)
+    uint32_t lost;
+};
+
+void lossWindowInit(LossWindow* window);
+
+// Account a gap followed by one received ping at nowMs (millis()):
+// skipped slots the receiver dropped itself (they crossed the air, so
+// they take a slot but are not lost), then lost slots. This and the
+// functions below are IRAM-resident: called per frame.
+void lossWindowAdd(LossWindow* window, uint32_t lost, uint32_t skipped, uint32_t nowMs);
+
+// A late (reordered) ping for the slot age slots before the newest one
+// arrived at nowMs. If that slot is in the window and was counted lost
+// it becomes received, in the ring and in the newest second that still
+// holds a loss, and true is returned. False means a duplicate or a
+// ping too old for the window: nothing changes.
+bool lossWindowLate(LossWindow* window, uint32_t age, uint32_t nowMs);
+
+// Last LOSS_WINDOW_PACKETS ping slots
+void lossWindowPackets(const LossWindow* window, LossWindowCounts* counts);
+
+// Slots seen in the last LOSS_WINDOW_SECONDS seconds before nowMs
+void lossWindowSeconds(const LossWindow* window, uint32_t nowMs, LossWindowCounts* counts);
+
+#endif
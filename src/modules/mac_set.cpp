@@ -0,0 +1,134 @@
+#include "mac_set.h"
+
+// Displacements tried before the table is rebuilt with a new seed
+#define MAC_SET_MAX_KICKS   (MAC_SET_SLOTS * 2)
+#define MAC_SET_MAX_REBUILD 16
+
+static inline uint64_t IRAM_ATTR _pack(const uint8_t* mac) {
+    return ((uint64_t)mac[0] << 40) | ((uint64_t)mac[1] << 32) | ((uint64_t)mac[2] << 24) |
+           ((uint64_t)mac[3] << 16) | ((uint64_t)mac[4] << 8) | (uint64_t)mac[5];
+}
+
+static inline void _unpack(uint64_t key, uint8_t* mac) {
+    for (int i = 5; i >= 0; i--) {
+        mac[i] = (uint8_t)key;
+        key >>= 8;
+    }
+}
+
+// Multiply-shift hash reduced from the top bits of the product, which
+// depend on every key bit (the low bits miss the first MAC byte)
+static inline uint32_t IRAM_ATTR _reduce(uint64_t product) {
+    return (uint32_t)(((product >> 32) * MAC_SET_SLOTS) >> 32);
+}
+
+// Two hashes; the second slot never equals the first
+static inline uint32_t IRAM_ATTR _slot1(const MacSet* set, uint64_t key) {
+    return _reduce((key ^ set->seed) * 0x9E3779B97F4A7C15ULL);
+}
+
+static inline uint32_t IRAM_ATTR _slot2(const MacSet* set, uint64_t key) {
+    uint32_t slot = _reduce((key ^ set->seed) * 0xC2B2AE3D27D4EB4FULL);
+    return (slot == _slot1(set, key)) ? (slot + 1) % MAC_SET_SLOTS : slot;
+}
+
+// Place key by displacing occupants to their other slot.
+// Returns MAC_SET_EMPTY on success, else the key left homeless.
+static uint64_t _place(MacSet* set, uint64_t key) {
+    uint32_t slot = _slot1(set, key);
+    for (int kick = 0; kick < MAC_SET_MAX_KICKS; kick++) {
+        uint64_t evicted = set->slots[slot];
+        set->slots[slot] = key;
+        if (evicted == MAC_SET_EMPTY) return MAC_SET_EMPTY;
+
+        key = evicted;
+        uint32_t first = _slot1(set, key);
+        slot = (slot == first) ? _slot2(set, key) : first;
+    }
+    return key;
+}
+
+// Re-hash every key plus pending under new seeds until all fit
+static bool _rebuild(MacSet* set, uint64_t pending) {
+    uint64_t keys[MAC_SET_SLOTS + 1];
+    int count = 0;
+    for (int i = 0; i < MAC_SET_SLOTS; i++) {
+        if (set->slots[i] != MAC_SET_EMPTY) keys[count++] = set->slots[i];
+    }
+    keys[count++] = pending;
+
+    uint64_t original[MAC_SET_SLOTS];
+    memcpy(original, set->slots, sizeof(original));
+    uint64_t originalSeed = set->seed;
+
+    for (int attempt = 0; attempt < MAC_SET_MAX_REBUILD; attempt++) {
+        set->seed = set->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        for (int i = 0; i < MAC_SET_SLOTS; i++) set->slots[i] = MAC_SET_EMPTY;
+
+        int placed = 0;
+        while (placed < count && _place(set, keys[placed]) == MAC_SET_EMPTY) placed++;
+        if (placed == count) return true;
+    }
+
+    // Give up and leave the set as it was
+    memcpy(set->slots, original, sizeof(original));
+    set->seed = originalSeed;
+    return false;
+}
+
+void macSetInit(MacSet* set) {
+    for (int i = 0; i < MAC_SET_SLOTS; i++) set->slots[i] = MAC_SET_EMPTY;
+    set->seed = 0x243F6A8885A308D3ULL;
+    set->count = 0;
+}
+
+bool macSetAdd(MacSet* set, const uint8_t* mac) {
+    if (macSetContains(set, mac)) return true;
+    if (set->count >= MAC_SET_CAPACITY) return false;
+
+    uint64_t key = _pack(mac);
+    uint64_t snapshot[MAC_SET_SLOTS];
+    memcpy(snapshot, set->slots, sizeof(snapshot));
+
+    uint64_t homeless = _place(set, key);
+    if (homeless != MAC_SET_EMPTY) {
+        // Displacement cycled: undo and rebuild with the new key included
+        memcpy(set->slots, snapshot, sizeof(snapshot));
+        if (!_rebuild(set, key)) return false;
+    }
+
+    set->count++;
+    return true;
+}
+
+bool macSetRemove(MacSet* set, const uint8_t* mac) {
+    uint64_t key = _pack(mac);
+    uint32_t slots[2] = {_slot1(set, key), _slot2(set, key)};
+    for (int i = 0; i < 2; i++) {
+        if (set->slots[slots[i]] == key) {
+            set->slots[slots[i]] = MAC_SET_EMPTY;
+            set->count--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool IRAM_ATTR macSetContains(const MacSet* set, const uint8_t* mac) {
+    uint64_t key = _pack(mac);
+    return (set->slots[_slot1(set, key)] == key) | (set->slots[_slot2(set, key)] == key);
+}
+
+int macSetCount(const MacSet* set) {
+    return set->count;
+}
+
+int macSetGetAll(const MacSet* set, uint8_t (*out)[6], int maxEntries) {
+    int count = 0;
+    for (int i = 0; i < MAC_SET_SLOTS && count < maxEntries; i++) {
+        if (set->slots[i] != MAC_SET_EMPTY) {
+            _unpack(set->slots[i], out[count++]);
+        }
+    }
+    return count;
+}
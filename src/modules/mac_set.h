@@ -0,0 +1,44 @@
+#ifndef MAC_SET_H
+#define MAC_SET_H
+
+#include <Arduino.h>
+
+// Capacity of the set; the table has twice as many slots
+#ifndef MAC_SET_CAPACITY
+#define MAC_SET_CAPACITY 16
+#endif
+#define MAC_SET_SLOTS (MAC_SET_CAPACITY * 2)
+
+// Fixed-size cuckoo hash set of MAC addresses.
+// Every MAC lives in one of its two candidate slots, so a lookup is two
+// loads and two compares with no probing loop. Inserts displace entries
+// between their slots and reseed the hashes if that cycles.
+// Plain struct - callers serialise changes against lookups.
+struct MacSet {
+    uint64_t slots[MAC_SET_SLOTS];  // Packed 48-bit MACs, MAC_SET_EMPTY if free
+    uint64_t seed;                  // Mixed into both hashes, changed on rebuild
+    uint8_t count;
+};
+
+// Never a valid packed MAC (only the low 48 bits are used)
+#define MAC_SET_EMPTY 0xFFFFFFFFFFFFFFFFULL
+
+// Start empty
+void macSetInit(MacSet* set);
+
+// Add mac. Returns false if the set is full (true if already present).
+bool macSetAdd(MacSet* set, const uint8_t* mac);
+
+// Remove mac. Returns false if it was not present.
+bool macSetRemove(MacSet* set, const uint8_t* mac);
+
+// Membership test - IRAM-resident, called from the WiFi task
+bool macSetContains(const MacSet* set, const uint8_t* mac);
+
+// Number of MACs in the set
+int macSetCount(const MacSet* set);
+
+// Copy the MACs into out (up to maxEntries). Returns the number copied.
+int macSetGetAll(const MacSet* set, uint8_t (*out)[6], int maxEntries);
+
+#endif
@@ -0,0 +1,134 @@
+#include "p2_quantiles.h"
+
+// Desired marker ranks as fractions of the stream (Q16):
+// min, p50/2, p50, (p50+p95)/2, p95, (p95+p99)/2, p99, (p99+1)/2, max
+static const DRAM_ATTR uint32_t MARKER_FRACTION_Q16[P2_MARKERS] = {
+    0, 16384, 32768, 47514, 62259, 63570, 64881, 65208, 65536,
+};
+
+// Marker holding each P2Quantile
+static const uint8_t QUANTILE_MARKER[3] = {2, 4, 6};
+
+#define P2_MAX_COUNT 65535
+#define P2_ONE (1 << P2_FRACTION_BITS)
+
+static inline int32_t IRAM_ATTR _clampSample(int32_t value) {
+    if (value > P2_SAMPLE_MAX) return P2_SAMPLE_MAX;
+    if (value < -P2_SAMPLE_MAX) return -P2_SAMPLE_MAX;
+    return value;
+}
+
+// x / 256 rounded to nearest, halves away from zero
+static inline int32_t IRAM_ATTR _roundShift8(int64_t x) {
+    return (int32_t)((x >= 0) ? (x + 128) >> 8 : -((-x + 128) >> 8));
+}
+
+// Piecewise-parabolic prediction of marker i moved by s (+1/-1), Q4
+static int32_t IRAM_ATTR _parabolic(const P2Quantiles* est, int i, int s) {
+    int32_t qPrev = est->height[i - 1];
+    int32_t q = est->height[i];
+    int32_t qNext = est->height[i + 1];
+    int32_t nPrev = est->position[i - 1];
+    int32_t n = est->position[i];
+    int32_t nNext = est->position[i + 1];
+
+    // 8 extra fraction bits, rounded off at the end: the move is often
+    // well under one Q4 step and truncating it would pin the marker
+    int64_t a = ((int64_t)(n - nPrev + s) * (qNext - q) << 8) / (nNext - n);
+    int64_t b = ((int64_t)(nNext - n - s) * (q - qPrev) << 8) / (n - nPrev);
+    return q + _roundShift8(s * (a + b) / (nNext - nPrev));
+}
+
+// Halve all ranks so 16-bit positions never overflow; keeps ranks distinct
+static void IRAM_ATTR _halve(P2Quantiles* est) {
+    for (int i = 0; i < P2_MARKERS; i++) {
+        uint16_t halved = 1 + (est->position[i] - 1) / 2;
+        uint16_t floor = (i > 0) ? est->position[i - 1] + 1 : 1;
+        est->position[i] = (halved > floor) ? halved : floor;
+    }
+    est->count = est->position[P2_MARKERS - 1];
+}
+
+void p2Init(P2Quantiles* est) {
+    memset(est, 0, sizeof(*est));
+}
+
+void IRAM_ATTR p2Add(P2Quantiles* est, int32_t sample) {
+    int16_t x = (int16_t)(_clampSample(sample) * P2_ONE);
+
+    // First samples: keep them sorted, they become the markers
+    if (est->count < P2_MARKERS) {
+        int i = est->count;
+        while (i > 0 && est->height[i - 1] > x) {
+            est->height[i] = est->height[i - 1];
+            i--;
+        }
+        est->height[i] = x;
+        est->count++;
+        if (est->count == P2_MARKERS) {
+            for (int m = 0; m < P2_MARKERS; m++) est->position[m] = m + 1;
+        }
+        return;
+    }
+
+    if (est->count >= P2_MAX_COUNT) _halve(est);
+
+    // Cell the sample falls in; extremes move the end markers
+    int k;
+    if (x < est->height[0]) {
+        est->height[0] = x;
+        k = 0;
+    } else if (x >= est->height[P2_MARKERS - 1]) {
+        est->height[P2_MARKERS - 1] = x;
+        k = P2_MARKERS - 2;
+    } else {
+        k = 0;
+        while (k < P2_MARKERS - 2 && x >= est->height[k + 1]) k++;
+    }
+
+    for (int i = k + 1; i < P2_MARKERS; i++) est->position[i]++;
+    est->count++;
+
+    // Nudge interior markers towards their desired ranks
+    for (int i = 1; i < P2_MARKERS - 1; i++) {
+        int64_t desiredQ16 = 65536 + (int64_t)(est->count - 1) * MARKER_FRACTION_Q16[i];
+        int64_t offsetQ16 = desiredQ16 - (int64_t)est->position[i] * 65536;
+        int gapNext = est->position[i + 1] - est->position[i];
+        int gapPrev = est->position[i - 1] - est->position[i];
+
+        int s;
+        if (offsetQ16 >= 65536 && gapNext > 1) {
+            s = 1;
+        } else if (offsetQ16 <= -65536 && gapPrev < -1) {
+            s = -1;
+        } else {
+            continue;
+        }
+
+        int32_t q = _parabolic(est, i, s);
+        if (q <= est->height[i - 1] || q >= est->height[i + 1]) {
+            // Parabola overshoots a neighbour: fall back to linear
+            int32_t neighbour = est->height[i + s];
+            int32_t distance = est->position[i + s] - est->position[i];
+            q = est->height[i] + _roundShift8(((int64_t)s * (neighbour - est->height[i]) << 8) / distance);
+        }
+        est->height[i] = (int16_t)q;
+        est->position[i] += s;
+    }
+}
+
+int16_t p2Get(const P2Quantiles* est, P2Quantile quantile) {
+    if (est->count == 0) return 0;
+
+    if (est->count < P2_MARKERS) {
+        // Nearest rank among the sorted first samples
+        uint32_t rank = (est->count * MARKER_FRACTION_Q16[QUANTILE_MARKER[quantile]] + 65535) >> 16;
+        return (int16_t)(est->height[(rank > 0) ? rank - 1 : 0] / P2_ONE);
+    }
+    int32_t q = est->height[QUANTILE_MARKER[quantile]];
+    return (int16_t)((q >= 0) ? (q + P2_ONE / 2) / P2_ONE : -((-q + P2_ONE / 2) / P2_ONE));
+}
+
+uint16_t p2Count(const P2Quantiles* est) {
+    return est->count;
+}
@@ -0,0 +1,44 @@
+#ifndef P2_QUANTILES_H
+#define P2_QUANTILES_H
+
+#include <Arduino.h>
+
+// Streaming p50/p95/p99 in constant memory: the extended P² algorithm
+// (Jain & Chlamtac, Raatikainen) with 9 markers whose heights follow
+// the quantiles and the midpoints between them. Integer samples,
+// Q4 16-bit marker heights and integer math, so device and host agree
+// bit for bit. Samples are clamped to +-P2_SAMPLE_MAX (ms or dB).
+//
+// Marker positions are 16-bit: when 65535 samples are reached they
+// are halved, so the estimate follows the most recent ~32k-64k
+// samples rather than freezing on ancient history.
+//
+// 38 bytes per estimator. Plain struct - callers serialise.
+
+#define P2_MARKERS 9
+#define P2_FRACTION_BITS 4
+#define P2_SAMPLE_MAX (INT16_MAX >> P2_FRACTION_BITS)  // 2047
+
+enum P2Quantile {
+    P2_P50 = 0,
+    P2_P95 = 1,
+    P2_P99 = 2,
+};
+
+struct P2Quantiles {
+    int16_t height[P2_MARKERS];     // Marker values, Q4
+    uint16_t position[P2_MARKERS];  // 1-based rank of each marker
+    uint16_t count;                 // Samples seen (after halving)
+};
+
+void p2Init(P2Quantiles* est);
+
+// IRAM-resident: called per received frame
+void p2Add(P2Quantiles* est, int32_t sample);
+
+// Estimate of the requested quantile (exact until 9 samples; 0 if none)
+int16_t p2Get(const P2Quantiles* est, P2Quantile quantile);
+
+uint16_t p2Count(const P2Quantiles* est);
+
+#endif
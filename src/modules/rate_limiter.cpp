@@ -0,0 +1,90 @@
+#include "rate_limiter.h"
+
+// Slot for mac: the existing entry, else a free one, else the least
+// recently used (evicted). New and evicted slots start with a full bucket.
+static RateLimitEntry* IRAM_ATTR _findOrEvict(RateLimiter* limiter, const uint8_t* mac, uint32_t nowUs) {
+    RateLimitEntry* victim = nullptr;
+
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        RateLimitEntry* entry = &limiter->entries[i];
+        if (!entry->used) {
+            if (victim == nullptr || victim->used) victim = entry;
+            continue;
+        }
+        if (memcmp(entry->mac, mac, 6) == 0) return entry;
+        if (victim == nullptr || (victim->used && entry->lastUsed < victim->lastUsed)) {
+            victim = entry;
+        }
+    }
+
+    if (victim->used) limiter->evictions++;
+    memcpy(victim->mac, mac, 6);
+    victim->used = true;
+    victim->tokensMilli = limiter->burst * 1000;
+    victim->refillUs = nowUs;
+    victim->allowed = 0;
+    victim->throttled = 0;
+    return victim;
+}
+
+void rateLimiterInit(RateLimiter* limiter, uint32_t ratePps, uint32_t burst) {
+    memset(limiter, 0, sizeof(*limiter));
+    limiter->ratePps = ratePps;
+    limiter->burst = (burst > 0) ? burst : 1;
+}
+
+bool IRAM_ATTR rateLimiterAllow(RateLimiter* limiter, const uint8_t* mac, uint32_t nowUs) {
+    if (limiter->ratePps == 0) return true;
+
+    RateLimitEntry* entry = _findOrEvict(limiter, mac, nowUs);
+    entry->lastUsed = ++limiter->clock;
+
+    // Refill for the time since the last frame, capped at a full bucket
+    uint32_t capacity = limiter->burst * 1000;
+    uint32_t elapsedUs = nowUs - entry->refillUs;
+    entry->refillUs = nowUs;
+    uint64_t refill = ((uint64_t)elapsedUs * limiter->ratePps) / 1000;
+    uint64_t level = entry->tokensMilli + refill;
+    entry->tokensMilli = (level > capacity) ? capacity : (uint32_t)level;
+
+    if (entry->tokensMilli < 1000) {
+        entry->throttled++;
+        limiter->throttled++;
+        return false;
+    }
+
+    entry->tokensMilli -= 1000;
+    entry->allowed++;
+    return true;
+}
+
+int rateLimiterGetSources(const RateLimiter* limiter, RateLimitEntry* out, int maxEntries) {
+    int count = 0;
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE && count < maxEntries; i++) {
+        if (limiter->entries[i].used) {
+            out[count++] = limiter->entries[i];
+        }
+    }
+
+    // Insertion sort by total frames, busiest first (at most 16 entries)
+    for (int i = 1; i < count; i++) {
+        RateLimitEntry entry = out[i];
+        uint32_t total = entry.allowed + entry.throttled;
+        int j = i - 1;
+        while (j >= 0 && out[j].allowed + out[j].throttled < total) {
+            out[j + 1] = out[j];
+            j--;
+        }
+        out[j + 1] = entry;
+    }
+    return count;
+}
+
+void rateLimiterResetCounters(RateLimiter* limiter) {
+    for (int i = 0; i < RATE_LIMIT_TABLE_SIZE; i++) {
+        limiter->entries[i].allowed = 0;
+        limiter->entries[i].throttled = 0;
+    }
+    limiter->throttled = 0;
+    limiter->evictions = 0;
+}
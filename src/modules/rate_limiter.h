@@ -0,0 +1,48 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+
+// Sources tracked at once; the least recently seen MAC is evicted
+#ifndef RATE_LIMIT_TABLE_SIZE
+#define RATE_LIMIT_TABLE_SIZE 16
+#endif
+
+// Per-source-MAC token bucket state
+struct RateLimitEntry {
+    uint8_t mac[6];
+    bool used;
+    uint32_t tokensMilli;  // Bucket level in 1/1000 frame
+    uint32_t refillUs;     // micros() of the last refill
+    uint32_t lastUsed;     // LRU stamp (limiter clock at last frame)
+    uint32_t allowed;      // Frames let through
+    uint32_t throttled;    // Frames refused for lack of tokens
+};
+
+// Fixed-size token bucket table. Plain struct so the device and the
+// host loopback can each own one. Not thread-safe: callers serialise.
+struct RateLimiter {
+    RateLimitEntry entries[RATE_LIMIT_TABLE_SIZE];
+    uint32_t ratePps;    // Sustained frames/s per source (0 = no limit)
+    uint32_t burst;      // Bucket depth in frames
+    uint32_t clock;      // Advances once per frame, for LRU
+    uint32_t throttled;  // Total frames refused
+    uint32_t evictions;  // Sources pushed out of the table
+};
+
+// Start with an empty table. ratePps 0 lets every frame through.
+void rateLimiterInit(RateLimiter* limiter, uint32_t ratePps, uint32_t burst);
+
+// Charge one frame from mac at nowUs (micros()). Returns false if the
+// source is over its rate and the frame should be dropped.
+// IRAM-resident: called from the WiFi task receive callback.
+bool rateLimiterAllow(RateLimiter* limiter, const uint8_t* mac, uint32_t nowUs);
+
+// Copy the tracked sources into out (up to maxEntries), busiest first.
+// Returns the number copied.
+int rateLimiterGetSources(const RateLimiter* limiter, RateLimitEntry* out, int maxEntries);
+
+// Clear per-source counters and totals (buckets and table kept)
+void rateLimiterResetCounters(RateLimiter* limiter);
+
+#endif
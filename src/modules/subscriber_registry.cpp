@@ -0,0 +1,64 @@
+#include "subscriber_registry.h"
+
+static inline uint64_t IRAM_ATTR _packMac(const uint8_t* mac) {
+    return ((uint64_t)mac[0] << 40) | ((uint64_t)mac[1] << 32) | ((uint64_t)mac[2] << 24) |
+           ((uint64_t)mac[3] << 16) | ((uint64_t)mac[4] << 8) | (uint64_t)mac[5];
+}
+
+void espnowFilterAll(EspNowFilter* filter) {
+    memset(filter, 0, sizeof(*filter));
+    filter->magic = -1;
+    filter->minLen = 0;
+    filter->maxLen = ESPNOW_FRAME_MAX_LEN;
+}
+
+int subscriberRegistryAdd(SubscriberRegistry* registry, const EspNowFilter* filter,
+                          EspNowFrameHandler handler, void* context) {
+    for (int i = 0; i < ESPNOW_MAX_SUBSCRIBERS; i++) {
+        SubscriberEntry* entry = &registry->entries[i];
+        if (entry->active) continue;
+
+        entry->macValue = _packMac(filter->mac) & _packMac(filter->macMask);
+        entry->macMask = _packMac(filter->macMask);
+        entry->magicValue = (filter->magic >= 0) ? (uint8_t)filter->magic : 0;
+        entry->magicMask = (filter->magic >= 0) ? 0xFF : 0x00;
+        entry->minLen = filter->minLen;
+        entry->maxLen = filter->maxLen;
+        entry->handler = handler;
+        entry->context = context;
+        entry->delivered = 0;
+
+        // Publish only once the entry is complete
+        __atomic_store_n(&entry->active, true, __ATOMIC_RELEASE);
+        return i;
+    }
+    return -1;
+}
+
+void subscriberRegistryRemove(SubscriberRegistry* registry, int id) {
+    if (id < 0 || id >= ESPNOW_MAX_SUBSCRIBERS) return;
+    __atomic_store_n(&registry->entries[id].active, false, __ATOMIC_RELEASE);
+}
+
+int IRAM_ATTR subscriberRegistryDispatch(SubscriberRegistry* registry, const EspNowFrame* frame) {
+    // Per-frame values computed once, then each filter is three compares
+    uint64_t mac = _packMac(frame->mac);
+    uint8_t first = (frame->len > 0) ? frame->data[0] : 0;
+    uint16_t len = (uint16_t)frame->len;
+    int matched = 0;
+
+    for (int i = 0; i < ESPNOW_MAX_SUBSCRIBERS; i++) {
+        SubscriberEntry* entry = &registry->entries[i];
+        if (!__atomic_load_n(&entry->active, __ATOMIC_ACQUIRE)) continue;
+
+        bool match = ((mac & entry->macMask) == entry->macValue) &
+                     ((first & entry->magicMask) == entry->magicValue) &
+                     (len >= entry->minLen) & (len <= entry->maxLen);
+        if (!match) continue;
+
+        entry->handler(frame, entry->context);
+        entry->delivered++;
+        matched++;
+    }
+    return matched;
+}
@@ -0,0 +1,76 @@
+#ifndef SUBSCRIBER_REGISTRY_H
+#define SUBSCRIBER_REGISTRY_H
+
+#include <Arduino.h>
+
+// Receive subscribers registered at once
+#ifndef ESPNOW_MAX_SUBSCRIBERS
+#define ESPNOW_MAX_SUBSCRIBERS 4
+#endif
+
+// Largest ESP-NOW payload (ESP_NOW_MAX_DATA_LEN)
+#define ESPNOW_FRAME_MAX_LEN 250
+
+// A received frame as it sits in the receive ring. Subscribers get a
+// read-only pointer to the ring slot itself, valid only for the
+// duration of the call - copy out anything needed later.
+struct EspNowFrame {
+    uint8_t mac[6];       // Sender
+    int8_t rssi;          // dBm, 0 if unknown
+    int len;
+    uint32_t enqueuedUs;  // micros() when the frame entered the ring
+    uint8_t data[ESPNOW_FRAME_MAX_LEN];
+};
+
+// Which frames a subscriber wants. Start from espnowFilterAll() and
+// narrow it: all set conditions must match.
+struct EspNowFilter {
+    uint8_t mac[6];      // Sender MAC, compared under macMask
+    uint8_t macMask[6];  // All zero = any sender
+    int16_t magic;       // Required first payload byte, -1 = any
+    uint16_t minLen;     // Payload length range (inclusive)
+    uint16_t maxLen;
+};
+
+// Subscriber callback. Runs on the ESP-NOW task (Core 0), once per
+// matching frame; place it in IRAM (IRAM_ATTR) like any receive handler.
+typedef void (*EspNowFrameHandler)(const EspNowFrame* frame, void* context);
+
+// Filter that matches every frame
+void espnowFilterAll(EspNowFilter* filter);
+
+// Filter compiled for the dispatch loop: packed MAC compare, magic
+// mask and length range - no per-byte loops on the hot path
+struct SubscriberEntry {
+    volatile bool active;
+    uint64_t macValue;
+    uint64_t macMask;
+    uint8_t magicValue;
+    uint8_t magicMask;   // 0xFF when the magic byte is checked
+    uint16_t minLen;
+    uint16_t maxLen;
+    EspNowFrameHandler handler;
+    void* context;
+    uint32_t delivered;  // Frames this subscriber received
+};
+
+// Fixed table of subscribers. add/remove come from setup or the loop,
+// dispatch from the ESP-NOW task: an entry is filled in before it is
+// marked active, and a handler may see one more frame after removal.
+struct SubscriberRegistry {
+    SubscriberEntry entries[ESPNOW_MAX_SUBSCRIBERS];
+};
+
+// Register handler for frames matching filter.
+// Returns a subscriber id, or -1 if the table is full.
+int subscriberRegistryAdd(SubscriberRegistry* registry, const EspNowFilter* filter,
+                          EspNowFrameHandler handler, void* context);
+
+// Remove subscriber id (no-op for an unknown id)
+void subscriberRegistryRemove(SubscriberRegistry* registry, int id);
+
+// Hand frame to every matching subscriber, in registration order.
+// Returns the number of subscribers that received it.
+int subscriberRegistryDispatch(SubscriberRegistry* registry, const EspNowFrame* frame);
+
+#endif
@@ -0,0 +1,232 @@
+#include "transmitter_table.h"
+
+static void IRAM_ATTR _resetEntry(TransmitterEntry* entry, const uint8_t* mac) {
+    memcpy(entry->mac, mac, 6);
+    entry->used = true;
+    entry->timed = false;
+    entry->frames = 0;
+    entry->missed = 0;
+    entry->internal = 0;
+    entry->pendingDrops = 0;
+    entry->lastArrivalMs = 0;
+    entry->lastSenderMs = 0;
+    entry->lastSequence = 0;
+    entry->degraded = false;
+    p2Init(&entry->interArrival);
+    p2Init(&entry->pdv);
+    p2Init(&entry->rssi);
+    lossWindowInit(&entry->loss);
+    welfordInit(&entry->interArrivalStats);
+    welfordInit(&entry->rssiStats);
+    welfordInit(&entry->lossRuns);
+}
+
+static inline uint32_t IRAM_ATTR _ratePpm(const LossWindowCounts* counts) {
+    return (uint32_t)((uint64_t)counts->lost * 1000000 / counts->slots);
+}
+
+// True if either qualifying window's loss is at least alarmPpm with
+// 95% confidence
+static bool IRAM_ATTR _confidentAlarm(const TransmitterTable* table, const LossWindowCounts* packets,
+                                      const LossWindowCounts* seconds) {
+    const LossWindowCounts* windows[2] = {packets, seconds};
+    for (int i = 0; i < 2; i++) {
+        if (windows[i]->slots < table->alarm.minSlots) continue;
+        WilsonInterval interval;
+        statsWilsonInterval(windows[i]->lost, windows[i]->slots, &interval);
+        if (interval.lowPpm >= table->alarm.alarmPpm) return true;
+    }
+    return false;
+}
+
+// Sequence gap bookkeeping: lost slots before this frame, or -1 if the
+// frame is a duplicate or arrived late (behind lastSequence)
+static int64_t IRAM_ATTR _gap(TransmitterEntry* entry, uint32_t sequence, uint32_t senderMs) {
+    if (!entry->timed) {
+        entry->lastSequence = sequence;
+        return 0;
+    }
+
+    uint32_t step = sequence - entry->lastSequence;
+    if (step >= 1 && step < 0x80000000u) {
+        entry->lastSequence = sequence;
+        return step - 1;
+    }
+    if (step != 0 && senderMs + TRANSMITTER_RESTART_MS < entry->lastSenderMs) {
+        entry->lastSequence = sequence;  // Restarted: resynchronise without loss
+        return 0;
+    }
+    return -1;
+}
+
+// Slot for mac: the existing entry, else a free one, else the least
+// recently used (evicted). Most frames come from the transmitter of
+// the frame before, so that entry is tried first.
+static TransmitterEntry* IRAM_ATTR _findOrEvict(TransmitterTable* table, const uint8_t* mac) {
+    TransmitterEntry* hit = &table->entries[table->lastHit];
+    if (hit->used && memcmp(hit->mac, mac, 6) == 0) return hit;
+
+    TransmitterEntry* victim = nullptr;
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        TransmitterEntry* entry = &table->entries[i];
+        if (!entry->used) {
+            if (victim == nullptr || victim->used) victim = entry;
+            continue;
+        }
+        if (memcmp(entry->mac, mac, 6) == 0) {
+            table->lastHit = i;
+            return entry;
+        }
+        if (victim == nullptr || (victim->used && entry->lastUsed < victim->lastUsed)) {
+            victim = entry;
+        }
+    }
+
+    if (victim->used) table->evictions++;
+    _resetEntry(victim, mac);
+    table->lastHit = victim - table->entries;
+    return victim;
+}
+
+void transmitterTableInit(TransmitterTable* table, const LinkAlarmConfig* alarm) {
+    memset(table, 0, sizeof(*table));
+    table->alarm = *alarm;
+    if (table->alarm.minSlots == 0) table->alarm.minSlots = 1;
+}
+
+TransmitterEvent IRAM_ATTR transmitterTableRecord(TransmitterTable* table, const uint8_t* mac, uint32_t sequence,
+                                                  uint32_t arrivalMs, uint32_t senderMs, int8_t rssi) {
+    TransmitterEntry* entry = _findOrEvict(table, mac);
+    entry->lastUsed = ++table->clock;
+    entry->frames++;
+
+    int64_t gap = _gap(entry, sequence, senderMs);
+    uint32_t internal = 0;
+    if (gap > 0 && entry->pendingDrops > 0) {
+        // Drops reported ahead of this frame fill its gap first; any
+        // left over belong to a later gap (frames still queued)
+        internal = (entry->pendingDrops < gap) ? entry->pendingDrops : (uint32_t)gap;
+        entry->pendingDrops -= internal;
+        entry->internal += internal;
+        gap -= internal;
+    }
+    if (gap >= 0) lossWindowAdd(&entry->loss, (uint32_t)gap, internal, arrivalMs);
+    if (gap > 0) {
+        entry->missed += (uint32_t)gap;
+        welfordAdd(&entry->lossRuns, (int32_t)gap);
+    }
+    if (gap < 0 && lossWindowLate(&entry->loss, entry->lastSequence - sequence, arrivalMs)) {
+        // A late frame whose slot was counted lost: it was only
+        // reordered. Loss runs already recorded are left as they are.
+        if (entry->missed > 0) entry->missed--;
+    }
+
+    if (entry->timed) {
+        int32_t interArrivalMs = (int32_t)(arrivalMs - entry->lastArrivalMs);
+        p2Add(&entry->interArrival, interArrivalMs);
+        welfordAdd(&entry->interArrivalStats, interArrivalMs);
+
+        int32_t lastTransitMs = (int32_t)(entry->lastArrivalMs - entry->lastSenderMs);
+        int32_t ipdv = (int32_t)(arrivalMs - senderMs) - lastTransitMs;
+        if (ipdv < 0) ipdv = -ipdv;
+        if (ipdv <= TRANSMITTER_PDV_MAX_MS) p2Add(&entry->pdv, ipdv);
+    }
+    entry->timed = true;
+    entry->lastArrivalMs = arrivalMs;
+    entry->lastSenderMs = senderMs;
+
+    if (rssi != 0) {
+        p2Add(&entry->rssi, rssi);
+        welfordAdd(&entry->rssiStats, rssi);
+    }
+
+    // Hysteresis: raise when confidently above alarmPpm (the point
+    // estimate is checked first - the bound is never above it), clear
+    // at clearPpm
+    LossWindowCounts packets;
+    LossWindowCounts seconds;
+    uint32_t lossPpm = transmitterLossPpm(table, entry, arrivalMs, &packets, &seconds);
+    if (!entry->degraded && lossPpm >= table->alarm.alarmPpm && _confidentAlarm(table, &packets, &seconds)) {
+        entry->degraded = true;
+        return TRANSMITTER_EVENT_DEGRADED;
+    }
+    if (entry->degraded && lossPpm <= table->alarm.clearPpm) {
+        entry->degraded = false;
+        return TRANSMITTER_EVENT_OK;
+    }
+    return TRANSMITTER_EVENT_NONE;
+}
+
+void IRAM_ATTR transmitterTableRecordDrop(TransmitterTable* table, const uint8_t* mac, uint32_t sequence,
+                                          uint32_t nowMs) {
+    // Untracked senders have no gap to correct yet
+    TransmitterEntry* entry = (TransmitterEntry*)transmitterTableFind(table, mac);
+    if (entry == nullptr || !entry->timed) return;
+
+    // Drops ahead of the last recorded frame leave a gap; one behind it
+    // was counted lost with an earlier gap
+    uint32_t step = sequence - entry->lastSequence;
+    if (step >= 1 && step < 0x80000000u) {
+        entry->pendingDrops++;
+    } else if (step != 0 && lossWindowLate(&entry->loss, entry->lastSequence - sequence, nowMs)) {
+        if (entry->missed > 0) entry->missed--;
+        entry->internal++;
+    }
+}
+
+const TransmitterEntry* IRAM_ATTR transmitterTableFind(const TransmitterTable* table, const uint8_t* mac) {
+    const TransmitterEntry* hit = &table->entries[table->lastHit];
+    if (hit->used && memcmp(hit->mac, mac, 6) == 0) return hit;
+
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        const TransmitterEntry* entry = &table->entries[i];
+        if (entry->used && memcmp(entry->mac, mac, 6) == 0) return entry;
+    }
+    return nullptr;
+}
+
+uint32_t IRAM_ATTR transmitterLossPpm(const TransmitterTable* table, const TransmitterEntry* entry, uint32_t nowMs,
+                                      LossWindowCounts* packets, LossWindowCounts* seconds) {
+    LossWindowCounts packetCounts;
+    LossWindowCounts secondCounts;
+    if (packets == nullptr) packets = &packetCounts;
+    if (seconds == nullptr) seconds = &secondCounts;
+
+    lossWindowPackets(&entry->loss, packets);
+    lossWindowSeconds(&entry->loss, nowMs, seconds);
+
+    uint32_t lossPpm = 0;
+    if (packets->slots >= table->alarm.minSlots) lossPpm = _ratePpm(packets);
+    if (seconds->slots >= table->alarm.minSlots) {
+        uint32_t ppm = _ratePpm(seconds);
+        if (ppm > lossPpm) lossPpm = ppm;
+    }
+    return lossPpm;
+}
+
+int transmitterTableGetAll(const TransmitterTable* table, TransmitterEntry* out, int maxEntries) {
+    int count = 0;
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        const TransmitterEntry* entry = &table->entries[i];
+        if (!entry->used) continue;
+
+        // Keep the busiest maxEntries: insertion into a sorted prefix
+        int j = (count < maxEntries) ? count++ : maxEntries;
+        if (j == maxEntries && (maxEntries == 0 || out[j - 1].frames >= entry->frames)) continue;
+        if (j == maxEntries) j--;
+        while (j > 0 && out[j - 1].frames < entry->frames) {
+            out[j] = out[j - 1];
+            j--;
+        }
+        out[j] = *entry;
+    }
+    return count;
+}
+
+int transmitterTableCount(const TransmitterTable* table) {
+    int count = 0;
+    for (int i = 0; i < TRANSMITTER_TABLE_SIZE; i++) {
+        if (table->entries[i].used) count++;
+    }
+    return count;
+}
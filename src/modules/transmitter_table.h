@@ -0,0 +1,120 @@
+#ifndef TRANSMITTER_TABLE_H
+#define TRANSMITTER_TABLE_H
+
+#include <Arduino.h>
+#include "p2_quantiles.h"
+#include "loss_window.h"
+#include "fixed_stats.h"
+
+// Transmitters tracked at once; the least recently heard MAC is evicted
+#ifndef TRANSMITTER_TABLE_SIZE
+#define TRANSMITTER_TABLE_SIZE 64
+#endif
+
+// PDV samples above this are a sender restart or clock jump, not jitter
+#define TRANSMITTER_PDV_MAX_MS 10000
+
+// A sender clock this far behind the previous frame means a reboot,
+// not a late (reordered) frame
+#define TRANSMITTER_RESTART_MS 1000
+
+// Per-transmitter link quality (312 bytes per entry, 19.5 KB for 64,
+// internal DRAM; program --quantile-bench prints the sizes of the
+// current build). The quantiles are 114 bytes of it; the moments that
+// report_compare needs for its confidence intervals are 72 - lower
+// TRANSMITTER_TABLE_SIZE rather than drop them if DRAM is short:
+// - p50/p95/p99 of inter-arrival time, packet delay variation and
+//   RSSI, each a P² estimator
+// - mean and standard deviation of inter-arrival time, RSSI and
+//   loss run length since the entry was created, so runs can be
+//   compared with confidence intervals (tools/report_compare.cpp)
+// - sliding-window loss from sequence gaps, with a degraded flag
+//   raised and cleared with hysteresis (see LinkAlarmConfig); a
+//   late (reordered) frame still inside the packet window takes its
+//   slot back from the loss counts, an older one counts as duplicate
+// - frames the receiver dropped itself, reported through
+//   transmitterTableRecordDrop() and kept out of the loss counts
+//
+// PDV is the IPDV of RFC 3393: |change in (arrival - sender uptime)|
+// between consecutive frames, so the two clocks need not agree.
+struct TransmitterEntry {
+    uint8_t mac[6];
+    bool used;
+    bool timed;               // last* fields are valid
+    uint32_t lastUsed;        // LRU stamp (table clock at last frame)
+    uint32_t frames;          // Frames recorded since the entry was created
+    uint32_t missed;          // Sequence slots lost over the air since then
+    uint32_t internal;        // Slots the receiver dropped itself (ring full, rate limited)
+    uint32_t pendingDrops;    // Dropped ahead of the last frame, not yet matched to a gap
+    uint32_t lastArrivalMs;   // Receiver millis() at the last frame
+    uint32_t lastSenderMs;    // Sender uptime stamp of the last frame
+    uint32_t lastSequence;    // Highest sequence since the last restart
+    bool degraded;            // Loss alarm raised and not yet cleared
+    P2Quantiles interArrival; // ms
+    P2Quantiles pdv;          // ms
+    P2Quantiles rssi;         // dBm, frames with a known RSSI only
+    LossWindow loss;          // Sequence gaps, credited back by late frames
+    WelfordStats interArrivalStats;  // ms
+    WelfordStats rssiStats;          // dBm, frames with a known RSSI only
+    WelfordStats lossRuns;           // Length of each run of consecutive losses
+};
+
+// Loss alarm with hysteresis: raised when either window's loss is
+// above alarmPpm with 95% confidence (the Wilson lower bound reaches
+// alarmPpm, so a few unlucky pings in a short window do not count),
+// cleared once both windows' loss is at or below clearPpm.
+// A window counts only once it has seen minSlots ping slots.
+struct LinkAlarmConfig {
+    uint32_t alarmPpm;
+    uint32_t clearPpm;
+    uint32_t minSlots;
+};
+
+// What a frame did to its transmitter's loss alarm
+enum TransmitterEvent {
+    TRANSMITTER_EVENT_NONE = 0,
+    TRANSMITTER_EVENT_DEGRADED,  // Alarm raised
+    TRANSMITTER_EVENT_OK,        // Alarm cleared
+};
+
+// Plain struct so the device and host benchmarks can each own one.
+// Not thread-safe: callers serialise.
+struct TransmitterTable {
+    TransmitterEntry entries[TRANSMITTER_TABLE_SIZE];
+    LinkAlarmConfig alarm;
+    uint32_t clock;      // Advances once per frame, for LRU
+    uint32_t evictions;  // Transmitters pushed out of the table
+    uint8_t lastHit;     // Entry of the previous frame, checked first
+};
+
+void transmitterTableInit(TransmitterTable* table, const LinkAlarmConfig* alarm);
+
+// Account one frame from mac. senderMs is the sender's uptime stamp,
+// rssi 0 means unknown. Returns the alarm transition it caused.
+// IRAM-resident: called per received ping.
+TransmitterEvent transmitterTableRecord(TransmitterTable* table, const uint8_t* mac, uint32_t sequence,
+                                        uint32_t arrivalMs, uint32_t senderMs, int8_t rssi);
+
+// A frame from mac that the receive path dropped (ring full or rate
+// limited) at nowMs, before it was recorded. The gap it leaves is
+// counted as internal, not lost; a late (reordered) one whose gap was
+// already counted takes its slot back. Producer context; IRAM-resident.
+void transmitterTableRecordDrop(TransmitterTable* table, const uint8_t* mac, uint32_t sequence, uint32_t nowMs);
+
+// Entry for mac, or null if it is not tracked. IRAM-resident.
+const TransmitterEntry* transmitterTableFind(const TransmitterTable* table, const uint8_t* mac);
+
+// Loss of entry over both windows at nowMs (either may be null);
+// returns the higher rate among windows with at least minSlots
+// slots, 0 if neither qualifies
+uint32_t transmitterLossPpm(const TransmitterTable* table, const TransmitterEntry* entry, uint32_t nowMs,
+                            LossWindowCounts* packets, LossWindowCounts* seconds);
+
+// Copy the tracked transmitters into out (up to maxEntries), busiest
+// first. Returns the number copied.
+int transmitterTableGetAll(const TransmitterTable* table, TransmitterEntry* out, int maxEntries);
+
+// Number of entries in use
+int transmitterTableCount(const TransmitterTable* table);
+
+#endif
@@ -2,13 +2,14 @@
 #include "config.h"
 #include "esp_task_wdt.h"
 #include "DiagnosticReceiver.h"
+#include "Trace.h"
 
 // Module includes
 #if USE_WIFI
 #endif
 
 #if USE_MQTT
-  extern void onMqttMessage(String topic, String payload);
+  extern void onMqttMessage(const char* topic, const char* payload);
 #endif
 
 #if USE_MDNS
@@ -20,6 +21,7 @@
 #if USE_ESPNOW
   #include "modules/espnow_module.h"
   extern void onEspNowReceive(const uint8_t* mac, const uint8_t* data, int len);
+  extern void onEspNowDrop(const uint8_t* mac, const uint8_t* data, int len);
   extern void onEspNowSend(const uint8_t* mac, bool success);
 #endif
 
@@ -86,12 +88,23 @@ static void resetButtonTask(void* param) {
 //                       LOGGING
 // ============================================================
 void propLog(const char* message) {
+  TRACE_EVENT(TRACE_LOG_BEGIN, strlen(message));
   Serial.println(message);
   #if USE_MQTT
     if (mqttIsConnected()) {
       mqttPublish("log", message, false);
     }
   #endif
+  TRACE_EVENT(TRACE_LOG_END, 0);
+}
+
+void propLogf(const char* format, ...) {
+  char message[PROP_LOG_MAX_LEN];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(message, sizeof(message), format, args);
+  va_end(args);
+  propLog(message);
 }
 
 void propLog(const String& message) {
@@ -209,8 +222,10 @@ void printNetworkInfo() {
     #else
       Serial.println("Client mode");
     #endif
+    char macStr[ESPNOW_MAC_STR_LEN];
+    espnowGetMACString(macStr, sizeof(macStr));
     Serial.print("  ESP-NOW MAC: ");
-    Serial.println(espnowGetMAC());
+    Serial.println(macStr);
   #endif
 
   #if USE_HEARTBEAT
@@ -294,8 +309,21 @@ void setupInit() {
     #else
       espnowInit(false, hostMac);
     #endif
+    #if ESPNOW_ALLOWLIST_ENABLED
+      const uint8_t allowlist[][6] = ESPNOW_ALLOWLIST;
+      for (size_t i = 0; i < sizeof(allowlist) / sizeof(allowlist[0]); i++) {
+        if (!espnowAllowlistAdd(allowlist[i])) {
+          Serial.println("[ESP-NOW] Allowlist full - entry ignored");
+        }
+      }
+      Serial.printf("[ESP-NOW] Allowlist: %d sender(s)\n", espnowAllowlistCount());
+    #endif
     espnowSetReceiveCallback(onEspNowReceive);
+    espnowSetDropCallback(onEspNowDrop);
     espnowSetSendCallback(onEspNowSend);
+    #if ESPNOW_TRACK_RSSI
+      espnowEnableRssiTracking();
+    #endif
   #endif
 
   // Start reset button task on Core 0 (if RESET_PIN defined)
@@ -309,7 +337,7 @@ void setupInit() {
       &_resetTaskHandle,
       0  // Core 0
     );
-    Serial.println("[Reset] Button task started on Core 0 (GPIO " + String(RESET_PIN) + ")");
+    Serial.printf("[Reset] Button task started on Core 0 (GPIO %d)\n", RESET_PIN);
   #endif
 
   // Print network status after all modules initialized
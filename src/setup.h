@@ -19,8 +19,16 @@ void printStartupInfo();
 //   propLog("[Prop] State: IDLE -> SOLVED");
 //   propLog("[Audio] Playing track 3");
 //   propLog("[Error] Solenoid timeout after 5s");
+//   propLogf("[Audio] Playing track %d", track);
 //
+// propLog(const char*) and propLogf() never touch the heap; propLogf()
+// formats into a stack buffer and cuts lines at PROP_LOG_MAX_LEN - 1.
+// The String overload allocates - avoid it in code that runs repeatedly.
+//
+#define PROP_LOG_MAX_LEN 160
+
 void propLog(const char* message);
+void propLogf(const char* format, ...) __attribute__((format(printf, 1, 2)));
 void propLog(const String& message);
 
 // ============================================================
@@ -0,0 +1,627 @@
+// ============================================================
+//            BINARY PING LOG ANALYSER
+// ============================================================
+//
+// Decodes one or more binary ping logs (B command, see
+// src/BinaryLog.h) and prints per-transmitter statistics merged
+// across all runs: received / missed / late pings, restarts,
+// inter-arrival and RSSI distributions, and optionally histograms
+// and loss-over-time maps.
+//
+// Build:
+//   g++ -O2 -std=c++17 -pthread -o binlog_analyse tools/binlog_analyse.cpp
+//
+// Usage:
+//   binlog_analyse [options] run1.bin [run2.bin ...]
+//     -j N            Decoder threads (default: all cores)
+//     --bucket-s N    Loss map resolution in seconds (default 60)
+//     --hist          Print inter-arrival and RSSI histograms
+//     --map           Print a loss map per transmitter and run
+//     --lossmap FILE  Write the loss maps as CSV
+//
+// Each file is one run (one boot of the receiver) - a raw serial
+// capture or a flash dump. Files are memory-mapped and cut into
+// chunks that a pool of threads decodes in parallel: a chunk
+// starts at the first keyframe (block header with a valid CRC) at
+// or after its offset, so text lines, garbage and erased flash
+// between blocks are skipped. Sequence state that crosses a chunk
+// boundary is stitched together in order after the decode.
+//
+// ============================================================
+
+#include "binlog_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static const size_t kChunkBytes = 8u << 20;    // Decode work unit
+static const uint32_t kIatMaxMs = 2047;        // 1 ms histogram bins up to here, then one overflow bin
+static const uint32_t kLateWindow = 256;       // A sequence this far behind is late, further is a restart
+static const uint32_t kMaxBuckets = 1u << 20;  // Loss map buckets per series (guards against bad times)
+
+// ============================================================
+//                    STATISTICS
+// ============================================================
+
+// Series = one transmitter in one run. Key: MAC in the low 48 bits,
+// file index above.
+static uint64_t seriesKey(const uint8_t* mac, size_t file) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+    return key | ((uint64_t)file << 48);
+}
+
+static uint64_t macOf(uint64_t key) {
+    return key & 0xFFFFFFFFFFFFull;
+}
+
+struct SeriesStats {
+    uint64_t received = 0;
+    uint64_t missed = 0;
+    uint64_t late = 0;       // Duplicates and pings behind the newest
+    uint64_t restarts = 0;   // Sequence jumped back beyond kLateWindow
+    uint64_t rssiKnown = 0;
+    int64_t rssiSum = 0;
+    std::vector<uint64_t> iat = std::vector<uint64_t>(kIatMaxMs + 2, 0);
+    std::vector<uint64_t> rssi = std::vector<uint64_t>(129, 0);  // -128..0 dBm
+    std::vector<uint32_t> mapReceived;  // Per loss map bucket
+    std::vector<uint32_t> mapMissed;
+
+    void addIat(uint32_t ms) {
+        iat[std::min(ms, kIatMaxMs + 1)]++;
+    }
+
+    void addMap(uint32_t elapsedMs, uint32_t bucketMs, uint32_t received, uint64_t missed) {
+        uint32_t bucket = elapsedMs / bucketMs;
+        if (bucket >= kMaxBuckets) return;
+        if (bucket >= mapReceived.size()) {
+            mapReceived.resize(bucket + 1, 0);
+            mapMissed.resize(bucket + 1, 0);
+        }
+        mapReceived[bucket] += received;
+        mapMissed[bucket] += (uint32_t)std::min<uint64_t>(missed, UINT32_MAX);
+    }
+
+    void merge(const SeriesStats& other) {
+        received += other.received;
+        missed += other.missed;
+        late += other.late;
+        restarts += other.restarts;
+        rssiKnown += other.rssiKnown;
+        rssiSum += other.rssiSum;
+        for (size_t i = 0; i < iat.size(); i++) iat[i] += other.iat[i];
+        for (size_t i = 0; i < rssi.size(); i++) rssi[i] += other.rssi[i];
+        if (other.mapReceived.size() > mapReceived.size()) {
+            mapReceived.resize(other.mapReceived.size(), 0);
+            mapMissed.resize(other.mapMissed.size(), 0);
+        }
+        for (size_t i = 0; i < other.mapReceived.size(); i++) {
+            mapReceived[i] += other.mapReceived[i];
+            mapMissed[i] += other.mapMissed[i];
+        }
+    }
+};
+
+enum SequenceStep { STEP_NEXT, STEP_GAP, STEP_LATE, STEP_RESTART };
+
+static SequenceStep classify(uint32_t last, uint32_t sequence, uint64_t* missed) {
+    *missed = 0;
+    if (sequence == last + 1) return STEP_NEXT;
+    if (sequence > last) {
+        *missed = sequence - last - 1;
+        return STEP_GAP;
+    }
+    return (last - sequence < kLateWindow) ? STEP_LATE : STEP_RESTART;
+}
+
+// A series' first and last ping inside one chunk, for stitching
+struct Edge {
+    uint64_t key;
+    uint32_t firstSequence;
+    uint32_t firstMs;
+    uint32_t lastSequence;
+    uint32_t lastMs;
+};
+
+struct ChunkJob {
+    size_t file;
+    size_t begin;
+    size_t end;
+    uint32_t runStartMs;
+};
+
+struct ChunkResult {
+    uint64_t blocks = 0;
+    uint64_t records = 0;
+    uint64_t blockBytes = 0;
+    uint64_t corrupt = 0;        // Magic found, block invalid
+    uint64_t lostBlocks = 0;     // Block index gaps inside the chunk
+    uint64_t reboots = 0;        // Block index went backwards inside the chunk
+    bool any = false;
+    uint32_t firstBlock = 0;
+    uint32_t lastBlock = 0;
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+    std::vector<Edge> edges;
+};
+
+// Per decoder thread: statistics for every series it has seen
+struct Worker {
+    std::unordered_map<uint64_t, size_t> index;
+    std::vector<uint64_t> keys;
+    std::vector<SeriesStats> stats;
+
+    // Chunk-local cursor per series (valid when stamp == chunk + 1)
+    std::vector<size_t> stamp;
+    std::vector<size_t> edge;
+
+    size_t lookup(uint64_t key) {
+        auto it = index.find(key);
+        if (it != index.end()) return it->second;
+        size_t slot = stats.size();
+        index.emplace(key, slot);
+        keys.push_back(key);
+        stats.emplace_back();
+        stamp.push_back(0);
+        edge.push_back(0);
+        return slot;
+    }
+};
+
+static void decodeBlock(Worker* worker, const ChunkJob& job, size_t chunk, uint32_t bucketMs,
+                        const uint8_t* p, ChunkResult* result) {
+    BinlogHeader header;
+    memcpy(&header, p, sizeof(header));
+    const BinlogMacEntry* macs = (const BinlogMacEntry*)(p + sizeof(BinlogHeader));
+    const BinlogRecord* records = (const BinlogRecord*)(macs + header.macCount);
+
+    // Resolve the block's MAC table once, not per record
+    size_t slots[256];
+    for (int i = 0; i < header.macCount; i++) {
+        slots[i] = worker->lookup(seriesKey(macs[i].mac, job.file));
+    }
+
+    if (!result->any) {
+        result->any = true;
+        result->firstBlock = header.blockIndex;
+        result->firstMs = header.baseMs;
+    } else if (header.blockIndex > result->lastBlock + 1) {
+        result->lostBlocks += header.blockIndex - result->lastBlock - 1;
+    } else if (header.blockIndex <= result->lastBlock) {
+        result->reboots++;
+    }
+    result->lastBlock = header.blockIndex;
+    result->blocks++;
+    result->records += header.records;
+
+    for (uint16_t i = 0; i < header.records; i++) {
+        const BinlogRecord& record = records[i];
+        size_t slot = slots[record.macIndex];
+        SeriesStats& stats = worker->stats[slot];
+        uint32_t sequence = macs[record.macIndex].baseSequence + record.sequenceOffset;
+        uint32_t arrivalMs = header.baseMs + record.offsetMs;
+        uint32_t elapsedMs = arrivalMs - job.runStartMs;
+
+        stats.received++;
+        if (record.rssi != 0) {
+            stats.rssiKnown++;
+            stats.rssiSum += record.rssi;
+            stats.rssi[record.rssi + 128]++;
+        }
+        result->lastMs = arrivalMs;
+
+        if (worker->stamp[slot] != chunk + 1) {
+            // First ping of this series in the chunk - stitched later
+            worker->stamp[slot] = chunk + 1;
+            worker->edge[slot] = result->edges.size();
+            result->edges.push_back({worker->keys[slot], sequence, arrivalMs, sequence, arrivalMs});
+            stats.addMap(elapsedMs, bucketMs, 1, 0);
+            continue;
+        }
+
+        Edge& edge = result->edges[worker->edge[slot]];
+        uint64_t missed;
+        switch (classify(edge.lastSequence, sequence, &missed)) {
+            case STEP_LATE:
+                stats.late++;
+                stats.addMap(elapsedMs, bucketMs, 1, 0);
+                continue;
+            case STEP_RESTART:
+                stats.restarts++;
+                break;
+            default:
+                stats.missed += missed;
+                stats.addIat(arrivalMs - edge.lastMs);
+                break;
+        }
+        stats.addMap(elapsedMs, bucketMs, 1, missed);
+        edge.lastSequence = sequence;
+        edge.lastMs = arrivalMs;
+    }
+}
+
+static void decodeChunk(Worker* worker, const MappedFile& file, const ChunkJob& job, size_t chunk,
+                        uint32_t bucketMs, ChunkResult* result) {
+    const uint8_t* end = file.data + file.size;
+    const uint8_t* p = file.data + job.begin;
+    const uint8_t* stop = file.data + job.end;
+
+    // Blocks that start in [begin, end) belong to this chunk; the
+    // last one may run past end
+    while (p < stop) {
+        p = findMagic(p, end);
+        if (p >= stop) break;
+        size_t size = blockAt(p, end);
+        if (size == 0) {
+            result->corrupt++;
+            p++;
+            continue;
+        }
+        decodeBlock(worker, job, chunk, bucketMs, p, result);
+        result->blockBytes += size;
+        p += size;
+    }
+}
+
+// ============================================================
+//                    REPORT
+// ============================================================
+
+struct FileSummary {
+    uint64_t blocks = 0;
+    uint64_t records = 0;
+    uint64_t blockBytes = 0;
+    uint64_t corrupt = 0;
+    uint64_t lostBlocks = 0;
+    uint64_t reboots = 0;
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+    bool any = false;
+};
+
+static std::string formatMac(uint64_t key) {
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+             (unsigned)(key >> 40) & 0xFF, (unsigned)(key >> 32) & 0xFF, (unsigned)(key >> 24) & 0xFF,
+             (unsigned)(key >> 16) & 0xFF, (unsigned)(key >> 8) & 0xFF, (unsigned)key & 0xFF);
+    return text;
+}
+
+static std::string formatSpan(uint32_t ms) {
+    char text[24];
+    uint32_t s = ms / 1000;
+    snprintf(text, sizeof(text), "%" PRIu32 ":%02" PRIu32 ":%02" PRIu32, s / 3600, (s / 60) % 60, s % 60);
+    return text;
+}
+
+// Smallest bin holding at least fraction of the samples
+static size_t histQuantile(const std::vector<uint64_t>& hist, double fraction) {
+    uint64_t total = 0;
+    for (uint64_t count : hist) total += count;
+    if (total == 0) return 0;
+    uint64_t target = (uint64_t)(fraction * total + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < hist.size(); i++) {
+        seen += hist[i];
+        if (seen >= target) return i;
+    }
+    return hist.size() - 1;
+}
+
+static std::string formatIat(size_t bin) {
+    return (bin > kIatMaxMs) ? ">" + std::to_string(kIatMaxMs) : std::to_string(bin);
+}
+
+static void printBar(const char* label, uint64_t count, uint64_t peak) {
+    int width = (peak > 0) ? (int)((count * 40 + peak - 1) / peak) : 0;
+    printf("    %-12s %12" PRIu64 " %.*s\n", label, count, width, "########################################");
+}
+
+static void printHistograms(const SeriesStats& stats) {
+    // Inter-arrival in power-of-two ranges
+    std::vector<uint64_t> ranges;
+    std::vector<std::string> labels;
+    ranges.push_back(stats.iat[0]);
+    labels.push_back("0");
+    for (uint32_t low = 1; low <= kIatMaxMs; low *= 2) {
+        uint32_t high = std::min(low * 2 - 1, kIatMaxMs);
+        uint64_t count = 0;
+        for (uint32_t ms = low; ms <= high; ms++) count += stats.iat[ms];
+        ranges.push_back(count);
+        labels.push_back(std::to_string(low) + "-" + std::to_string(high));
+    }
+    ranges.push_back(stats.iat[kIatMaxMs + 1]);
+    labels.push_back(">" + std::to_string(kIatMaxMs));
+
+    uint64_t peak = *std::max_element(ranges.begin(), ranges.end());
+    printf("  Inter-arrival (ms)\n");
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (ranges[i] > 0) printBar(labels[i].c_str(), ranges[i], peak);
+    }
+
+    // RSSI in 5 dB bins
+    if (stats.rssiKnown == 0) return;
+    std::vector<uint64_t> bins(26, 0);
+    for (int dbm = -128; dbm <= 0; dbm++) bins[(dbm + 128) / 5] += stats.rssi[dbm + 128];
+    peak = *std::max_element(bins.begin(), bins.end());
+    printf("  RSSI (dBm)\n");
+    for (size_t i = 0; i < bins.size(); i++) {
+        if (bins[i] == 0) continue;
+        int low = (int)i * 5 - 128;
+        char label[16];
+        snprintf(label, sizeof(label), "%d..%d", low, std::min(low + 4, 0));
+        printBar(label, bins[i], peak);
+    }
+}
+
+// One character per bucket, 60 buckets per row
+static void printLossMap(const SeriesStats& stats, uint32_t bucketMs) {
+    static const size_t kRow = 60;
+    for (size_t row = 0; row < stats.mapReceived.size(); row += kRow) {
+        printf("    %10s |", formatSpan((uint32_t)std::min<uint64_t>((uint64_t)row * bucketMs, UINT32_MAX)).c_str());
+        for (size_t i = row; i < std::min(row + kRow, stats.mapReceived.size()); i++) {
+            uint64_t slots = (uint64_t)stats.mapReceived[i] + stats.mapMissed[i];
+            double loss = (slots > 0) ? (double)stats.mapMissed[i] / slots : 0.0;
+            char c = (slots == 0) ? ' ' : (loss == 0) ? '.' : (loss < 0.01) ? '-' : (loss < 0.05) ? '+'
+                   : (loss < 0.20) ? '*' : '#';
+            putchar(c);
+        }
+        printf("|\n");
+    }
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [-j N] [--bucket-s N] [--hist] [--map] [--lossmap FILE.csv] log.bin...\n", program);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    uint32_t bucketS = 60;
+    bool hist = false;
+    bool map = false;
+    const char* lossMapPath = nullptr;
+    std::vector<MappedFile> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "-j") == 0 && hasValue) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(arg, "--bucket-s") == 0 && hasValue) {
+            bucketS = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(arg, "--lossmap") == 0 && hasValue) {
+            lossMapPath = argv[++i];
+        } else if (strcmp(arg, "--hist") == 0) {
+            hist = true;
+        } else if (strcmp(arg, "--map") == 0) {
+            map = true;
+        } else if (arg[0] == '-') {
+            usage(argv[0]);
+        } else {
+            MappedFile file;
+            if (!mapFile(arg, &file)) {
+                fprintf(stderr, "error: cannot map %s\n", arg);
+                return 1;
+            }
+            files.push_back(file);
+        }
+    }
+    if (files.empty()) usage(argv[0]);
+    uint32_t bucketMs = bucketS * 1000;
+
+    // Cut every file into chunks; the run clock starts at its first block
+    std::vector<ChunkJob> jobs;
+    for (size_t f = 0; f < files.size(); f++) {
+        const MappedFile& file = files[f];
+        const uint8_t* end = file.data + file.size;
+        uint32_t runStartMs = 0;
+        for (const uint8_t* p = findMagic(file.data, end); p < end; p = findMagic(p + 1, end)) {
+            if (blockAt(p, end) > 0) {
+                runStartMs = ((const BinlogHeader*)p)->baseMs;
+                break;
+            }
+        }
+        for (size_t begin = 0; begin < file.size; begin += kChunkBytes) {
+            jobs.push_back({f, begin, std::min(begin + kChunkBytes, file.size), runStartMs});
+        }
+    }
+
+    // Decode on a pool of threads pulling chunks off a shared counter
+    auto started = std::chrono::steady_clock::now();
+    threads = std::min<unsigned>(threads, std::max<size_t>(1, jobs.size()));
+    std::vector<ChunkResult> results(jobs.size());
+    std::vector<Worker> workers(threads);
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; t++) {
+        pool.emplace_back([&, t]() {
+            for (size_t chunk = next++; chunk < jobs.size(); chunk = next++) {
+                decodeChunk(&workers[t], files[jobs[chunk].file], jobs[chunk], chunk, bucketMs, &results[chunk]);
+            }
+        });
+    }
+    for (std::thread& thread : pool) thread.join();
+
+    // Merge the order-independent statistics
+    std::unordered_map<uint64_t, SeriesStats> series;
+    for (Worker& worker : workers) {
+        for (size_t i = 0; i < worker.keys.size(); i++) {
+            series[worker.keys[i]].merge(worker.stats[i]);
+        }
+    }
+
+    // Stitch chunk boundaries in file order
+    std::vector<FileSummary> summaries(files.size());
+    std::unordered_map<uint64_t, Edge> open;  // Series -> last ping so far
+    for (size_t chunk = 0; chunk < jobs.size(); chunk++) {
+        const ChunkJob& job = jobs[chunk];
+        const ChunkResult& result = results[chunk];
+        FileSummary& summary = summaries[job.file];
+        summary.blocks += result.blocks;
+        summary.records += result.records;
+        summary.blockBytes += result.blockBytes;
+        summary.corrupt += result.corrupt;
+        summary.lostBlocks += result.lostBlocks;
+        summary.reboots += result.reboots;
+        if (!result.any) continue;
+
+        if (!summary.any) {
+            summary.any = true;
+            summary.firstMs = result.firstMs;
+        }
+        summary.lastMs = result.lastMs;
+
+        for (const Edge& edge : result.edges) {
+            auto it = open.find(edge.key);
+            if (it == open.end()) {
+                open.emplace(edge.key, edge);
+                continue;
+            }
+            SeriesStats& stats = series[edge.key];
+            uint64_t missed;
+            switch (classify(it->second.lastSequence, edge.firstSequence, &missed)) {
+                case STEP_LATE:
+                    stats.late++;
+                    break;
+                case STEP_RESTART:
+                    stats.restarts++;
+                    break;
+                default:
+                    stats.missed += missed;
+                    stats.addIat(edge.firstMs - it->second.lastMs);
+                    if (missed > 0) stats.addMap(edge.firstMs - job.runStartMs, bucketMs, 0, missed);
+                    break;
+            }
+            it->second.lastSequence = edge.lastSequence;
+            it->second.lastMs = edge.lastMs;
+        }
+    }
+
+    // Block index gaps and restarts across chunk boundaries
+    std::vector<uint32_t> lastBlock(files.size(), 0);
+    std::vector<bool> haveBlock(files.size(), false);
+    for (size_t chunk = 0; chunk < jobs.size(); chunk++) {
+        const ChunkResult& result = results[chunk];
+        size_t f = jobs[chunk].file;
+        if (!result.any) continue;
+        if (haveBlock[f]) {
+            if (result.firstBlock > lastBlock[f] + 1) {
+                summaries[f].lostBlocks += result.firstBlock - lastBlock[f] - 1;
+            } else if (result.firstBlock <= lastBlock[f]) {
+                summaries[f].reboots++;
+            }
+        }
+        haveBlock[f] = true;
+        lastBlock[f] = result.lastBlock;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    // Runs
+    uint64_t totalRecords = 0;
+    uint64_t totalBytes = 0;
+    printf("Runs\n");
+    printf("  %-24s %10s %12s %8s %8s %10s %10s\n", "File", "Blocks", "Pings", "Corrupt", "Lost", "Skipped", "Span");
+    for (size_t f = 0; f < files.size(); f++) {
+        const FileSummary& summary = summaries[f];
+        std::string name = files[f].path;
+        if (name.size() > 24) name = "..." + name.substr(name.size() - 21);
+        printf("  %-24s %10" PRIu64 " %12" PRIu64 " %8" PRIu64 " %8" PRIu64 " %9" PRIu64 "K %10s\n",
+               name.c_str(), summary.blocks, summary.records, summary.corrupt, summary.lostBlocks,
+               (files[f].size - summary.blockBytes) / 1024, formatSpan(summary.lastMs - summary.firstMs).c_str());
+        if (summary.reboots > 0) {
+            printf("  warning: %s holds %" PRIu64 " receiver reboots; loss map times are unreliable\n",
+                   files[f].path.c_str(), summary.reboots);
+        }
+        totalRecords += summary.records;
+        totalBytes += files[f].size;
+    }
+
+    // Transmitters, merged across runs
+    std::vector<uint64_t> keys;
+    for (auto& entry : series) keys.push_back(entry.first);
+    std::sort(keys.begin(), keys.end());
+    std::vector<uint64_t> macs;
+    std::unordered_map<uint64_t, SeriesStats> byMac;
+    for (uint64_t key : keys) {
+        uint64_t mac = macOf(key);
+        if (byMac.find(mac) == byMac.end()) macs.push_back(mac);
+        SeriesStats& total = byMac[mac];
+        const SeriesStats& stats = series[key];
+        // Loss maps stay per run; only the totals are merged
+        total.received += stats.received;
+        total.missed += stats.missed;
+        total.late += stats.late;
+        total.restarts += stats.restarts;
+        total.rssiKnown += stats.rssiKnown;
+        total.rssiSum += stats.rssiSum;
+        for (size_t i = 0; i < stats.iat.size(); i++) total.iat[i] += stats.iat[i];
+        for (size_t i = 0; i < stats.rssi.size(); i++) total.rssi[i] += stats.rssi[i];
+    }
+    std::sort(macs.begin(), macs.end());
+
+    printf("\nTransmitters (%zu runs merged)\n", files.size());
+    printf("  %-17s %12s %10s %7s %8s %4s %16s %14s\n", "MAC", "Received", "Missed", "Loss", "Late", "Rst",
+           "IAT p50/95/99", "RSSI avg/min");
+    for (uint64_t mac : macs) {
+        const SeriesStats& stats = byMac[mac];
+        uint64_t slots = stats.received - stats.late + stats.missed;
+        double loss = (slots > 0) ? 100.0 * stats.missed / slots : 0.0;
+        std::string iat = formatIat(histQuantile(stats.iat, 0.50)) + "/" + formatIat(histQuantile(stats.iat, 0.95)) +
+                          "/" + formatIat(histQuantile(stats.iat, 0.99));
+        char rssi[24] = "-";
+        if (stats.rssiKnown > 0) {
+            snprintf(rssi, sizeof(rssi), "%.1f/%d", (double)stats.rssiSum / stats.rssiKnown,
+                     (int)histQuantile(stats.rssi, 0.0) - 128);
+        }
+        printf("  %-17s %12" PRIu64 " %10" PRIu64 " %6.3f%% %8" PRIu64 " %4" PRIu64 " %16s %14s\n",
+               formatMac(mac).c_str(), stats.received, stats.missed, loss, stats.late, stats.restarts,
+               iat.c_str(), rssi);
+    }
+
+    if (hist) {
+        for (uint64_t mac : macs) {
+            printf("\n%s\n", formatMac(mac).c_str());
+            printHistograms(byMac[mac]);
+        }
+    }
+
+    if (map) {
+        printf("\nLoss maps (%" PRIu32 " s per column:  . none  - <1%%  + <5%%  * <20%%  # >=20%%)\n", bucketS);
+        for (uint64_t key : keys) {
+            printf("  %s  %s\n", formatMac(key).c_str(), files[key >> 48].path.c_str());
+            printLossMap(series[key], bucketMs);
+        }
+    }
+
+    if (lossMapPath != nullptr) {
+        FILE* out = fopen(lossMapPath, "w");
+        if (out == nullptr) {
+            fprintf(stderr, "error: cannot write %s\n", lossMapPath);
+            return 1;
+        }
+        fprintf(out, "run,mac,start_s,received,missed\n");
+        for (uint64_t key : keys) {
+            const SeriesStats& stats = series[key];
+            for (size_t i = 0; i < stats.mapReceived.size(); i++) {
+                fprintf(out, "%s,%s,%" PRIu64 ",%" PRIu32 ",%" PRIu32 "\n", files[key >> 48].path.c_str(),
+                        formatMac(key).c_str(), (uint64_t)i * bucketS, stats.mapReceived[i], stats.mapMissed[i]);
+            }
+        }
+        fclose(out);
+    }
+
+    fprintf(stderr, "%" PRIu64 " pings from %.1f MB in %.2f s (%.1f M pings/s, %u threads)\n", totalRecords,
+            totalBytes / 1e6, seconds, totalRecords / 1e6 / std::max(seconds, 1e-9), threads);
+    return 0;
+}
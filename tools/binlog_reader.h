@@ -0,0 +1,94 @@
+// ============================================================
+//            BINARY PING LOG - HOST READER
+// ============================================================
+//
+// Shared by the host tools that read binary ping logs
+// (binlog_analyse, diversity): memory-maps a capture and finds the
+// valid blocks in it. A block is valid when its header, CRC and MAC
+// indices check out; anything between blocks (text lines, garbage,
+// erased flash) is skipped by scanning for the next magic word:
+//
+//   for (const uint8_t* p = findMagic(data, end); p < end;) {
+//       size_t size = blockAt(p, end);
+//       if (size == 0) { p = findMagic(p + 1, end); continue; }
+//       ... decode the block at p ...
+//       p = findMagic(p + size, end);
+//   }
+//
+// ============================================================
+
+#ifndef BINLOG_READER_H
+#define BINLOG_READER_H
+
+#include "../src/BinaryLogFormat.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct MappedFile {
+    std::string path;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+static inline bool mapFile(const char* path, MappedFile* out) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    out->path = path;
+    out->size = (size_t)st.st_size;
+    if (out->size > 0) {
+        void* data = mmap(nullptr, out->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        madvise(data, out->size, MADV_SEQUENTIAL);
+        out->data = (const uint8_t*)data;
+    }
+    close(fd);  // The mapping stays valid
+    return true;
+}
+
+// Size of the valid block at p, or 0 if there is none
+static inline size_t blockAt(const uint8_t* p, const uint8_t* end) {
+    if ((size_t)(end - p) < sizeof(BinlogHeader)) return 0;
+    BinlogHeader header;
+    memcpy(&header, p, sizeof(header));
+    if (header.magic != BINLOG_MAGIC || header.version != BINLOG_VERSION || header.records == 0) return 0;
+
+    size_t body = binlogBodySize(header.macCount, header.records);
+    if ((size_t)(end - p) - sizeof(BinlogHeader) < body) return 0;
+    if (binlogCrc32(0, p + sizeof(BinlogHeader), body) != header.crc) return 0;
+
+    // Every record must point into the table
+    const BinlogRecord* records = (const BinlogRecord*)(p + sizeof(BinlogHeader) +
+                                                        header.macCount * sizeof(BinlogMacEntry));
+    for (uint16_t i = 0; i < header.records; i++) {
+        if (records[i].macIndex >= header.macCount) return 0;
+    }
+    return sizeof(BinlogHeader) + body;
+}
+
+// Next byte at or after p that starts with the magic word
+static inline const uint8_t* findMagic(const uint8_t* p, const uint8_t* end) {
+    static const uint8_t magic[4] = {BINLOG_MAGIC & 0xFF, (BINLOG_MAGIC >> 8) & 0xFF,
+                                     (BINLOG_MAGIC >> 16) & 0xFF, BINLOG_MAGIC >> 24};
+    while (end - p >= 4) {
+        p = (const uint8_t*)memchr(p, magic[0], (end - p) - 3);
+        if (p == nullptr) return end;
+        if (memcmp(p, magic, 4) == 0) return p;
+        p++;
+    }
+    return end;
+}
+
+#endif
@@ -0,0 +1,451 @@
+// ============================================================
+//            MULTI-RECEIVER DIVERSITY ANALYSIS
+// ============================================================
+//
+// Merges the binary ping logs (B command, see src/BinaryLog.h) of
+// several receivers placed around one room and answers whether a
+// second receiver or relay would fix a dead zone:
+//   - delivery per receiver and transmitter, and of all receivers
+//     together (a ping counts if any receiver heard it)
+//   - diversity gain: union delivery over the best single receiver
+//   - pairwise overlap: pings both receivers heard, either heard,
+//     and whether their losses coincide (lift 1 = independent,
+//     higher = the same pings are lost at both, little to gain)
+//   - best placement: the receiver set of each size that delivers
+//     the most
+//
+// Build:
+//   g++ -O2 -std=c++17 -pthread -o diversity tools/diversity.cpp
+//
+// Usage:
+//   diversity [options] rx1.bin rx2.bin [rx3.bin ...]
+//     --span common|union  Sequence range per transmitter: heard by every
+//                          receiver's capture (default) or by any
+//     --rank total|worst   Best placement by total delivery (default)
+//                          or by the worst transmitter's delivery
+//
+// One file per receiver, all captured during the same transmitter
+// boots: sequence numbers are what lines the receivers up, so
+// each receiver's pings become one bitmap per transmitter and the
+// merge is word-wide OR / AND and popcount. A transmitter restart
+// (sequence jumps back) ends its bitmap in that file; the pings
+// after it are counted and ignored.
+//
+// ============================================================
+
+#include "binlog_reader.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint32_t kLateWindow = 256;        // A sequence this far behind is late, further is a restart
+static const uint32_t kMaxSpanBits = 1u << 30;  // Sequences per transmitter (128 MB bitmap)
+static const int kMaxReceivers = 26;            // Labelled A..Z
+static const int kExhaustiveReceivers = 12;     // Placement search tries every subset up to here
+
+// ============================================================
+//                    BITMAPS
+// ============================================================
+
+// Received sequences of one transmitter at one receiver. Bit i of
+// the map is sequence base + i.
+struct Bitmap {
+    bool any = false;
+    bool stopped = false;    // Restart seen, later pings ignored
+    uint32_t base = 0;       // Multiple of 64
+    uint32_t first = 0;      // Lowest and highest sequence heard
+    uint32_t last = 0;
+    uint32_t newest = 0;     // For restart detection
+    uint64_t pings = 0;
+    uint64_t ignored = 0;    // After a restart or beyond kMaxSpanBits
+    std::vector<uint64_t> words;
+
+    void set(uint32_t sequence) {
+        if (stopped) {
+            ignored++;
+            return;
+        }
+        if (!any) {
+            any = true;
+            base = (sequence - std::min(sequence, kLateWindow)) & ~63u;
+            first = last = newest = sequence;
+        } else if (sequence + kLateWindow < newest) {
+            stopped = true;
+            ignored++;
+            return;
+        }
+
+        if (sequence < base) {
+            uint32_t newBase = sequence & ~63u;
+            words.insert(words.begin(), (base - newBase) / 64, 0);
+            base = newBase;
+        }
+        uint32_t bit = sequence - base;
+        if (bit >= kMaxSpanBits) {
+            ignored++;
+            return;
+        }
+        if (bit / 64 >= words.size()) words.resize(bit / 64 + 1, 0);
+        uint64_t mask = 1ull << (bit % 64);
+        if (!(words[bit / 64] & mask)) pings++;
+        words[bit / 64] |= mask;
+
+        first = std::min(first, sequence);
+        last = std::max(last, sequence);
+        newest = std::max(newest, sequence);
+    }
+
+    uint64_t word(int64_t index) const {
+        return (index >= 0 && (uint64_t)index < words.size()) ? words[index] : 0;
+    }
+
+    // The 64 bits starting at sequence `from`
+    uint64_t bitsAt(uint32_t from) const {
+        int64_t offset = (int64_t)from - base;
+        int64_t index = (offset >= 0) ? offset / 64 : -((-offset + 63) / 64);
+        int shift = (int)(offset - index * 64);
+        uint64_t bits = word(index) >> shift;
+        if (shift != 0) bits |= word(index + 1) << (64 - shift);
+        return bits;
+    }
+};
+
+// Words covering sequences lo..hi, bit 0 = lo, bits past hi cleared
+static std::vector<uint64_t> alignedBits(const Bitmap* map, uint32_t lo, uint32_t hi) {
+    size_t bits = (size_t)(hi - lo) + 1;
+    std::vector<uint64_t> out((bits + 63) / 64, 0);
+    if (map == nullptr) return out;
+    for (size_t i = 0; i < out.size(); i++) out[i] = map->bitsAt(lo + (uint32_t)(i * 64));
+    if (bits % 64) out.back() &= (1ull << (bits % 64)) - 1;
+    return out;
+}
+
+static uint64_t popcount(const std::vector<uint64_t>& words) {
+    uint64_t count = 0;
+    for (uint64_t w : words) count += __builtin_popcountll(w);
+    return count;
+}
+
+// ============================================================
+//                    DECODE
+// ============================================================
+
+static uint64_t macKey(const uint8_t* mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+    return key;
+}
+
+static void formatMac(uint64_t key, char* out) {
+    snprintf(out, 18, "%02X:%02X:%02X:%02X:%02X:%02X", (unsigned)(key >> 40) & 0xFF,
+             (unsigned)(key >> 32) & 0xFF, (unsigned)(key >> 24) & 0xFF, (unsigned)(key >> 16) & 0xFF,
+             (unsigned)(key >> 8) & 0xFF, (unsigned)key & 0xFF);
+}
+
+struct Receiver {
+    std::string path;
+    MappedFile file;
+    uint64_t blocks = 0;
+    uint64_t records = 0;
+    std::map<uint64_t, Bitmap> maps;  // By transmitter MAC
+};
+
+static void decodeReceiver(Receiver* rx) {
+    const uint8_t* end = rx->file.data + rx->file.size;
+    for (const uint8_t* p = findMagic(rx->file.data, end); p < end;) {
+        size_t size = blockAt(p, end);
+        if (size == 0) {
+            p = findMagic(p + 1, end);
+            continue;
+        }
+
+        BinlogHeader header;
+        memcpy(&header, p, sizeof(header));
+        const BinlogMacEntry* macs = (const BinlogMacEntry*)(p + sizeof(BinlogHeader));
+        const BinlogRecord* records = (const BinlogRecord*)(macs + header.macCount);
+        Bitmap* slot[256];
+        for (int i = 0; i < header.macCount; i++) slot[i] = &rx->maps[macKey(macs[i].mac)];
+        for (uint16_t i = 0; i < header.records; i++) {
+            uint32_t baseSequence;
+            memcpy(&baseSequence, &macs[records[i].macIndex].baseSequence, sizeof(baseSequence));
+            slot[records[i].macIndex]->set(baseSequence + records[i].sequenceOffset);
+        }
+        rx->blocks++;
+        rx->records += header.records;
+        p = findMagic(p + size, end);
+    }
+}
+
+// ============================================================
+//                    ANALYSIS
+// ============================================================
+
+// One transmitter, every receiver's bitmap aligned to the same span
+struct Transmitter {
+    uint64_t mac;
+    uint32_t lo;
+    uint32_t hi;
+    uint64_t slots;
+    std::vector<std::vector<uint64_t>> bits;  // Per receiver
+    std::vector<uint64_t> delivered;          // Per receiver
+};
+
+static uint64_t unionCount(const Transmitter& tx, uint32_t subset) {
+    uint64_t count = 0;
+    size_t words = tx.bits[0].size();
+    for (size_t w = 0; w < words; w++) {
+        uint64_t any = 0;
+        for (size_t r = 0; r < tx.bits.size(); r++) {
+            if (subset & (1u << r)) any |= tx.bits[r][w];
+        }
+        count += __builtin_popcountll(any);
+    }
+    return count;
+}
+
+static std::string subsetName(uint32_t subset, int receivers) {
+    std::string name;
+    for (int r = 0; r < receivers; r++) {
+        if (!(subset & (1u << r))) continue;
+        if (!name.empty()) name += "+";
+        name += (char)('A' + r);
+    }
+    return name;
+}
+
+static double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * part / whole : 0.0;
+}
+
+struct Placement {
+    uint32_t subset = 0;
+    uint64_t delivered = 0;
+    double worst = 0;          // Lowest per-transmitter delivery, %
+    uint64_t worstMac = 0;
+};
+
+static Placement evaluate(const std::vector<Transmitter>& txs, uint32_t subset) {
+    Placement p;
+    p.subset = subset;
+    p.worst = 101;
+    for (const Transmitter& tx : txs) {
+        uint64_t count = unionCount(tx, subset);
+        p.delivered += count;
+        double rate = percent(count, tx.slots);
+        if (rate < p.worst) {
+            p.worst = rate;
+            p.worstMac = tx.mac;
+        }
+    }
+    return p;
+}
+
+static bool better(const Placement& a, const Placement& b, bool byWorst) {
+    if (byWorst && a.worst != b.worst) return a.worst > b.worst;
+    if (a.delivered != b.delivered) return a.delivered > b.delivered;
+    return a.worst > b.worst;
+}
+
+// ============================================================
+//                    MAIN
+// ============================================================
+
+static void usage(const char* program) {
+    fprintf(stderr, "usage: %s [--span common|union] [--rank total|worst] rx1.bin rx2.bin [...]\n", program);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    bool commonSpan = true;
+    bool rankWorst = false;
+    std::vector<Receiver> receivers;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--span") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            if (strcmp(value, "common") != 0 && strcmp(value, "union") != 0) usage(argv[0]);
+            commonSpan = (strcmp(value, "common") == 0);
+        } else if (strcmp(arg, "--rank") == 0 && i + 1 < argc) {
+            const char* value = argv[++i];
+            if (strcmp(value, "total") != 0 && strcmp(value, "worst") != 0) usage(argv[0]);
+            rankWorst = (strcmp(value, "worst") == 0);
+        } else if (arg[0] == '-') {
+            usage(argv[0]);
+        } else {
+            Receiver rx;
+            rx.path = arg;
+            receivers.push_back(rx);
+        }
+    }
+    if (receivers.size() < 2 || receivers.size() > (size_t)kMaxReceivers) usage(argv[0]);
+
+    for (Receiver& rx : receivers) {
+        if (!mapFile(rx.path.c_str(), &rx.file)) {
+            fprintf(stderr, "error: cannot map %s\n", rx.path.c_str());
+            return 2;
+        }
+    }
+
+    // One thread per receiver; the files are independent
+    std::vector<std::thread> threads;
+    for (Receiver& rx : receivers) threads.emplace_back(decodeReceiver, &rx);
+    for (std::thread& t : threads) t.join();
+
+    int count = (int)receivers.size();
+    printf("Receivers\n");
+    printf("  %-2s %-28s %8s %12s %6s %10s\n", "", "file", "blocks", "pings", "tx", "ignored");
+    for (int r = 0; r < count; r++) {
+        const Receiver& rx = receivers[r];
+        uint64_t ignored = 0;
+        for (const auto& entry : rx.maps) ignored += entry.second.ignored;
+        printf("  %-2c %-28.28s %8" PRIu64 " %12" PRIu64 " %6zu %10" PRIu64 "\n", 'A' + r, rx.path.c_str(),
+               rx.blocks, rx.records, rx.maps.size(), ignored);
+    }
+
+    // Align every transmitter heard anywhere
+    std::map<uint64_t, bool> macs;
+    for (const Receiver& rx : receivers) {
+        for (const auto& entry : rx.maps) macs[entry.first] = true;
+    }
+
+    std::vector<Transmitter> txs;
+    for (const auto& m : macs) {
+        bool have = false;
+        uint32_t lo = 0;
+        uint32_t hi = 0;
+        for (const Receiver& rx : receivers) {
+            auto it = rx.maps.find(m.first);
+            if (it == rx.maps.end()) continue;
+            const Bitmap& map = it->second;
+            if (!have) {
+                lo = map.first;
+                hi = map.last;
+                have = true;
+            } else if (commonSpan) {
+                lo = std::max(lo, map.first);
+                hi = std::min(hi, map.last);
+            } else {
+                lo = std::min(lo, map.first);
+                hi = std::max(hi, map.last);
+            }
+        }
+        if (!have || hi < lo) continue;  // Captures never overlapped
+
+        Transmitter tx;
+        tx.mac = m.first;
+        tx.lo = lo;
+        tx.hi = hi;
+        tx.slots = (uint64_t)(hi - lo) + 1;
+        for (const Receiver& rx : receivers) {
+            auto it = rx.maps.find(m.first);
+            tx.bits.push_back(alignedBits(it == rx.maps.end() ? nullptr : &it->second, lo, hi));
+            tx.delivered.push_back(popcount(tx.bits.back()));
+        }
+        txs.push_back(std::move(tx));
+    }
+    if (txs.empty()) {
+        fprintf(stderr, "error: no transmitter with overlapping captures\n");
+        return 1;
+    }
+
+    uint32_t all = (1u << count) - 1;
+    char mac[18];
+
+    // Per transmitter: each receiver, the union and the gain over the best one
+    printf("\nDelivery per transmitter (%s span)\n", commonSpan ? "common" : "union");
+    printf("  %-17s %10s", "transmitter", "slots");
+    for (int r = 0; r < count; r++) printf("  %6c", 'A' + r);
+    printf("  %7s %8s %7s\n", "any", "gain pp", "loss /");
+    uint64_t totalSlots = 0;
+    for (const Transmitter& tx : txs) {
+        uint64_t best = *std::max_element(tx.delivered.begin(), tx.delivered.end());
+        uint64_t any = unionCount(tx, all);
+        totalSlots += tx.slots;
+        formatMac(tx.mac, mac);
+        printf("  %-17s %10" PRIu64, mac, tx.slots);
+        for (int r = 0; r < count; r++) printf("  %5.1f%%", percent(tx.delivered[r], tx.slots));
+        printf("  %6.2f%% %+8.2f", percent(any, tx.slots), percent(any - best, tx.slots));
+        if (any == tx.slots) {
+            printf(" %7s\n", best == any ? "-" : "all");
+        } else {
+            printf(" %7.1f\n", (double)(tx.slots - best) / (tx.slots - any));
+        }
+    }
+    printf("  gain = any minus the best single receiver, loss / = how many times fewer pings are lost\n");
+
+    // Pairwise overlap over all transmitters
+    printf("\nPairwise overlap (all transmitters)\n");
+    printf("  %-5s %8s %8s %8s %9s %10s %6s\n", "pair", "rx1", "rx2", "both", "either", "both lost", "lift");
+    for (int a = 0; a < count; a++) {
+        for (int b = a + 1; b < count; b++) {
+            uint64_t both = 0;
+            uint64_t either = 0;
+            uint64_t gotA = 0;
+            uint64_t gotB = 0;
+            for (const Transmitter& tx : txs) {
+                const std::vector<uint64_t>& x = tx.bits[a];
+                const std::vector<uint64_t>& y = tx.bits[b];
+                for (size_t w = 0; w < x.size(); w++) {
+                    both += __builtin_popcountll(x[w] & y[w]);
+                    either += __builtin_popcountll(x[w] | y[w]);
+                }
+                gotA += tx.delivered[a];
+                gotB += tx.delivered[b];
+            }
+            uint64_t lostA = totalSlots - gotA;
+            uint64_t lostB = totalSlots - gotB;
+            uint64_t bothLost = totalSlots - either;
+            // P(both lost) / (P(A lost) P(B lost)): 1 if the receivers lose independently
+            double expected = (double)lostA * lostB / totalSlots;
+            char lift[16];
+            if (expected > 0) {
+                snprintf(lift, sizeof(lift), "%.2f", bothLost / expected);
+            } else {
+                snprintf(lift, sizeof(lift), "-");
+            }
+            printf("  %c+%c   %7.2f%% %7.2f%% %7.2f%% %8.2f%% %9.3f%% %6s\n", 'A' + a, 'A' + b,
+                   percent(gotA, totalSlots), percent(gotB, totalSlots), percent(both, totalSlots),
+                   percent(either, totalSlots), percent(bothLost, totalSlots), lift);
+        }
+    }
+    printf("  lift = both lost / expected if independent: ~1 adds diversity, >>1 shares a dead zone\n");
+
+    // Best receiver set of each size
+    bool exhaustive = (count <= kExhaustiveReceivers);
+    printf("\nBest placement (%s, %s)\n", rankWorst ? "worst transmitter first" : "total delivery",
+           exhaustive ? "every subset" : "greedy");
+    printf("  %-2s %-27s %9s %9s  %s\n", "n", "receivers", "delivery", "worst", "worst transmitter");
+    uint32_t chosen = 0;
+    for (int size = 1; size <= count; size++) {
+        Placement best;
+        bool found = false;
+        if (exhaustive) {
+            for (uint32_t subset = 1; subset <= all; subset++) {
+                if (__builtin_popcount(subset) != size) continue;
+                Placement p = evaluate(txs, subset);
+                if (!found || better(p, best, rankWorst)) best = p;
+                found = true;
+            }
+        } else {
+            for (int r = 0; r < count; r++) {
+                if (chosen & (1u << r)) continue;
+                Placement p = evaluate(txs, chosen | (1u << r));
+                if (!found || better(p, best, rankWorst)) best = p;
+                found = true;
+            }
+            chosen = best.subset;
+        }
+        formatMac(best.worstMac, mac);
+        printf("  %-2d %-27s %8.3f%% %8.3f%%  %s\n", size, subsetName(best.subset, count).c_str(),
+               percent(best.delivered, totalSlots), best.worst, mac);
+    }
+    return 0;
+}
@@ -0,0 +1,463 @@
+// ============================================================
+//            FEC WHAT-IF SIMULATOR
+// ============================================================
+//
+// Replays the loss pattern recorded in binary ping logs (B command,
+// see src/BinaryLog.h) through candidate forward error correction
+// schemes and reports, per scheme, the residual loss, the added
+// overhead and the decode latency - to pick a scheme for game-
+// critical messages from real field data rather than i.i.d. loss.
+//
+// Build:
+//   g++ -O2 -std=c++17 -pthread -o fec_whatif tools/fec_whatif.cpp
+//
+// Usage:
+//   fec_whatif [options] run1.bin [run2.bin ...]
+//     -j N                Simulation threads (default: all cores)
+//     --slot-ms MS        Ping interval, for latency (default: from the trace)
+//     --max-overhead PCT  Only show schemes up to this overhead
+//     --max-latency MS    Only show schemes with p99 decode latency up to this
+//     --all               Show every scheme within the limits, not just
+//                         the Pareto front (least residual loss for its
+//                         overhead)
+//     --csv FILE          Write every scheme as CSV
+//
+// Each ping slot of a trace stands for one channel use: a scheme
+// sends its data and parity packets in consecutive slots, and a
+// packet is lost exactly when the recorded ping in that slot was.
+// Schemes, all systematic (data packets are delivered as they
+// arrive, parity only fills holes):
+//   rep r        every message sent r times            (r, 1)
+//   xor k        k messages + one XOR parity packet    (k+1, k)
+//   rs n,k       Reed-Solomon over GF(256)             (n, k)
+// All three are MDS erasure codes, so a block decodes exactly when
+// any k of its n packets arrive - the simulation counts, it does
+// not need to encode. They differ in cost: XOR parity is a byte
+// XOR, Reed-Solomon needs GF(256) arithmetic at both ends.
+//
+// Every scheme is also tried with block interleaving of depth d:
+// d blocks are sent interleaved packet by packet, so a burst of
+// up to d losses costs each block one packet - at d times the
+// latency.
+//
+// Decode latency of a recovered message: from its own slot to the
+// slot in which the k-th packet of its block arrived, times the
+// ping interval. Residual loss counts messages neither received nor
+// recovered. A trace is one transmitter in one file between
+// restarts; tails shorter than a whole interleaved frame are left
+// out for every scheme alike.
+//
+// ============================================================
+
+#include "binlog_reader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const uint32_t kLateWindow = 256;        // A sequence this far behind is late, further is a restart
+static const uint32_t kMaxTraceSlots = 1u << 30;  // Per trace (128 MB bitmap)
+static const uint32_t kMinTraceSlots = 1000;    // Shorter traces are skipped
+
+// Default sweep: 330 schemes
+static const int kRepeats[] = {2, 3, 4};
+static const int kXorK[] = {2, 3, 4, 5, 6, 8, 10, 12, 16};
+static const int kRsK[] = {2, 4, 6, 8, 10, 12, 16, 20, 24};
+static const int kRsParity[] = {2, 3, 4, 6, 8, 12};
+static const int kDepths[] = {1, 2, 4, 8, 16};
+
+// ============================================================
+//                    TRACES
+// ============================================================
+
+// Received slots of one transmitter between restarts: bit i is
+// sequence first + i
+struct Trace {
+    uint64_t mac = 0;
+    size_t file = 0;
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint32_t firstMs = 0;     // Arrival of first / last
+    uint32_t lastMs = 0;
+    uint64_t received = 0;
+    std::vector<uint64_t> bits;
+
+    uint64_t slots() const {
+        return (uint64_t)(last - first) + 1;
+    }
+
+    bool got(uint64_t slot) const {
+        return (bits[slot / 64] >> (slot % 64)) & 1;
+    }
+
+    void set(uint32_t sequence, uint32_t ms) {
+        uint32_t bit = sequence - first;
+        if (bit / 64 >= bits.size()) bits.resize(bit / 64 + 1, 0);
+        uint64_t mask = 1ull << (bit % 64);
+        if (bits[bit / 64] & mask) return;  // Duplicate
+        bits[bit / 64] |= mask;
+        received++;
+        if (sequence > last) {
+            last = sequence;
+            lastMs = ms;
+        }
+    }
+};
+
+static uint64_t macKey(const uint8_t* mac) {
+    uint64_t key = 0;
+    for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+    return key;
+}
+
+static void formatMac(uint64_t key, char* out) {
+    snprintf(out, 18, "%02X:%02X:%02X:%02X:%02X:%02X", (unsigned)(key >> 40) & 0xFF,
+             (unsigned)(key >> 32) & 0xFF, (unsigned)(key >> 24) & 0xFF, (unsigned)(key >> 16) & 0xFF,
+             (unsigned)(key >> 8) & 0xFF, (unsigned)key & 0xFF);
+}
+
+// All traces in one log, in file order per transmitter
+static void readTraces(const MappedFile& file, size_t fileIndex, std::vector<Trace>* out) {
+    std::map<uint64_t, Trace> open;
+    const uint8_t* end = file.data + file.size;
+
+    auto close = [&](Trace& trace) {
+        if (trace.slots() >= kMinTraceSlots) out->push_back(std::move(trace));
+    };
+
+    for (const uint8_t* p = findMagic(file.data, end); p < end;) {
+        size_t size = blockAt(p, end);
+        if (size == 0) {
+            p = findMagic(p + 1, end);
+            continue;
+        }
+
+        BinlogHeader header;
+        memcpy(&header, p, sizeof(header));
+        const BinlogMacEntry* macs = (const BinlogMacEntry*)(p + sizeof(BinlogHeader));
+        const BinlogRecord* records = (const BinlogRecord*)(macs + header.macCount);
+        for (uint16_t i = 0; i < header.records; i++) {
+            const BinlogMacEntry* entry = &macs[records[i].macIndex];
+            uint32_t baseSequence;
+            memcpy(&baseSequence, &entry->baseSequence, sizeof(baseSequence));
+            uint32_t sequence = baseSequence + records[i].sequenceOffset;
+            uint32_t ms = header.baseMs + records[i].offsetMs;
+            uint64_t key = macKey(entry->mac);
+
+            auto it = open.find(key);
+            if (it != open.end()) {
+                Trace& trace = it->second;
+                bool restart = (sequence + kLateWindow < trace.last) ||
+                               (sequence >= trace.first && sequence - trace.first >= kMaxTraceSlots);
+                if (!restart) {
+                    if (sequence >= trace.first) trace.set(sequence, ms);  // Late pings before the start are dropped
+                    continue;
+                }
+                close(trace);
+                open.erase(it);
+            }
+
+            Trace trace;
+            trace.mac = key;
+            trace.file = fileIndex;
+            trace.first = trace.last = sequence;
+            trace.firstMs = trace.lastMs = ms;
+            trace.set(sequence, ms);
+            open[key] = std::move(trace);
+        }
+        p = findMagic(p + size, end);
+    }
+    for (auto& entry : open) close(entry.second);
+}
+
+// ============================================================
+//                    SCHEMES
+// ============================================================
+
+enum SchemeKind { SCHEME_REP, SCHEME_XOR, SCHEME_RS };
+
+struct Scheme {
+    SchemeKind kind;
+    int n;       // Packets per block
+    int k;       // Messages per block
+    int depth;   // Interleaved blocks
+
+    std::string name() const {
+        char text[32];
+        switch (kind) {
+            case SCHEME_REP: snprintf(text, sizeof(text), "rep %d", n); break;
+            case SCHEME_XOR: snprintf(text, sizeof(text), "xor %d", k); break;
+            case SCHEME_RS:  snprintf(text, sizeof(text), "rs %d,%d", n, k); break;
+        }
+        std::string out = text;
+        if (depth > 1) out += " /" + std::to_string(depth);
+        return out;
+    }
+
+    double overhead() const {
+        return (double)(n - k) / k;
+    }
+};
+
+struct Result {
+    uint64_t messages = 0;
+    uint64_t lost = 0;        // Messages whose own packet was lost
+    uint64_t residual = 0;    // ... and could not be recovered
+    std::vector<uint64_t> latency;  // Recovered messages by decode latency in slots
+    double slotMs = 0;        // Weighted by messages
+
+    double residualLoss() const {
+        return messages ? (double)residual / messages : 0;
+    }
+
+    // Latency in slots that this fraction of recovered messages stay within
+    uint64_t latencyQuantile(double q) const {
+        uint64_t total = 0;
+        for (uint64_t c : latency) total += c;
+        if (total == 0) return 0;
+        uint64_t target = std::max<uint64_t>(1, (uint64_t)std::ceil(q * total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < latency.size(); i++) {
+            seen += latency[i];
+            if (seen >= target) return i;
+        }
+        return latency.size() - 1;
+    }
+
+    double latencyMean() const {
+        uint64_t total = 0;
+        double sum = 0;
+        for (size_t i = 0; i < latency.size(); i++) {
+            total += latency[i];
+            sum += (double)i * latency[i];
+        }
+        return total ? sum / total : 0;
+    }
+};
+
+static double traceSlotMs(const Trace& trace, double forcedSlotMs) {
+    if (forcedSlotMs > 0) return forcedSlotMs;
+    if (trace.last == trace.first) return 0;
+    return (double)(trace.lastMs - trace.firstMs) / (trace.last - trace.first);
+}
+
+static void simulate(const Scheme& scheme, const std::vector<Trace>& traces, double forcedSlotMs,
+                     Result* result) {
+    const int n = scheme.n;
+    const int k = scheme.k;
+    const int depth = scheme.depth;
+    const uint64_t frame = (uint64_t)n * depth;
+    result->latency.assign(frame, 0);
+    double slotWeight = 0;
+
+    for (const Trace& trace : traces) {
+        uint64_t slots = trace.slots();
+        uint64_t messagesBefore = result->messages;
+        for (uint64_t start = 0; start + frame <= slots; start += frame) {
+            for (int b = 0; b < depth; b++) {
+                // Packet j of block b goes out in slot start + j * depth + b
+                int got = 0;
+                uint64_t decodedAt = 0;
+                for (int j = 0; j < n; j++) {
+                    uint64_t slot = start + (uint64_t)j * depth + b;
+                    if (trace.got(slot) && ++got == k) decodedAt = slot;
+                }
+                for (int j = 0; j < k; j++) {
+                    uint64_t slot = start + (uint64_t)j * depth + b;
+                    result->messages++;
+                    if (trace.got(slot)) continue;
+                    result->lost++;
+                    if (got < k) {
+                        result->residual++;
+                    } else {
+                        result->latency[(decodedAt > slot) ? decodedAt - slot : 0]++;
+                    }
+                }
+            }
+        }
+        slotWeight += traceSlotMs(trace, forcedSlotMs) * (result->messages - messagesBefore);
+    }
+    result->slotMs = result->messages ? slotWeight / result->messages : 0;
+}
+
+static std::vector<Scheme> defaultSweep() {
+    std::vector<Scheme> schemes;
+    for (int depth : kDepths) {
+        for (int r : kRepeats) schemes.push_back({SCHEME_REP, r, 1, depth});
+        for (int k : kXorK) schemes.push_back({SCHEME_XOR, k + 1, k, depth});
+        for (int k : kRsK) {
+            for (int m : kRsParity) schemes.push_back({SCHEME_RS, k + m, k, depth});
+        }
+    }
+    return schemes;
+}
+
+// ============================================================
+//                    MAIN
+// ============================================================
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [-j N] [--slot-ms MS] [--max-overhead PCT] [--max-latency MS] [--all] [--csv FILE]\n"
+            "          log.bin...\n",
+            program);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    double forcedSlotMs = 0;
+    double maxOverhead = -1;
+    double maxLatencyMs = -1;
+    bool showAll = false;
+    const char* csvPath = nullptr;
+    std::vector<MappedFile> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "-j") == 0 && hasValue) {
+            threads = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(arg, "--slot-ms") == 0 && hasValue) {
+            forcedSlotMs = atof(argv[++i]);
+        } else if (strcmp(arg, "--max-overhead") == 0 && hasValue) {
+            maxOverhead = atof(argv[++i]) / 100;
+        } else if (strcmp(arg, "--max-latency") == 0 && hasValue) {
+            maxLatencyMs = atof(argv[++i]);
+        } else if (strcmp(arg, "--all") == 0) {
+            showAll = true;
+        } else if (strcmp(arg, "--csv") == 0 && hasValue) {
+            csvPath = argv[++i];
+        } else if (arg[0] == '-') {
+            usage(argv[0]);
+        } else {
+            MappedFile file;
+            if (!mapFile(arg, &file)) {
+                fprintf(stderr, "error: cannot map %s\n", arg);
+                return 2;
+            }
+            files.push_back(file);
+        }
+    }
+    if (files.empty()) usage(argv[0]);
+
+    auto startTime = std::chrono::steady_clock::now();
+    std::vector<Trace> traces;
+    for (size_t f = 0; f < files.size(); f++) readTraces(files[f], f, &traces);
+    if (traces.empty()) {
+        fprintf(stderr, "error: no trace of %u pings or more\n", kMinTraceSlots);
+        return 1;
+    }
+
+    char mac[18];
+    uint64_t totalSlots = 0;
+    uint64_t totalReceived = 0;
+    printf("Traces\n");
+    printf("  %-28s %-17s %11s %8s %8s\n", "file", "transmitter", "slots", "loss", "slot ms");
+    for (const Trace& trace : traces) {
+        formatMac(trace.mac, mac);
+        printf("  %-28.28s %-17s %11" PRIu64 " %7.3f%% %8.2f\n", files[trace.file].path.c_str(), mac,
+               trace.slots(), 100.0 * (trace.slots() - trace.received) / trace.slots(),
+               traceSlotMs(trace, forcedSlotMs));
+        totalSlots += trace.slots();
+        totalReceived += trace.received;
+    }
+
+    // Batch: one scheme per job, every trace per scheme
+    std::vector<Scheme> schemes = defaultSweep();
+    std::vector<Result> results(schemes.size());
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::min<size_t>(threads, schemes.size()); t++) {
+        pool.emplace_back([&]() {
+            for (size_t i = next++; i < schemes.size(); i = next++) {
+                simulate(schemes[i], traces, forcedSlotMs, &results[i]);
+            }
+        });
+    }
+    for (std::thread& t : pool) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    // Pareto front among the schemes within the limits: no other one
+    // has at most the overhead and residual loss and is better on one
+    // of them (or on p99 latency, for an otherwise equal pair)
+    size_t count = schemes.size();
+    std::vector<double> p99Ms(count);
+    std::vector<bool> eligible(count);
+    for (size_t i = 0; i < count; i++) {
+        p99Ms[i] = results[i].latencyQuantile(0.99) * results[i].slotMs;
+        eligible[i] = (maxOverhead < 0 || schemes[i].overhead() <= maxOverhead + 1e-9) &&
+                      (maxLatencyMs < 0 || p99Ms[i] <= maxLatencyMs);
+    }
+    std::vector<bool> front(eligible);
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = 0; j < count && front[i]; j++) {
+            if (i == j || !eligible[j]) continue;
+            double oi = schemes[i].overhead();
+            double oj = schemes[j].overhead();
+            double ri = results[i].residualLoss();
+            double rj = results[j].residualLoss();
+            if (oj > oi || rj > ri) continue;
+            if (oj < oi || rj < ri || p99Ms[j] < p99Ms[i] || (p99Ms[j] == p99Ms[i] && j < i)) front[i] = false;
+        }
+    }
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (schemes[a].overhead() != schemes[b].overhead()) return schemes[a].overhead() < schemes[b].overhead();
+        return results[a].residualLoss() < results[b].residualLoss();
+    });
+
+    printf("\nRaw loss %.3f%% over %" PRIu64 " slots; %zu schemes, %s\n",
+           100.0 * (totalSlots - totalReceived) / totalSlots, totalSlots, count,
+           showAll ? "all within the limits" : "Pareto front (overhead vs residual loss)");
+    printf("  %-14s %9s %11s %9s %9s %9s %9s\n", "scheme", "overhead", "residual", "recovered", "lat mean",
+           "lat p99", "lat max");
+    int shown = 0;
+    for (size_t i : order) {
+        const Result& r = results[i];
+        if (!(showAll ? eligible[i] : front[i])) continue;
+        printf("  %-14s %8.1f%% %10.4f%% %8.1f%% %7.1fms %7.1fms %7.1fms\n", schemes[i].name().c_str(),
+               100 * schemes[i].overhead(), 100 * r.residualLoss(),
+               r.lost ? 100.0 * (r.lost - r.residual) / r.lost : 100.0, r.latencyMean() * r.slotMs, p99Ms[i],
+               r.latencyQuantile(1.0) * r.slotMs);
+        shown++;
+    }
+    if (shown == 0) printf("  (no scheme within the limits)\n");
+    printf("  lat = wait for a lost message to be rebuilt; /d = interleaved d deep\n");
+
+    if (csvPath) {
+        FILE* csv = fopen(csvPath, "w");
+        if (!csv) {
+            fprintf(stderr, "error: cannot write %s\n", csvPath);
+            return 1;
+        }
+        fprintf(csv, "scheme,n,k,depth,overhead,messages,lost,residual,residual_loss,latency_mean_ms,"
+                     "latency_p99_ms,latency_max_ms,pareto\n");
+        for (size_t i = 0; i < count; i++) {
+            const Scheme& s = schemes[i];
+            const Result& r = results[i];
+            static const char* kinds[] = {"rep", "xor", "rs"};
+            fprintf(csv, "%s,%d,%d,%d,%.4f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.6f,%.2f,%.2f,%.2f,%d\n",
+                    kinds[s.kind], s.n, s.k, s.depth, s.overhead(), r.messages, r.lost, r.residual,
+                    r.residualLoss(), r.latencyMean() * r.slotMs, p99Ms[i], r.latencyQuantile(1.0) * r.slotMs,
+                    front[i] ? 1 : 0);
+        }
+        fclose(csv);
+    }
+
+    fflush(stdout);
+    fprintf(stderr, "%zu schemes x %" PRIu64 " slots in %.2f s (%u threads)\n", count, totalSlots, seconds,
+            threads);
+    return 0;
+}
@@ -0,0 +1,575 @@
+// ============================================================
+//            RUN-TO-RUN REPORT COMPARISON
+// ============================================================
+//
+// Compares two structured reports from the receiver (J/V command,
+// REPORT_AT_END or a test plan report, see src/ReportWriter.h) -
+// typically a baseline run and a candidate run - and flags the
+// changes that are larger than the run-to-run noise.
+//
+// Build:
+//   g++ -O2 -std=c++17 -o report_compare tools/report_compare.cpp
+//
+// Usage:
+//   report_compare [options] baseline.log candidate.log
+//     --confidence P   Confidence level in percent (default 95)
+//     --min-loss PP    Smallest loss change that matters, percentage points (default 0.1)
+//     --min-burst N    ... mean loss run length, pings (default 0.1)
+//     --min-jitter MS  ... inter-arrival standard deviation, ms (default 0.1)
+//     --min-rssi DB    ... mean RSSI, dB (default 1)
+//     --flagged        Only print metrics that changed
+//
+// Each input is a serial log (the last [REPORT json|csv] ...
+// [REPORT END] block in it is used) or a bare JSON or CSV report.
+// Series are aligned by test profile and transmitter MAC: the
+// profile is the step text for test plan reports and "test" for
+// the receiver report, so a plan re-run against new firmware
+// lines up step by step.
+//
+// Per series, four metrics are compared with a confidence
+// interval on the change (normal approximation):
+//   loss       missed / (frames + missed); Newcombe interval for
+//              the difference of two proportions (Wilson bounds)
+//   burst len  mean length of a run of consecutive losses; Welch
+//   jitter     standard deviation of the inter-arrival time;
+//              SE(sd) ~ sd / sqrt(2(n-1)). Assumes roughly normal
+//              spacing, so treat marginal results with care.
+//   rssi       mean RSSI; Welch
+// A change is flagged only when the whole interval lies beyond the
+// minimum effect, so long runs do not flag differences too small to
+// matter. More loss, longer bursts, more jitter and lower RSSI are
+// WORSE.
+//
+// Exit status: 0 = nothing worse, 1 = at least one metric WORSE,
+// 2 = usage or input error.
+//
+// ============================================================
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================
+//                    INPUT
+// ============================================================
+
+// Flattened report: "a.b.3.c" -> value, the same paths the CSV
+// format uses, so JSON and CSV reports read the same way
+typedef std::map<std::string, std::string> Fields;
+
+static bool readFile(const char* path, std::string* text) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    *text = buffer.str();
+    return true;
+}
+
+// The last complete [REPORT fmt] ... [REPORT END] block, or the whole
+// text if there is no marker. Sets *csv from the marker or the content.
+static std::string extractReport(const std::string& text, bool* csv) {
+    size_t begin = std::string::npos;
+    size_t search = 0;
+    for (;;) {
+        size_t at = text.find("[REPORT ", search);
+        if (at == std::string::npos) break;
+        if (text.compare(at, 12, "[REPORT END]") != 0) begin = at;
+        search = at + 1;
+    }
+
+    if (begin == std::string::npos) {
+        size_t first = text.find_first_not_of(" \t\r\n");
+        *csv = (first == std::string::npos || text[first] != '{');
+        return text;
+    }
+
+    *csv = (text.compare(begin, 12, "[REPORT csv]") == 0);
+    size_t body = text.find('\n', begin);
+    if (body == std::string::npos) return std::string();
+    size_t end = text.find("[REPORT END]", body);
+    if (end == std::string::npos) end = text.size();
+    return text.substr(body + 1, end - body - 1);
+}
+
+struct JsonParser {
+    const std::string& text;
+    size_t pos;
+    Fields* fields;
+    bool ok;
+
+    void skipSpace() {
+        while (pos < text.size() && strchr(" \t\r\n", text[pos])) pos++;
+    }
+
+    bool expect(char c) {
+        skipSpace();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        ok = false;
+        return false;
+    }
+
+    std::string parseString() {
+        std::string out;
+        if (!expect('"')) return out;
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\' && pos < text.size()) {
+                char e = text[pos++];
+                switch (e) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'u': c = '?'; pos += 4; break;  // Reports only carry ASCII
+                    default: c = e; break;
+                }
+            }
+            out += c;
+        }
+        expect('"');
+        return out;
+    }
+
+    void parseValue(const std::string& path) {
+        skipSpace();
+        if (pos >= text.size()) {
+            ok = false;
+            return;
+        }
+        char c = text[pos];
+        if (c == '{') {
+            pos++;
+            skipSpace();
+            if (pos < text.size() && text[pos] == '}') {
+                pos++;
+                return;
+            }
+            while (ok) {
+                std::string key = parseString();
+                if (!expect(':')) return;
+                parseValue(path.empty() ? key : path + "." + key);
+                skipSpace();
+                if (pos < text.size() && text[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                expect('}');
+                return;
+            }
+        } else if (c == '[') {
+            pos++;
+            skipSpace();
+            if (pos < text.size() && text[pos] == ']') {
+                pos++;
+                return;
+            }
+            for (int index = 0; ok; index++) {
+                std::string key = std::to_string(index);
+                parseValue(path.empty() ? key : path + "." + key);
+                skipSpace();
+                if (pos < text.size() && text[pos] == ',') {
+                    pos++;
+                    continue;
+                }
+                expect(']');
+                return;
+            }
+        } else if (c == '"') {
+            (*fields)[path] = parseString();
+        } else {
+            size_t start = pos;
+            while (pos < text.size() && !strchr(",}] \t\r\n", text[pos])) pos++;
+            if (pos == start) {
+                ok = false;
+                return;
+            }
+            (*fields)[path] = text.substr(start, pos - start);
+        }
+    }
+};
+
+static bool parseJson(const std::string& text, Fields* fields) {
+    JsonParser parser{text, 0, fields, true};
+    parser.parseValue("");
+    return parser.ok;
+}
+
+// One CSV field starting at *pos; leaves *pos after the separator
+static std::string csvField(const std::string& line, size_t* pos) {
+    std::string out;
+    if (*pos < line.size() && line[*pos] == '"') {
+        (*pos)++;
+        while (*pos < line.size()) {
+            char c = line[(*pos)++];
+            if (c == '"') {
+                if (*pos < line.size() && line[*pos] == '"') {
+                    out += '"';
+                    (*pos)++;
+                    continue;
+                }
+                break;
+            }
+            out += c;
+        }
+    } else {
+        while (*pos < line.size() && line[*pos] != ',') out += line[(*pos)++];
+    }
+    if (*pos < line.size() && line[*pos] == ',') (*pos)++;
+    return out;
+}
+
+static bool parseCsv(const std::string& text, Fields* fields) {
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line == "path,value") continue;
+        size_t pos = 0;
+        std::string path = csvField(line, &pos);
+        (*fields)[path] = csvField(line, &pos);
+    }
+    return !fields->empty();
+}
+
+// ============================================================
+//                    SERIES
+// ============================================================
+
+struct Moments {
+    bool present = false;
+    double n = 0;
+    double mean = 0;
+    double sd = 0;
+};
+
+struct Series {
+    bool hasLoss = false;
+    double frames = 0;
+    double missed = 0;
+    Moments lossRuns;
+    Moments interArrival;
+    Moments rssi;
+};
+
+struct Report {
+    std::string kind;                      // "test-plan" or "receiver"
+    std::vector<std::string> order;        // Series keys in report order
+    std::map<std::string, Series> series;  // "profile|mac" -> statistics
+};
+
+static bool field(const Fields& fields, const std::string& path, double* value) {
+    auto it = fields.find(path);
+    if (it == fields.end() || it->second.empty()) return false;
+    *value = strtod(it->second.c_str(), nullptr);
+    return true;
+}
+
+static Moments readMoments(const Fields& fields, const std::string& prefix) {
+    Moments m;
+    m.present = field(fields, prefix + ".n", &m.n) && field(fields, prefix + ".mean", &m.mean) &&
+                field(fields, prefix + ".sd", &m.sd);
+    return m;
+}
+
+// Every transmitter under prefix ("transmitters" or "plan.N.transmitters")
+static void readTransmitters(const Fields& fields, const std::string& prefix, const std::string& profile,
+                             Report* report) {
+    for (int i = 0;; i++) {
+        std::string base = prefix + "." + std::to_string(i);
+        auto mac = fields.find(base + ".mac");
+        if (mac == fields.end()) return;
+
+        Series s;
+        s.hasLoss = field(fields, base + ".frames", &s.frames) && field(fields, base + ".missed", &s.missed);
+        s.lossRuns = readMoments(fields, base + ".loss_runs");
+        s.interArrival = readMoments(fields, base + ".inter_arrival_ms");
+        s.rssi = readMoments(fields, base + ".rssi_dbm");
+
+        std::string key = profile + "|" + mac->second;
+        if (report->series.count(key) == 0) report->order.push_back(key);
+        report->series[key] = s;
+    }
+}
+
+static bool loadReport(const char* path, Report* report) {
+    std::string text;
+    if (!readFile(path, &text)) {
+        fprintf(stderr, "error: cannot read %s\n", path);
+        return false;
+    }
+
+    bool csv = false;
+    std::string body = extractReport(text, &csv);
+    Fields fields;
+    if (!(csv ? parseCsv(body, &fields) : parseJson(body, &fields))) {
+        fprintf(stderr, "error: %s: no readable %s report\n", path, csv ? "CSV" : "JSON");
+        return false;
+    }
+
+    if (fields.count("plan.0.step")) {
+        // The same step text twice in one plan gets "#2", "#3", ...
+        report->kind = "test-plan";
+        std::map<std::string, int> seen;
+        for (int i = 0;; i++) {
+            std::string base = "plan." + std::to_string(i);
+            auto step = fields.find(base + ".step");
+            if (step == fields.end()) break;
+            std::string profile = step->second;
+            int repeat = ++seen[profile];
+            if (repeat > 1) profile += " #" + std::to_string(repeat);
+            readTransmitters(fields, base + ".transmitters", profile, report);
+        }
+    } else {
+        report->kind = "receiver";
+        readTransmitters(fields, "transmitters", "test", report);
+    }
+
+    if (report->series.empty()) {
+        fprintf(stderr, "error: %s: report has no per-transmitter results\n", path);
+        return false;
+    }
+    return true;
+}
+
+// ============================================================
+//                    STATISTICS
+// ============================================================
+
+struct Interval {
+    bool valid = false;
+    double change = 0;  // Candidate minus baseline
+    double low = 0;
+    double high = 0;
+};
+
+// Two-sided normal quantile for a confidence level (0..1)
+static double zForConfidence(double confidence) {
+    double tail = 1.0 - confidence;
+    double low = 0.0;
+    double high = 10.0;
+    for (int i = 0; i < 100; i++) {
+        double mid = (low + high) / 2;
+        if (std::erfc(mid / std::sqrt(2.0)) > tail) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return (low + high) / 2;
+}
+
+static void wilson(double successes, double trials, double z, double* low, double* high) {
+    double p = successes / trials;
+    double z2 = z * z;
+    double centre = (p + z2 / (2 * trials)) / (1 + z2 / trials);
+    double half = z * std::sqrt(p * (1 - p) / trials + z2 / (4 * trials * trials)) / (1 + z2 / trials);
+    *low = std::max(0.0, centre - half);
+    *high = std::min(1.0, centre + half);
+}
+
+// Loss in percentage points: Newcombe's hybrid score interval
+static Interval compareLoss(const Series& a, const Series& b, double z) {
+    Interval r;
+    double trialsA = a.frames + a.missed;
+    double trialsB = b.frames + b.missed;
+    if (!a.hasLoss || !b.hasLoss || trialsA <= 0 || trialsB <= 0) return r;
+
+    double pA = a.missed / trialsA;
+    double pB = b.missed / trialsB;
+    double lowA, highA, lowB, highB;
+    wilson(a.missed, trialsA, z, &lowA, &highA);
+    wilson(b.missed, trialsB, z, &lowB, &highB);
+
+    r.valid = true;
+    r.change = (pB - pA) * 100;
+    r.low = r.change - std::sqrt((pB - lowB) * (pB - lowB) + (highA - pA) * (highA - pA)) * 100;
+    r.high = r.change + std::sqrt((highB - pB) * (highB - pB) + (pA - lowA) * (pA - lowA)) * 100;
+    return r;
+}
+
+// Difference of means, Welch (large-sample z)
+static Interval compareMeans(const Moments& a, const Moments& b, double z) {
+    Interval r;
+    if (!a.present || !b.present || a.n < 2 || b.n < 2) return r;
+    double se = std::sqrt(a.sd * a.sd / a.n + b.sd * b.sd / b.n);
+    r.valid = true;
+    r.change = b.mean - a.mean;
+    r.low = r.change - z * se;
+    r.high = r.change + z * se;
+    return r;
+}
+
+// Difference of standard deviations, SE(sd) ~ sd / sqrt(2(n-1))
+static Interval compareSpread(const Moments& a, const Moments& b, double z) {
+    Interval r;
+    if (!a.present || !b.present || a.n < 2 || b.n < 2) return r;
+    double se = std::sqrt(a.sd * a.sd / (2 * (a.n - 1)) + b.sd * b.sd / (2 * (b.n - 1)));
+    r.valid = true;
+    r.change = b.sd - a.sd;
+    r.low = r.change - z * se;
+    r.high = r.change + z * se;
+    return r;
+}
+
+// ============================================================
+//                    OUTPUT
+// ============================================================
+
+enum Verdict { SAME, WORSE, BETTER };
+
+struct Options {
+    double confidence = 0.95;
+    double minLoss = 0.1;
+    double minBurst = 0.1;
+    double minJitter = 0.1;
+    double minRssi = 1.0;
+    bool flaggedOnly = false;
+};
+
+// higherIsWorse: an increase beyond minEffect is a regression
+static Verdict judge(const Interval& r, double minEffect, bool higherIsWorse) {
+    if (!r.valid) return SAME;
+    if (r.low > minEffect) return higherIsWorse ? WORSE : BETTER;
+    if (r.high < -minEffect) return higherIsWorse ? BETTER : WORSE;
+    return SAME;
+}
+
+struct Totals {
+    int series = 0;
+    int worse = 0;
+    int better = 0;
+};
+
+static void printMetric(const char* name, double base, double cand, const Interval& r, Verdict verdict,
+                        const Options& options, bool* headerDone, const std::string& title, Totals* totals) {
+    if (options.flaggedOnly && verdict == SAME) return;
+    if (!*headerDone) {
+        printf("\n[%s]\n", title.c_str());
+        printf("  %-14s %10s %10s %9s   %-22s\n", "metric", "baseline", "candidate", "change", "interval");
+        *headerDone = true;
+    }
+
+    if (!r.valid) {
+        printf("  %-14s %10s %10s %9s   %-22s\n", name, "-", "-", "-", "too few samples");
+        return;
+    }
+
+    char interval[48];
+    snprintf(interval, sizeof(interval), "[%+.2f, %+.2f]", r.low, r.high);
+    const char* flag = (verdict == WORSE) ? "WORSE" : (verdict == BETTER) ? "better" : "";
+    printf("  %-14s %10.2f %10.2f %+9.2f   %-22s %s\n", name, base, cand, r.change, interval, flag);
+    if (verdict == WORSE) totals->worse++;
+    if (verdict == BETTER) totals->better++;
+}
+
+static void compareSeries(const std::string& key, const Series& a, const Series& b, const Options& options,
+                          double z, Totals* totals) {
+    size_t bar = key.rfind('|');
+    std::string heading = key.substr(0, bar) + "  " + key.substr(bar + 1);
+    bool headerDone = false;
+    totals->series++;
+
+    Interval loss = compareLoss(a, b, z);
+    double lossA = (a.frames + a.missed > 0) ? a.missed * 100 / (a.frames + a.missed) : 0;
+    double lossB = (b.frames + b.missed > 0) ? b.missed * 100 / (b.frames + b.missed) : 0;
+    printMetric("loss %", lossA, lossB, loss, judge(loss, options.minLoss, true), options, &headerDone, heading,
+                totals);
+
+    Interval burst = compareMeans(a.lossRuns, b.lossRuns, z);
+    printMetric("burst len", a.lossRuns.mean, b.lossRuns.mean, burst, judge(burst, options.minBurst, true), options,
+                &headerDone, heading, totals);
+
+    Interval jitter = compareSpread(a.interArrival, b.interArrival, z);
+    printMetric("jitter sd ms", a.interArrival.sd, b.interArrival.sd, jitter, judge(jitter, options.minJitter, true),
+                options, &headerDone, heading, totals);
+
+    Interval rssi = compareMeans(a.rssi, b.rssi, z);
+    printMetric("rssi dBm", a.rssi.mean, b.rssi.mean, rssi, judge(rssi, options.minRssi, false), options,
+                &headerDone, heading, totals);
+}
+
+static void printUnmatched(const char* label, const Report& from, const Report& other) {
+    for (const std::string& key : from.order) {
+        if (other.series.count(key)) continue;
+        size_t bar = key.rfind('|');
+        printf("  only in %s: [%s]  %s\n", label, key.substr(0, bar).c_str(), key.substr(bar + 1).c_str());
+    }
+}
+
+// ============================================================
+//                    MAIN
+// ============================================================
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "usage: %s [--confidence P] [--min-loss PP] [--min-burst N] [--min-jitter MS] [--min-rssi DB]\n"
+            "          [--flagged] baseline.log candidate.log\n",
+            program);
+    exit(2);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<const char*> files;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(arg, "--confidence") == 0 && hasValue) {
+            options.confidence = atof(argv[++i]) / 100;
+        } else if (strcmp(arg, "--min-loss") == 0 && hasValue) {
+            options.minLoss = atof(argv[++i]);
+        } else if (strcmp(arg, "--min-burst") == 0 && hasValue) {
+            options.minBurst = atof(argv[++i]);
+        } else if (strcmp(arg, "--min-jitter") == 0 && hasValue) {
+            options.minJitter = atof(argv[++i]);
+        } else if (strcmp(arg, "--min-rssi") == 0 && hasValue) {
+            options.minRssi = atof(argv[++i]);
+        } else if (strcmp(arg, "--flagged") == 0) {
+            options.flaggedOnly = true;
+        } else if (arg[0] == '-' && arg[1] != '\0') {
+            usage(argv[0]);
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.size() != 2 || options.confidence <= 0.5 || options.confidence >= 1) usage(argv[0]);
+
+    Report baseline;
+    Report candidate;
+    if (!loadReport(files[0], &baseline) || !loadReport(files[1], &candidate)) return 2;
+    if (baseline.kind != candidate.kind) {
+        fprintf(stderr, "warning: comparing a %s report with a %s report - no series will line up\n",
+                baseline.kind.c_str(), candidate.kind.c_str());
+    }
+
+    double z = zForConfidence(options.confidence);
+    printf("baseline:  %s (%s, %zu series)\n", files[0], baseline.kind.c_str(), baseline.series.size());
+    printf("candidate: %s (%s, %zu series)\n", files[1], candidate.kind.c_str(), candidate.series.size());
+    printf("%.4g%% intervals on candidate - baseline; flagged when the whole interval is past\n",
+           options.confidence * 100);
+    printf("the minimum effect (loss %.2g pp, burst %.2g, jitter %.2g ms, rssi %.2g dB)\n", options.minLoss,
+           options.minBurst, options.minJitter, options.minRssi);
+
+    Totals totals;
+    for (const std::string& key : baseline.order) {
+        auto match = candidate.series.find(key);
+        if (match == candidate.series.end()) continue;
+        compareSeries(key, baseline.series.at(key), match->second, options, z, &totals);
+    }
+
+    printf("\n%d series compared: %d metrics worse, %d better\n", totals.series, totals.worse, totals.better);
+    printUnmatched("baseline", baseline, candidate);
+    printUnmatched("candidate", candidate, baseline);
+    return (totals.worse > 0) ? 1 : 0;
+}
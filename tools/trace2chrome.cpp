@@ -0,0 +1,303 @@
+// ============================================================
+//            TRACE DUMP -> CHROME/PERFETTO JSON
+// ============================================================
+//
+// Converts a [TRACE] dump captured from the receiver's serial
+// output (T command, see src/Trace.h) into Chrome trace-event
+// JSON, viewable in chrome://tracing or ui.perfetto.dev.
+//
+// Build:
+//   g++ -O2 -std=c++17 -o trace2chrome tools/trace2chrome.cpp
+//
+// Usage:
+//   trace2chrome log.txt > trace.json
+//   pio device monitor | tee log.txt   (capture, then convert)
+//
+// Lines not containing "[TRACE]" are ignored, so a full session
+// log can be passed as-is. If the log holds several dumps, the
+// last complete one is converted.
+//
+// Each core becomes one thread track. CCOUNT values are unwrapped
+// per core and placed on a shared timeline using the TRACE_SYNC
+// events (CCOUNT paired with esp_timer time on each core).
+//
+// ============================================================
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct EventName {
+    std::string name;
+    char phase = 'i';
+};
+
+struct RawEvent {
+    int core;
+    int id;
+    uint32_t ccount;
+    uint32_t arg;
+};
+
+struct Dump {
+    double cpuMhz = 240.0;
+    std::map<int, EventName> names;
+    std::vector<RawEvent> events;
+};
+
+struct TimedEvent {
+    double ts;       // Microseconds on the shared timeline
+    int core;
+    int id;
+    uint32_t arg;
+    size_t order;    // Original ring order (stable tie-break)
+};
+
+static const int kSyncEventId = 0;
+
+// Parse the last complete dump from the log
+static bool parseLog(std::istream& in, Dump* out) {
+    std::string line;
+    Dump current;
+    bool inDump = false;
+    bool found = false;
+
+    while (std::getline(in, line)) {
+        size_t pos = line.find("[TRACE]");
+        if (pos == std::string::npos) continue;
+
+        std::istringstream fields(line.substr(pos + 7));
+        std::string kind;
+        fields >> kind;
+
+        if (kind == "BEGIN") {
+            current = Dump();
+            inDump = true;
+            std::string field;
+            while (fields >> field) {
+                if (field.rfind("cpu_mhz=", 0) == 0) {
+                    current.cpuMhz = std::atof(field.c_str() + 8);
+                }
+            }
+        } else if (!inDump) {
+            continue;
+        } else if (kind == "NAME") {
+            int id;
+            EventName name;
+            if (fields >> id >> name.phase >> name.name) {
+                current.names[id] = name;
+            }
+        } else if (kind == "EV") {
+            RawEvent ev;
+            unsigned long ccount, arg;
+            if (fields >> ev.core >> ev.id >> ccount >> arg) {
+                ev.ccount = (uint32_t)ccount;
+                ev.arg = (uint32_t)arg;
+                current.events.push_back(ev);
+            }
+        } else if (kind == "END") {
+            *out = current;
+            inDump = false;
+            found = true;
+        }
+    }
+    return found;
+}
+
+// Unwrap CCOUNT per core and align cores using TRACE_SYNC
+static std::vector<TimedEvent> buildTimeline(const Dump& dump) {
+    std::map<int, std::vector<size_t>> byCore;
+    for (size_t i = 0; i < dump.events.size(); i++) {
+        byCore[dump.events[i].core].push_back(i);
+    }
+
+    // Local time in microseconds since the first record of each core.
+    // Records can be slightly out of order (deferred begin/end pairs),
+    // so each step is taken as a signed 32-bit delta.
+    std::vector<double> local(dump.events.size(), 0.0);
+    std::map<int, std::pair<double, uint32_t>> firstSync;  // core -> (local us, timer us)
+
+    for (auto& entry : byCore) {
+        int64_t cycles = 0;
+        uint32_t prev = dump.events[entry.second.front()].ccount;
+        for (size_t idx : entry.second) {
+            const RawEvent& ev = dump.events[idx];
+            cycles += (int32_t)(ev.ccount - prev);
+            prev = ev.ccount;
+            local[idx] = cycles / dump.cpuMhz;
+            if (ev.id == kSyncEventId && firstSync.count(ev.core) == 0) {
+                firstSync[ev.core] = std::make_pair(local[idx], ev.arg);
+            }
+        }
+    }
+
+    // Reference: the first core that has a sync event
+    bool haveRef = !firstSync.empty();
+    uint32_t refTimer = haveRef ? firstSync.begin()->second.second : 0;
+
+    std::map<int, double> offset;
+    for (auto& entry : byCore) {
+        int core = entry.first;
+        auto sync = firstSync.find(core);
+        if (sync != firstSync.end()) {
+            int32_t timerDelta = (int32_t)(sync->second.second - refTimer);
+            offset[core] = timerDelta - sync->second.first;
+        } else {
+            std::fprintf(stderr, "warning: core %d has no sync event, aligned at 0\n", core);
+            offset[core] = 0.0;
+        }
+    }
+
+    std::vector<TimedEvent> timeline;
+    timeline.reserve(dump.events.size());
+    for (size_t i = 0; i < dump.events.size(); i++) {
+        const RawEvent& ev = dump.events[i];
+        TimedEvent t;
+        t.ts = local[i] + offset[ev.core];
+        t.core = ev.core;
+        t.id = ev.id;
+        t.arg = ev.arg;
+        t.order = i;
+        timeline.push_back(t);
+    }
+
+    std::stable_sort(timeline.begin(), timeline.end(),
+                     [](const TimedEvent& a, const TimedEvent& b) {
+                         if (a.ts != b.ts) return a.ts < b.ts;
+                         return a.order < b.order;
+                     });
+
+    // Start the trace at zero
+    if (!timeline.empty()) {
+        double start = timeline.front().ts;
+        for (TimedEvent& t : timeline) t.ts -= start;
+    }
+    return timeline;
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+static void writeEvent(std::ostream& out, bool* first, const std::string& name, char phase,
+                       double ts, int core, const std::string& args) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", ts);
+    out << (*first ? "\n  " : ",\n  ");
+    *first = false;
+    out << "{\"name\":\"" << jsonEscape(name) << "\",\"ph\":\"" << phase
+        << "\",\"ts\":" << buffer << ",\"pid\":0,\"tid\":" << core;
+    if (phase == 'i') out << ",\"s\":\"t\"";
+    if (!args.empty()) out << ",\"args\":{" << args << "}";
+    out << "}";
+}
+
+static void writeChromeJson(const Dump& dump, const std::vector<TimedEvent>& timeline,
+                            std::ostream& out) {
+    bool first = true;
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    // Track names
+    writeEvent(out, &first, "process_name", 'M', 0, 0, "\"name\":\"ESP32-S3 receiver\"");
+    std::map<int, bool> cores;
+    for (const TimedEvent& t : timeline) cores[t.core] = true;
+    for (auto& core : cores) {
+        writeEvent(out, &first, "thread_name", 'M', 0, core.first,
+                   "\"name\":\"Core " + std::to_string(core.first) + "\"");
+    }
+
+    // Begin/end pairs must nest per track; drop unmatched ends
+    // (their begin was overwritten in the ring) and close leftovers.
+    std::map<int, std::vector<std::string>> open;
+    double lastTs = 0;
+
+    for (const TimedEvent& t : timeline) {
+        lastTs = t.ts;
+        if (t.id == kSyncEventId) continue;
+
+        auto it = dump.names.find(t.id);
+        EventName info = (it != dump.names.end()) ? it->second
+                                                  : EventName{"event_" + std::to_string(t.id), 'i'};
+        std::vector<std::string>& stack = open[t.core];
+
+        switch (info.phase) {
+            case 'B':
+                stack.push_back(info.name);
+                writeEvent(out, &first, info.name, 'B', t.ts, t.core,
+                           "\"arg\":" + std::to_string(t.arg));
+                break;
+            case 'E': {
+                auto match = std::find(stack.rbegin(), stack.rend(), info.name);
+                if (match == stack.rend()) break;
+                // Close anything opened inside the matching span
+                while (stack.back() != info.name) {
+                    writeEvent(out, &first, stack.back(), 'E', t.ts, t.core, "");
+                    stack.pop_back();
+                }
+                stack.pop_back();
+                writeEvent(out, &first, info.name, 'E', t.ts, t.core, "");
+                break;
+            }
+            case 'C':
+                writeEvent(out, &first, info.name, 'C', t.ts, t.core,
+                           "\"core" + std::to_string(t.core) + "\":" + std::to_string(t.arg));
+                break;
+            default:
+                writeEvent(out, &first, info.name, 'i', t.ts, t.core,
+                           "\"arg\":" + std::to_string(t.arg));
+                break;
+        }
+    }
+
+    for (auto& entry : open) {
+        while (!entry.second.empty()) {
+            writeEvent(out, &first, entry.second.back(), 'E', lastTs, entry.first, "");
+            entry.second.pop_back();
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 || (argc == 2 && std::strcmp(argv[1], "-h") == 0)) {
+        std::fprintf(stderr, "usage: %s [log.txt] > trace.json\n", argv[0]);
+        return 2;
+    }
+
+    Dump dump;
+    bool ok;
+    if (argc == 2) {
+        std::ifstream file(argv[1]);
+        if (!file) {
+            std::fprintf(stderr, "error: cannot open %s\n", argv[1]);
+            return 1;
+        }
+        ok = parseLog(file, &dump);
+    } else {
+        ok = parseLog(std::cin, &dump);
+    }
+
+    if (!ok) {
+        std::fprintf(stderr, "error: no complete [TRACE] BEGIN ... END dump found\n");
+        return 1;
+    }
+
+    std::vector<TimedEvent> timeline = buildTimeline(dump);
+    writeChromeJson(dump, timeline, std::cout);
+    std::fprintf(stderr, "%zu events converted (cpu %.0f MHz)\n", timeline.size(), dump.cpuMhz);
+    return 0;
+}